@@ -0,0 +1,209 @@
+/**
+    Launch geometry auto-tuner. See 1-openClAutoTuner.h for the description of each function.
+
+    The tuning file has one configuration per line:
+        <device name>|<driver version>|<kernel name>|<size bucket>|<local size>|<global size>|<nanoseconds>
+    Updating a key rewrites the whole file (through a temporary file and a rename), keeping the other lines.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "1-openClAutoTuner.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+#define TUNING_REPETITIONS  3           // timed runs per candidate (the fastest one counts), after one warm-up run
+
+/**
+    Device and kernel limits used to build the candidates.
+*/
+struct TuningLimits
+{
+    cl_uint     computeUnits;
+    size_t      maxLocalSize;           // min(CL_DEVICE_MAX_WORK_GROUP_SIZE, CL_KERNEL_WORK_GROUP_SIZE)
+    size_t      preferredMultiple;
+};
+
+static TuningLimits queryLimits(cl_device_id device, cl_kernel kernel)
+{
+    TuningLimits limits = {1, 1, 1};
+    size_t kernelMax = 1;
+    cl_int clErr;
+
+    const DeviceCapabilities &caps = deviceCapabilities(device);
+    limits.computeUnits = caps.computeUnits;
+    size_t deviceMax = caps.maxWorkGroupSize;
+    clErr = clGetKernelWorkGroupInfo(kernel,device,CL_KERNEL_WORK_GROUP_SIZE,sizeof(size_t),&kernelMax,NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    clErr = clGetKernelWorkGroupInfo(kernel,device,CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,sizeof(size_t),
+                                     &limits.preferredMultiple,NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    if (limits.computeUnits == 0) limits.computeUnits = 1;
+    if (limits.preferredMultiple == 0) limits.preferredMultiple = 1;
+    limits.maxLocalSize = deviceMax < kernelMax ? deviceMax : kernelMax;
+    if (limits.maxLocalSize == 0) limits.maxLocalSize = 1;
+    return limits;
+}
+
+/**
+    Builds a geometry with groupsPerUnit work-groups per compute unit, never launching more work-items than there are
+    elements (rounded up to the work-group size).
+*/
+static LaunchGeometry makeGeometry(const TuningLimits &limits, size_t localSize, size_t groupsPerUnit,
+                                   size_t numberOfElements)
+{
+    LaunchGeometry geometry;
+    size_t neededGroups = (numberOfElements + localSize - 1) / localSize;
+    size_t groups = limits.computeUnits * groupsPerUnit;
+    if (groups > neededGroups) groups = neededGroups;
+    if (groups == 0) groups = 1;
+    geometry.localSize = localSize;
+    geometry.globalSize = groups * localSize;
+    return geometry;
+}
+
+LaunchGeometry defaultGeometry(cl_device_id device, cl_kernel kernel, size_t numberOfElements)
+{
+    TuningLimits limits = queryLimits(device, kernel);
+    size_t localSize = limits.preferredMultiple;
+    while (localSize * 2 <= limits.maxLocalSize && localSize * 2 <= 256) localSize *= 2;
+    if (localSize > limits.maxLocalSize) localSize = limits.maxLocalSize;
+    return makeGeometry(limits, localSize, 4, numberOfElements);
+}
+
+/**
+    Key of one configuration in the tuning file (everything before the local size).
+*/
+static string tuningKey(cl_device_id device, const char *kernelName, size_t numberOfElements)
+{
+    int bucket = 0;
+    while (bucket < 63 && ((size_t) 1 << (bucket + 1)) <= numberOfElements) bucket++;
+    char bucketText[16];
+    snprintf(bucketText, sizeof bucketText, "%d", bucket);
+    return deviceInfoString(device, CL_DEVICE_NAME) + "|" + deviceInfoString(device, CL_DRIVER_VERSION) + "|" +
+           kernelName + "|" + bucketText + "|";
+}
+
+static bool loadTuning(const char *tuningFile, const string &key, LaunchGeometry *geometry)
+{
+    FILE *file = fopen(tuningFile, "r");
+    if (file == NULL) return false;
+    char line[1024];
+    bool found = false;
+    while (!found && fgets(line, sizeof line, file) != NULL)
+    {
+        unsigned long long localSize, globalSize;
+        if (string(line).compare(0, key.size(), key) == 0 &&
+            sscanf(line + key.size(), "%llu|%llu", &localSize, &globalSize) == 2 &&
+            localSize > 0 && globalSize >= localSize && globalSize % localSize == 0)
+        {
+            geometry->localSize = localSize;
+            geometry->globalSize = globalSize;
+            found = true;
+        }
+    }
+    fclose(file);
+    return found;
+}
+
+static void storeTuning(const char *tuningFile, const string &key, LaunchGeometry geometry, double nanoseconds)
+{
+    vector<string> lines;
+    char line[1024];
+    FILE *file = fopen(tuningFile, "r");
+    if (file != NULL)
+    {
+        while (fgets(line, sizeof line, file) != NULL)
+            if (string(line).compare(0, key.size(), key) != 0) lines.push_back(line);
+        fclose(file);
+    }
+    snprintf(line, sizeof line, "%s%llu|%llu|%.0f\n", key.c_str(), (unsigned long long) geometry.localSize,
+             (unsigned long long) geometry.globalSize, nanoseconds);
+    lines.push_back(line);
+
+    string tmpName = temporaryFileName(tuningFile);
+    if ((file = fopen(tmpName.c_str(), "w")) == NULL) { cout << "Auto-tuner: couldn't write " << tmpName << endl; return;}
+    for (size_t i = 0; i < lines.size(); i++) fputs(lines[i].c_str(), file);
+    if (fclose(file) != 0 || rename(tmpName.c_str(), tuningFile) != 0)
+    {
+        cout << "Auto-tuner: couldn't write " << tuningFile << endl;
+        remove(tmpName.c_str());
+    }
+}
+
+/**
+    Runs one candidate (one warm-up and TUNING_REPETITIONS timed runs), returning its fastest kernel time in
+    nanoseconds, or a negative value if the runtime refuses the geometry.
+*/
+static double timeCandidate(cl_command_queue queue, cl_kernel kernel, LaunchGeometry geometry)
+{
+    double best = -1;
+    for (int rep = 0; rep <= TUNING_REPETITIONS; rep++)
+    {
+        cl_event event;
+        cl_ulong start, end;
+        cl_int clErr = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &geometry.globalSize, &geometry.localSize,
+                                              0, NULL, &event);
+        if (clErr != CL_SUCCESS) return -1;
+        clErr = clWaitForEvents(1, &event);
+        clErr |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL);
+        clErr |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL);
+        clReleaseEvent(event);
+        if (clErr != CL_SUCCESS) return -1;
+        if (rep > 0 && (best < 0 || end - start < best)) best = (double) (end - start);
+    }
+    return best;
+}
+
+LaunchGeometry autoTuneGeometry(cl_command_queue queue, cl_device_id device, cl_kernel kernel, const char *kernelName,
+                                size_t numberOfElements, const char *tuningFile, bool forceTune)
+{
+    LaunchGeometry best = defaultGeometry(device, kernel, numberOfElements);
+    string key = tuningKey(device, kernelName, numberOfElements);
+
+    if (!forceTune && tuningFile != NULL && loadTuning(tuningFile, key, &best))
+    {
+        cout << "Auto-tuner: stored geometry for " << kernelName << " (local " << best.localSize << ", global "
+             << best.globalSize << ")" << endl;
+        return best;
+    }
+
+    // local sizes: powers of two times the preferred multiple; global sizes: 1 to 64 work-groups per compute unit
+    TuningLimits limits = queryLimits(device, kernel);
+    double bestTime = -1;
+    int candidates = 0;
+    for (size_t localSize = limits.preferredMultiple; localSize <= limits.maxLocalSize; localSize *= 2)
+    {
+        size_t lastGlobal = 0;
+        for (size_t groupsPerUnit = 1; groupsPerUnit <= 64; groupsPerUnit *= 2)
+        {
+            LaunchGeometry candidate = makeGeometry(limits, localSize, groupsPerUnit, numberOfElements);
+            if (candidate.globalSize == lastGlobal) break;     // already covers every element
+            lastGlobal = candidate.globalSize;
+
+            double time = timeCandidate(queue, kernel, candidate);
+            candidates++;
+            if (time >= 0 && (bestTime < 0 || time < bestTime)) { bestTime = time; best = candidate;}
+        }
+    }
+
+    if (bestTime < 0)
+    {
+        cout << "Auto-tuner: no candidate could be timed, using the default geometry" << endl;
+        return best;
+    }
+    cout << "Auto-tuner: " << candidates << " candidates for " << kernelName << ", best local " << best.localSize
+         << ", global " << best.globalSize << " (" << bestTime * 1e-6 << " ms)" << endl;
+    if (tuningFile != NULL) storeTuning(tuningFile, key, best, bestTime);
+    return best;
+}
@@ -0,0 +1,59 @@
+/**
+    Launch geometry auto-tuner for 1D grid-stride kernels (like zeroValues). The candidates are built from the device
+    and kernel limits (CL_DEVICE_MAX_COMPUTE_UNITS, CL_DEVICE_MAX_WORK_GROUP_SIZE, CL_KERNEL_WORK_GROUP_SIZE and
+    CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE), timed with profiling events, and the fastest one is stored in a
+    tuning file, keyed by (device, driver version, kernel, problem size bucket). The bucket is log2 of the number of
+    elements, so close problem sizes share the same configuration.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLAUTOTUNER_H
+#define OPENCLAUTOTUNER_H
+
+#include <cstddef>
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+/**
+    Local and global size of a 1D NDRange. globalSize is always a multiple of localSize.
+*/
+struct LaunchGeometry
+{
+    size_t      localSize;
+    size_t      globalSize;
+};
+
+/**
+    defaultGeometry picks a launch geometry from the device limits only, without running anything: a work-group size
+    that is a multiple of the preferred multiple (close to 256), and a few work-groups per compute unit.
+    @param      device          device running the kernel
+    @param      kernel          kernel to launch
+    @param      numberOfElements    elements processed by the grid-stride loop
+    @return     geometry        local and global size
+*/
+LaunchGeometry defaultGeometry(cl_device_id device, cl_kernel kernel, size_t numberOfElements);
+
+/**
+    autoTuneGeometry returns the launch geometry of a kernel for one problem size. A configuration previously stored in
+    the tuning file is reused; otherwise every candidate is timed on the queue (the kernel arguments must already be
+    set, and the kernel must be safe to run several times) and the fastest one is stored.
+    @param      queue           command queue of the device, created with CL_QUEUE_PROFILING_ENABLE
+    @param      device          device running the kernel
+    @param      kernel          kernel to tune, with all arguments set
+    @param      kernelName      name of the kernel, part of the tuning key
+    @param      numberOfElements    elements processed by the grid-stride loop
+    @param      tuningFile      file with the stored configurations, or NULL to tune without persisting
+    @param      forceTune       true to ignore the stored configuration, and tune again
+    @return     geometry        fastest local and global size
+*/
+LaunchGeometry autoTuneGeometry(cl_command_queue queue, cl_device_id device, cl_kernel kernel, const char *kernelName,
+                                size_t numberOfElements, const char *tuningFile, bool forceTune);
+
+#endif
@@ -0,0 +1,579 @@
+/**
+    Benchmark suite of the zeroValues job, to track the performance of a device and driver between deployments.
+
+    The job is swept over problem sizes (from a few KB to beyond the memory of the device, x4 per step), element types
+    (int, float, double) and memory modes (copy, zero-copy, and the streaming pipeline, the only mode that runs beyond
+    the device memory). Each configuration runs a few warm-up times, then a number of measured repetitions. Every stage
+    (write, kernel, read) is timed with the profiling events of its command, the whole run with the wall clock, and
+    the repetitions are summarized as median, p90, p99 and standard deviation.
+
+    The medians can be stored as a baseline file, and later runs compared against it: a stage whose median is slower
+    than the baseline by more than the threshold is a regression, and the benchmark then exits with 1 (so it can gate
+    a deployment). Stages faster than BENCH_NOISE_MS are reported, but never gated, as their times are mostly noise.
+
+    Usage: 1-openClBenchmark [options]
+        --min-size <bytes>                  smallest problem size (4 KB by default)
+        --max-size <bytes>                  biggest problem size (twice the device memory by default, bounded by a
+                                            quarter of the RAM, as the host holds the input and the output)
+        --types int,float,double            element types to run (all of them by default, double needs cl_khr_fp64)
+        --modes copy,zerocopy,stream        memory modes to run (all of them by default)
+        --warmup <n>                        warm-up runs of each configuration (2 by default)
+        --reps <n>                          measured runs of each configuration (10 by default)
+        --baseline <file>                   compare the medians with a stored baseline
+        --save-baseline <file>              store the medians of this run as a baseline
+        --threshold <percent>               slowdown over the baseline taken as a regression (10 by default)
+        --cache-dir <dir>                   directory of the program cache (.clcache by default)
+        --no-cache                          always build the programs from source
+
+    Baseline files have one line per stage: device|driver|type|mode|bytes|stage|median ms. Lines of other devices or
+    driver versions are kept by --save-baseline, and ignored by the comparison.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <getopt.h>
+#include "1-openClUtilities.h"
+#include "1-openClProfiler.h"
+#include "1-openClAutoTuner.h"
+#include "1-openClStreaming.h"
+#include "1-openClHostMemory.h"
+#include "1-openClSpecialization.h"
+#include "1-openClMappedFile.h"
+#include "1-openClKernelLibrary.h"
+#include "1-openClCapabilities.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+using namespace std;
+
+#define BENCH_MIN_BYTES     (4 << 10)       // smallest problem size by default
+#define BENCH_STEP          4               // ratio between two sizes of the sweep
+#define BENCH_WARMUP        2               // warm-up runs by default
+#define BENCH_REPS          10              // measured runs by default
+#define BENCH_THRESHOLD     10.0            // slowdown (percent) taken as a regression by default
+#define BENCH_NOISE_MS      0.05            // stages faster than that are not gated
+#define BENCH_OPERAND       10              // value added by the kernels (ZV_OPERAND in zeroValuesKernel.cl)
+#define BENCH_STREAM_SETS   3               // buffer sets of the streaming pipeline
+
+struct BenchOptions
+{
+    size_t              minBytes;
+    size_t              maxBytes;               // 0 to derive it from the device and the host memory
+    vector<string>      types;
+    vector<string>      modes;
+    int                 warmup;
+    int                 reps;
+    const char          *baseline;
+    const char          *saveBaseline;
+    double              threshold;
+    const char          *cacheDir;
+};
+
+/**
+    Device under test, and the programs built for it.
+*/
+struct BenchDevice
+{
+    cl_device_id        device;
+    cl_context          context;
+    cl_command_queue    queue;
+    KernelLibrary       library;
+    SpecializationCache specializations;
+    string              name;
+    string              driverVersion;
+    bool                fp64;
+};
+
+/**
+    Times of one run, in milliseconds (-1 for a stage the memory mode doesn't have).
+*/
+struct RunTimes
+{
+    double      writeMs;
+    double      kernelMs;
+    double      readMs;
+    double      wallMs;
+};
+
+/**
+    Statistics of one stage of one configuration.
+*/
+struct BenchResult
+{
+    string              key;                    // type|mode|bytes|stage
+    string              stage;
+    size_t              bytes;                  // bytes moved by the stage (for GB/s)
+    SampleStatistics    stats;
+};
+
+// splits "a,b,c" in its items
+static vector<string> splitList(const char *list)
+{
+    vector<string> items;
+    stringstream in(list);
+    string item;
+    while (getline(in, item, ',')) if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+static size_t elementSize(const string &type)
+{
+    return type == "double" ? sizeof(double) : type == "float" ? sizeof(float) : sizeof(int);
+}
+
+template <typename T>
+static void fillTyped(void *input, size_t numberOfElements)
+{
+    T *a = (T*) input;
+    for (size_t i = 0; i < numberOfElements; i++) a[i] = (T) (i % 1000);
+}
+
+template <typename T>
+static size_t mismatchesTyped(const void *input, const void *output, size_t numberOfElements)
+{
+    const T *a = (const T*) input;
+    const T *b = (const T*) output;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < numberOfElements; i++) if (b[i] != a[i] + (T) BENCH_OPERAND) mismatches++;
+    return mismatches;
+}
+
+static void fillInput(const string &type, void *input, size_t numberOfElements)
+{
+    if (type == "double") fillTyped<double>(input, numberOfElements);
+    else if (type == "float") fillTyped<float>(input, numberOfElements);
+    else fillTyped<int>(input, numberOfElements);
+}
+
+static size_t countMismatches(const string &type, const void *input, const void *output, size_t numberOfElements)
+{
+    if (type == "double") return mismatchesTyped<double>(input, output, numberOfElements);
+    if (type == "float") return mismatchesTyped<float>(input, output, numberOfElements);
+    return mismatchesTyped<int>(input, output, numberOfElements);
+}
+
+// device time of an event, which is then released
+static double takeEventMs(cl_event event)
+{
+    double ms = eventMilliseconds(event);
+    clReleaseEvent(event);
+    return ms;
+}
+
+/**
+    Opens the first GPU (or the first device, without a GPU), with a profiling queue and the kernel library.
+
+    @return     found           false if no platform has a device
+*/
+static bool openBenchDevice(const BenchOptions &options, BenchDevice *bench)
+{
+    cl_int clErr;
+    cl_uint numPlatforms = 0, numDevices;
+    clErr = clGetPlatformIDs(0, NULL, &numPlatforms);
+    if (clErr != CL_SUCCESS || numPlatforms == 0) return false;
+    vector<cl_platform_id> platforms(numPlatforms);
+    clErr = clGetPlatformIDs(numPlatforms, &platforms[0], NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetPlatformIDs Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    string snapshotPath = options.cacheDir != NULL ? string(options.cacheDir) + "/" + CAPABILITY_SNAPSHOT : "";
+    capabilitiesOpen(options.cacheDir != NULL ? snapshotPath.c_str() : NULL);
+
+    cl_platform_id platform = NULL;
+    cl_device_id device = NULL;
+    cl_device_type wanted[] = {CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_ALL};
+    for (int t = 0; t < 2 && device == NULL; t++)
+        for (cl_uint p = 0; p < numPlatforms && device == NULL; p++)
+            if (clGetDeviceIDs(platforms[p], wanted[t], 1, &device, &numDevices) == CL_SUCCESS && numDevices > 0)
+                platform = platforms[p];
+            else device = NULL;
+    if (device == NULL) return false;
+    bench->device = device;
+
+    cl_context_properties properties[] = {CL_CONTEXT_PLATFORM, (cl_context_properties) platform, 0};
+    bench->context = clCreateContext(properties, 1, &device, NULL, NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateContext Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    bench->queue = clCreateCommandQueue(bench->context, device, CL_QUEUE_PROFILING_ENABLE, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateCommandQueue Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    const string &source = kernelLibrarySource();
+    kernelLibraryCreate(&bench->library, bench->context, device, source.c_str(), source.size(), "", options.cacheDir, NULL);
+    specializationCacheInit(&bench->specializations);
+
+    const DeviceCapabilities &caps = deviceCapabilities(device);
+    bench->name = caps.name;
+    bench->driverVersion = caps.driverVersion;
+    bench->fp64 = hasExtension(caps, "cl_khr_fp64");
+    return true;
+}
+
+static void closeBenchDevice(BenchDevice *bench)
+{
+    specializationCacheRelease(&bench->specializations);
+    kernelLibraryRelease(&bench->library);
+    clReleaseCommandQueue(bench->queue);
+    clReleaseContext(bench->context);
+}
+
+/**
+    Gives the zeroValuesSpecialized kernel of one type and size. The geometry is the default one of the generic kernel
+    (derived from the device limits, so every run of a configuration launches the same NDRange).
+
+    @return     kernel          kernel to be released by the caller
+*/
+static cl_kernel typedKernel(const BenchOptions &options, BenchDevice *bench, const string &type,
+                             size_t numberOfElements, LaunchGeometry *geometry)
+{
+    cl_int clErr;
+    *geometry = defaultGeometry(bench->device, kernelLibraryGet(&bench->library, "zeroValues"), numberOfElements);
+    KernelSpecialization spec;
+    spec.numberOfElements = numberOfElements;
+    spec.localSize = geometry->localSize;
+    spec.globalSize = geometry->globalSize;
+    spec.operand = BENCH_OPERAND;
+    spec.elementType = type.c_str();
+    const string &source = kernelLibrarySource();
+    cl_program program = specializedProgram(&bench->specializations, bench->context, bench->device, source.c_str(),
+                                            source.size(), spec, options.cacheDir, NULL);
+    cl_kernel kernel = clCreateKernel(program, "zeroValuesSpecialized", &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    return kernel;
+}
+
+/**
+    One run with whole buffers: copied with write/read, or zero-copy buffers over the host arrays, synchronized
+    with a map of the output. The wall time covers the buffer creation as well.
+*/
+static RunTimes runWhole(BenchDevice *bench, bool zeroCopy, cl_kernel kernel, LaunchGeometry geometry, void *input,
+                         void *output, size_t bytes)
+{
+    cl_int clErr;
+    cl_event writeEvent = NULL, kernelEvent, readEvent;
+    RunTimes times = {-1, -1, -1, -1};
+    double start = wallClockMs();
+
+    cl_mem_flags hostFlag = zeroCopy ? CL_MEM_USE_HOST_PTR : 0;
+    cl_mem inputBuffer = clCreateBuffer(bench->context, CL_MEM_READ_ONLY | hostFlag, bytes, zeroCopy ? input : NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    cl_mem outputBuffer = clCreateBuffer(bench->context, CL_MEM_WRITE_ONLY | hostFlag, bytes, zeroCopy ? output : NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    clErr  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &inputBuffer);
+    clErr |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &outputBuffer);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    if (!zeroCopy)
+    {
+        clErr = clEnqueueWriteBuffer(bench->queue, inputBuffer, CL_FALSE, 0, bytes, input, 0, NULL, &writeEvent);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    }
+    clErr = clEnqueueNDRangeKernel(bench->queue, kernel, 1, NULL, &geometry.globalSize, &geometry.localSize, 0, NULL,
+                                   &kernelEvent);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    if (!zeroCopy)
+    {
+        clErr = clEnqueueReadBuffer(bench->queue, outputBuffer, CL_TRUE, 0, bytes, output, 0, NULL, &readEvent);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueReadBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    }
+    else
+    {
+        void *mapped = clEnqueueMapBuffer(bench->queue, outputBuffer, CL_TRUE, CL_MAP_READ, 0, bytes, 0, NULL, &readEvent,
+                                          &clErr);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueMapBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        if (mapped != output) memcpy(output, mapped, bytes);        // runtimes are allowed to map a copy
+        clErr = clEnqueueUnmapMemObject(bench->queue, outputBuffer, mapped, 0, NULL, NULL);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueUnmapMemObject Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        clFinish(bench->queue);
+    }
+    times.wallMs = wallClockMs() - start;
+
+    if (writeEvent != NULL) times.writeMs = takeEventMs(writeEvent);
+    times.kernelMs = takeEventMs(kernelEvent);
+    times.readMs = takeEventMs(readEvent);
+    clReleaseMemObject(inputBuffer);
+    clReleaseMemObject(outputBuffer);
+    return times;
+}
+
+/**
+    One run through the streaming pipeline (int only, the pipeline is created once per size). The stage times are the
+    sums over every chunk, so they overlap, and add up to more than the wall time.
+*/
+static RunTimes runStream(StreamPipeline *pipeline, cl_kernel kernel, LaunchGeometry geometry, void *input, void *output,
+                          size_t numberOfElements)
+{
+    StreamReport report = streamPipelineRun(pipeline, kernel, (const int*) input, (int*) output, numberOfElements, geometry, NULL);
+    RunTimes times = {report.writeMs, report.kernelMs, report.readMs, report.wallMs};
+    return times;
+}
+
+/**
+    Adds the statistics of every stage of one configuration to the results, and prints them.
+*/
+static void reportConfiguration(const string &type, const string &mode, size_t bytes, const vector<RunTimes> &runs,
+                                vector<BenchResult> *results)
+{
+    const char *stages[] = {"write", "kernel", "read", "wall"};
+    for (int s = 0; s < 4; s++)
+    {
+        vector<double> samples;
+        for (size_t r = 0; r < runs.size(); r++)
+        {
+            double ms = s == 0 ? runs[r].writeMs : s == 1 ? runs[r].kernelMs : s == 2 ? runs[r].readMs : runs[r].wallMs;
+            if (ms >= 0) samples.push_back(ms);
+        }
+        if (samples.empty()) continue;
+
+        BenchResult result;
+        stringstream key;
+        key << type << "|" << mode << "|" << bytes << "|" << stages[s];
+        result.key = key.str();
+        result.stage = stages[s];
+        result.bytes = s == 1 || s == 3 ? 2 * bytes : bytes;       // the kernel (and the whole run) reads and writes
+        result.stats = sampleStatistics(samples);
+        results->push_back(result);
+        printf("    %-7s median %10.4f ms  p90 %10.4f  p99 %10.4f  stddev %9.4f  %8.2f GB/s\n", stages[s],
+               result.stats.median, result.stats.p90, result.stats.p99, result.stats.stddev,
+               result.stats.median > 0 ? result.bytes / (result.stats.median * 1e6) : 0);
+    }
+}
+
+/**
+    Runs every repetition of one configuration, after the warm-up runs, and checks the output of the last one.
+
+    @return     passed          false if the output is wrong
+*/
+static bool runConfiguration(const BenchOptions &options, BenchDevice *bench, const string &type, const string &mode,
+                             size_t bytes, void *input, void *output, vector<BenchResult> *results)
+{
+    size_t numberOfElements = bytes / elementSize(type);
+    printf("\n%s / %s / %zu bytes (%zu elements)\n", type.c_str(), mode.c_str(), bytes, numberOfElements);
+    fillInput(type, input, numberOfElements);
+    memset(output, 0, bytes);
+
+    vector<RunTimes> runs;
+    if (mode == "stream")
+    {
+        StreamPipeline pipeline;
+        size_t chunkElements = streamChunkElements(bench->device, numberOfElements, BENCH_STREAM_SETS, 0);
+        streamPipelineCreate(&pipeline, bench->context, bench->device, chunkElements, BENCH_STREAM_SETS);
+        cl_kernel kernel = kernelLibraryGet(&bench->library, "zeroValues");
+        LaunchGeometry geometry = defaultGeometry(bench->device, kernel, chunkElements);
+        for (int r = 0; r < options.warmup + options.reps; r++)
+        {
+            RunTimes times = runStream(&pipeline, kernel, geometry, input, output, numberOfElements);
+            if (r >= options.warmup) runs.push_back(times);
+        }
+        streamPipelineRelease(&pipeline);
+    }
+    else
+    {
+        LaunchGeometry geometry;
+        cl_kernel kernel = typedKernel(options, bench, type, numberOfElements, &geometry);
+        for (int r = 0; r < options.warmup + options.reps; r++)
+        {
+            RunTimes times = runWhole(bench, mode == "zerocopy", kernel, geometry, input, output, bytes);
+            if (r >= options.warmup) runs.push_back(times);
+        }
+        clReleaseKernel(kernel);
+    }
+
+    size_t mismatches = countMismatches(type, input, output, numberOfElements);
+    if (mismatches > 0) printf("    %zu mismatching elements\n", mismatches);
+    reportConfiguration(type, mode, bytes, runs, results);
+    return mismatches == 0;
+}
+
+/**
+    Reads the medians of one device and driver from a baseline file.
+
+    @param      others          filled with the lines of other devices and drivers (may be NULL)
+    @return     medians         median of each type|mode|bytes|stage key
+*/
+static map<string, double> loadBaseline(const char *path, const BenchDevice &bench, vector<string> *others)
+{
+    map<string, double> medians;
+    ifstream in(path);
+    string line;
+    string prefix = bench.name + "|" + bench.driverVersion + "|";
+    while (getline(in, line))
+    {
+        size_t last = line.rfind('|');
+        if (line.empty() || line[0] == '#' || last == string::npos) continue;
+        if (line.compare(0, prefix.size(), prefix) != 0)
+        {
+            if (others != NULL) others->push_back(line);
+            continue;
+        }
+        medians[line.substr(prefix.size(), last - prefix.size())] = atof(line.c_str() + last + 1);
+    }
+    return medians;
+}
+
+/**
+    Stores the medians of this run, keeping the lines of other devices and drivers already in the file.
+*/
+static void saveBaseline(const char *path, const BenchDevice &bench, const vector<BenchResult> &results)
+{
+    vector<string> others;
+    loadBaseline(path, bench, &others);
+    string temporary = string(path) + ".tmp";
+    FILE *out = fopen(temporary.c_str(), "w");
+    if (out == NULL) { cout << "Couldn't write the baseline " << temporary << endl; exit(EXIT_FAILURE);}
+    fprintf(out, "# device|driver|type|mode|bytes|stage|median ms\n");
+    for (size_t i = 0; i < others.size(); i++) fprintf(out, "%s\n", others[i].c_str());
+    for (size_t i = 0; i < results.size(); i++)
+        fprintf(out, "%s|%s|%s|%.6f\n", bench.name.c_str(), bench.driverVersion.c_str(), results[i].key.c_str(),
+                results[i].stats.median);
+    if (fclose(out) != 0 || rename(temporary.c_str(), path) != 0)
+    {
+        cout << "Couldn't write the baseline " << path << endl;
+        exit(EXIT_FAILURE);
+    }
+    printf("\nBaseline of %zu stages stored in %s\n", results.size(), path);
+}
+
+/**
+    Compares the medians of this run with the baseline.
+
+    @return     regressions     number of stages slower than the baseline by more than the threshold
+*/
+static size_t compareBaseline(const BenchOptions &options, const BenchDevice &bench, const vector<BenchResult> &results)
+{
+    map<string, double> medians = loadBaseline(options.baseline, bench, NULL);
+    size_t regressions = 0, compared = 0;
+    printf("\nBaseline %s (regression above +%.1f%%):\n", options.baseline, options.threshold);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        map<string, double>::iterator found = medians.find(results[i].key);
+        if (found == medians.end()) continue;
+        compared++;
+        double change = found->second > 0 ? 100.0 * (results[i].stats.median - found->second) / found->second : 0;
+        bool gated = found->second >= BENCH_NOISE_MS;
+        bool regressed = gated && change > options.threshold;
+        if (regressed) regressions++;
+        if (regressed || change < -options.threshold)
+            printf("    %-40s %10.4f ms -> %10.4f ms  %+7.1f%%%s\n", results[i].key.c_str(), found->second,
+                   results[i].stats.median, change, regressed ? "  REGRESSION" : "");
+    }
+    if (compared == 0) printf("    no stage of this device and driver in the baseline\n");
+    else printf("    %zu stages compared, %zu regression(s)\n", compared, regressions);
+    return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    options.minBytes = BENCH_MIN_BYTES;
+    options.maxBytes = 0;
+    options.types = splitList("int,float,double");
+    options.modes = splitList("copy,zerocopy,stream");
+    options.warmup = BENCH_WARMUP;
+    options.reps = BENCH_REPS;
+    options.baseline = NULL;
+    options.saveBaseline = NULL;
+    options.threshold = BENCH_THRESHOLD;
+    options.cacheDir = ".clcache";
+
+    static struct option longOptions[] = {
+        {"min-size",        required_argument,  NULL,   'a'},
+        {"max-size",        required_argument,  NULL,   'z'},
+        {"types",           required_argument,  NULL,   'y'},
+        {"modes",           required_argument,  NULL,   'm'},
+        {"warmup",          required_argument,  NULL,   'w'},
+        {"reps",            required_argument,  NULL,   'r'},
+        {"baseline",        required_argument,  NULL,   'b'},
+        {"save-baseline",   required_argument,  NULL,   's'},
+        {"threshold",       required_argument,  NULL,   't'},
+        {"cache-dir",       required_argument,  NULL,   'c'},
+        {"no-cache",        no_argument,        NULL,   'n'},
+        {"help",            no_argument,        NULL,   'h'},
+        {NULL,              0,                  NULL,   0}
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "a:z:y:m:w:r:b:s:t:c:nh", longOptions, NULL)) != EOF)
+    {
+        switch (opt)
+        {
+        case 'a': options.minBytes = strtoull(optarg, NULL, 10); break;
+        case 'z': options.maxBytes = strtoull(optarg, NULL, 10); break;
+        case 'y': options.types = splitList(optarg); break;
+        case 'm': options.modes = splitList(optarg); break;
+        case 'w': options.warmup = atoi(optarg); break;
+        case 'r': options.reps = atoi(optarg); break;
+        case 'b': options.baseline = optarg; break;
+        case 's': options.saveBaseline = optarg; break;
+        case 't': options.threshold = atof(optarg); break;
+        case 'c': options.cacheDir = optarg; break;
+        case 'n': options.cacheDir = NULL; break;
+        default:
+            printf("Usage: %s [--min-size <bytes>] [--max-size <bytes>] [--types int,float,double]\n"
+                   "       [--modes copy,zerocopy,stream] [--warmup <n>] [--reps <n>] [--baseline <file>]\n"
+                   "       [--save-baseline <file>] [--threshold <percent>] [--cache-dir <dir>] [--no-cache]\n", argv[0]);
+            return opt == 'h' ? 0 : EXIT_FAILURE;
+        }
+    }
+    if (options.reps < 1) options.reps = 1;
+    if (options.warmup < 0) options.warmup = 0;
+    if (options.minBytes < sizeof(double)) options.minBytes = sizeof(double);
+
+    BenchDevice bench;
+    if (!openBenchDevice(options, &bench)) { cout << "No OpenCL device found." << endl; return EXIT_FAILURE;}
+    const DeviceCapabilities &caps = deviceCapabilities(bench.device);
+
+    // the host holds the input and the output of the biggest size
+    size_t hostLimit = physicalMemoryBytes() / 4;
+    if (options.maxBytes == 0) options.maxBytes = 2 * caps.globalMemSize;
+    if (hostLimit > 0 && options.maxBytes > hostLimit) options.maxBytes = hostLimit;
+    printf("Device %s (driver %s), %llu MB of memory, %d warm-up run(s), %d repetition(s)\n", bench.name.c_str(),
+           bench.driverVersion.c_str(), (unsigned long long) (caps.globalMemSize >> 20), options.warmup, options.reps);
+    if (options.maxBytes <= caps.globalMemSize)
+        printf("The sweep stops at %zu bytes, within the device memory (bounded by the host memory)\n", options.maxBytes);
+
+    vector<size_t> sizes;
+    for (size_t bytes = options.minBytes; bytes <= options.maxBytes; bytes *= BENCH_STEP)
+        sizes.push_back(bytes / sizeof(double) * sizeof(double));         // a whole number of elements of every type
+    size_t largest = sizes.empty() ? 0 : sizes.back();
+    void *input = allocateHostBuffer(largest);
+    void *output = allocateHostBuffer(largest);
+
+    vector<BenchResult> results;
+    bool passed = true;
+    for (size_t s = 0; s < sizes.size(); s++)
+        for (size_t t = 0; t < options.types.size(); t++)
+            for (size_t m = 0; m < options.modes.size(); m++)
+            {
+                const string &type = options.types[t];
+                const string &mode = options.modes[m];
+                size_t numberOfElements = sizes[s] / elementSize(type);
+                if (type != "int" && type != "float" && type != "double") continue;
+                if (type == "double" && !bench.fp64) continue;
+                if (mode == "stream" && type != "int") continue;                 // the pipeline moves ints
+                if (mode != "stream" && (streamingRequired(bench.device, sizes[s]) || numberOfElements > 0x7fffffff))
+                    continue;                                                    // whole buffers don't fit the device
+                passed &= runConfiguration(options, &bench, type, mode, sizes[s], input, output, &results);
+            }
+
+    size_t regressions = 0;
+    if (options.baseline != NULL) regressions = compareBaseline(options, bench, results);
+    if (options.saveBaseline != NULL) saveBaseline(options.saveBaseline, bench, results);
+
+    freeHostBuffer(input);
+    freeHostBuffer(output);
+    closeBenchDevice(&bench);
+    if (!passed) { printf("\nWrong results, see the mismatching elements above\n"); return EXIT_FAILURE;}
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,406 @@
+/**
+    Device capability snapshot. See 1-openClCapabilities.h for the description of each function.
+
+    The snapshot is a JSON file:
+        {"devices": [{"NAME": "...", "DRIVER_VERSION": "...", "MAX_WORK_ITEM_SIZES": [...], ...}, ...]}
+    It is read with a small JSON parser (enough for the snapshot and for the output of clInfo --json).
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+/**
+    One parsed JSON value. Numbers are kept as integers (every property of the snapshot is one).
+*/
+struct JsonValue
+{
+    enum Kind {JSON_NULL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT} kind;
+    unsigned long long      number;
+    string                  text;
+    vector<JsonValue>       items;          // elements of an array, or values of an object
+    vector<string>          keys;           // keys of an object, one per item
+};
+
+/**
+    Capabilities of the run, and the snapshot they come from.
+*/
+static mutex                                    capabilitiesLock;
+static string                                   snapshotPath;       // empty: no snapshot
+static vector<DeviceCapabilities>               snapshot;
+static map<cl_device_id, DeviceCapabilities>    byDevice;
+
+static void skipSpaces(const char *&p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+}
+
+static bool parseString(const char *&p, const char *end, string *text)
+{
+    if (p >= end || *p != '"') return false;
+    for (p++; p < end && *p != '"'; p++)
+    {
+        if (*p != '\\') { *text += *p; continue;}
+        if (++p >= end) return false;
+        switch (*p)
+        {
+        case 'n': *text += '\n'; break;
+        case 't': *text += '\t'; break;
+        case 'r': *text += '\r'; break;
+        case 'b': *text += '\b'; break;
+        case 'f': *text += '\f'; break;
+        case 'u':
+            if (end - p < 5) return false;
+            {
+                unsigned code = (unsigned) strtoul(string(p + 1, 4).c_str(), NULL, 16);
+                *text += code < 0x80 ? (char) code : '?';       // device properties are ASCII
+            }
+            p += 4;
+            break;
+        default: *text += *p; break;                            // \" \\ \/
+        }
+    }
+    if (p >= end) return false;
+    p++;
+    return true;
+}
+
+static bool parseValue(const char *&p, const char *end, JsonValue *value)
+{
+    skipSpaces(p, end);
+    if (p >= end) return false;
+    value->kind = JsonValue::JSON_NULL;
+    value->number = 0;
+
+    if (*p == '{' || *p == '[')
+    {
+        bool object = *p == '{';
+        char close = object ? '}' : ']';
+        value->kind = object ? JsonValue::JSON_OBJECT : JsonValue::JSON_ARRAY;
+        p++;
+        skipSpaces(p, end);
+        if (p < end && *p == close) { p++; return true;}
+        while (true)
+        {
+            if (object)
+            {
+                string key;
+                skipSpaces(p, end);
+                if (!parseString(p, end, &key)) return false;
+                skipSpaces(p, end);
+                if (p >= end || *p != ':') return false;
+                p++;
+                value->keys.push_back(key);
+            }
+            value->items.push_back(JsonValue());
+            if (!parseValue(p, end, &value->items.back())) return false;
+            skipSpaces(p, end);
+            if (p < end && *p == ',') { p++; continue;}
+            if (p < end && *p == close) { p++; return true;}
+            return false;
+        }
+    }
+    if (*p == '"')
+    {
+        value->kind = JsonValue::JSON_STRING;
+        return parseString(p, end, &value->text);
+    }
+    if (end - p >= 4 && strncmp(p, "true", 4) == 0) { value->kind = JsonValue::JSON_NUMBER; value->number = 1; p += 4; return true;}
+    if (end - p >= 5 && strncmp(p, "false", 5) == 0) { value->kind = JsonValue::JSON_NUMBER; p += 5; return true;}
+    if (end - p >= 4 && strncmp(p, "null", 4) == 0) { p += 4; return true;}
+
+    // a number (the buffer is null terminated, so strto* can't run past it)
+    char *after;
+    value->kind = JsonValue::JSON_NUMBER;
+    value->number = *p == '-' ? (unsigned long long) strtoll(p, &after, 10) : strtoull(p, &after, 10);
+    if (after == p) return false;
+    while (after < end && (*after == '.' || *after == 'e' || *after == 'E' || *after == '+' || *after == '-' ||
+                           (*after >= '0' && *after <= '9'))) after++;
+    p = after;
+    return true;
+}
+
+static const JsonValue *member(const JsonValue &object, const char *key)
+{
+    for (size_t i = 0; i < object.keys.size(); i++)
+        if (object.keys[i] == key) return &object.items[i];
+    return NULL;
+}
+
+static unsigned long long numberOf(const JsonValue &object, const char *key)
+{
+    const JsonValue *value = member(object, key);
+    return value != NULL && value->kind == JsonValue::JSON_NUMBER ? value->number : 0;
+}
+
+static string textOf(const JsonValue &object, const char *key)
+{
+    const JsonValue *value = member(object, key);
+    return value != NULL && value->kind == JsonValue::JSON_STRING ? value->text : "";
+}
+
+/**
+    Splits a space separated list (CL_DEVICE_EXTENSIONS).
+*/
+static vector<string> splitList(const string &list)
+{
+    vector<string> words;
+    size_t start = 0;
+    while (start < list.size())
+    {
+        size_t stop = list.find(' ', start);
+        if (stop == string::npos) stop = list.size();
+        if (stop > start) words.push_back(list.substr(start, stop - start));
+        start = stop + 1;
+    }
+    return words;
+}
+
+static DeviceCapabilities capabilitiesFromJson(const JsonValue &device)
+{
+    DeviceCapabilities caps;
+    caps.name = textOf(device, "NAME");
+    caps.vendor = textOf(device, "VENDOR");
+    caps.driverVersion = textOf(device, "DRIVER_VERSION");
+    caps.version = textOf(device, "VERSION");
+    caps.profile = textOf(device, "PROFILE");
+    const JsonValue *extensions = member(device, "EXTENSIONS");
+    if (extensions != NULL && extensions->kind == JsonValue::JSON_STRING) caps.extensions = splitList(extensions->text);
+    else if (extensions != NULL)
+        for (size_t i = 0; i < extensions->items.size(); i++) caps.extensions.push_back(extensions->items[i].text);
+    caps.type = (cl_device_type) numberOf(device, "TYPE");
+    caps.computeUnits = (cl_uint) numberOf(device, "MAX_COMPUTE_UNITS");
+    caps.clockFrequency = (cl_uint) numberOf(device, "MAX_CLOCK_FREQUENCY");
+    caps.maxWorkGroupSize = (size_t) numberOf(device, "MAX_WORK_GROUP_SIZE");
+    const JsonValue *sizes = member(device, "MAX_WORK_ITEM_SIZES");
+    if (sizes != NULL)
+        for (size_t i = 0; i < sizes->items.size(); i++) caps.maxWorkItemSizes.push_back((size_t) sizes->items[i].number);
+    caps.globalMemSize = numberOf(device, "GLOBAL_MEM_SIZE");
+    caps.maxMemAllocSize = numberOf(device, "MAX_MEM_ALLOC_SIZE");
+    caps.globalMemCacheSize = numberOf(device, "GLOBAL_MEM_CACHE_SIZE");
+    caps.globalMemCachelineSize = (cl_uint) numberOf(device, "GLOBAL_MEM_CACHELINE_SIZE");
+    caps.localMemSize = numberOf(device, "LOCAL_MEM_SIZE");
+    caps.maxConstantBufferSize = numberOf(device, "MAX_CONSTANT_BUFFER_SIZE");
+    caps.maxConstantArgs = (cl_uint) numberOf(device, "MAX_CONSTANT_ARGS");
+    caps.preferredVectorWidthInt = (cl_uint) numberOf(device, "PREFERRED_VECTOR_WIDTH_INT");
+    caps.nativeVectorWidthInt = (cl_uint) numberOf(device, "NATIVE_VECTOR_WIDTH_INT");
+    caps.preferredVectorWidthFloat = (cl_uint) numberOf(device, "PREFERRED_VECTOR_WIDTH_FLOAT");
+    caps.preferredVectorWidthDouble = (cl_uint) numberOf(device, "PREFERRED_VECTOR_WIDTH_DOUBLE");
+    caps.hostUnifiedMemory = numberOf(device, "HOST_UNIFIED_MEMORY") != 0;
+    caps.imageSupport = numberOf(device, "IMAGE_SUPPORT") != 0;
+    caps.image2dMaxWidth = (size_t) numberOf(device, "IMAGE2D_MAX_WIDTH");
+    caps.image2dMaxHeight = (size_t) numberOf(device, "IMAGE2D_MAX_HEIGHT");
+    return caps;
+}
+
+/**
+    Collects every object with a NAME and a DRIVER_VERSION, at any depth (the snapshot has them in "devices", the
+    output of clInfo --json in the "devices" of each platform).
+*/
+static void collectDevices(const JsonValue &value, vector<DeviceCapabilities> *devices)
+{
+    if (value.kind == JsonValue::JSON_OBJECT && member(value, "NAME") != NULL && member(value, "DRIVER_VERSION") != NULL)
+    {
+        devices->push_back(capabilitiesFromJson(value));
+        return;
+    }
+    for (size_t i = 0; i < value.items.size(); i++) collectDevices(value.items[i], devices);
+}
+
+static void writeString(FILE *file, const string &text)
+{
+    fputc('"', file);
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        unsigned char c = (unsigned char) text[i];
+        if (c == '"' || c == '\\') fprintf(file, "\\%c", c);
+        else if (c < 0x20) fprintf(file, "\\u%04x", c);
+        else fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+static void writeDevice(FILE *file, const DeviceCapabilities &caps)
+{
+    fprintf(file, "    {\n      \"NAME\": ");                 writeString(file, caps.name);
+    fprintf(file, ",\n      \"VENDOR\": ");                 writeString(file, caps.vendor);
+    fprintf(file, ",\n      \"DRIVER_VERSION\": ");         writeString(file, caps.driverVersion);
+    fprintf(file, ",\n      \"VERSION\": ");                writeString(file, caps.version);
+    fprintf(file, ",\n      \"PROFILE\": ");                writeString(file, caps.profile);
+    fprintf(file, ",\n      \"EXTENSIONS\": [");
+    for (size_t i = 0; i < caps.extensions.size(); i++)
+    {
+        if (i > 0) fprintf(file, ", ");
+        writeString(file, caps.extensions[i]);
+    }
+    fprintf(file, "],\n      \"TYPE\": %llu", (unsigned long long) caps.type);
+    fprintf(file, ",\n      \"MAX_COMPUTE_UNITS\": %u", caps.computeUnits);
+    fprintf(file, ",\n      \"MAX_CLOCK_FREQUENCY\": %u", caps.clockFrequency);
+    fprintf(file, ",\n      \"MAX_WORK_GROUP_SIZE\": %llu", (unsigned long long) caps.maxWorkGroupSize);
+    fprintf(file, ",\n      \"MAX_WORK_ITEM_SIZES\": [");
+    for (size_t i = 0; i < caps.maxWorkItemSizes.size(); i++)
+        fprintf(file, "%s%llu", i > 0 ? ", " : "", (unsigned long long) caps.maxWorkItemSizes[i]);
+    fprintf(file, "],\n      \"GLOBAL_MEM_SIZE\": %llu", (unsigned long long) caps.globalMemSize);
+    fprintf(file, ",\n      \"MAX_MEM_ALLOC_SIZE\": %llu", (unsigned long long) caps.maxMemAllocSize);
+    fprintf(file, ",\n      \"GLOBAL_MEM_CACHE_SIZE\": %llu", (unsigned long long) caps.globalMemCacheSize);
+    fprintf(file, ",\n      \"GLOBAL_MEM_CACHELINE_SIZE\": %u", caps.globalMemCachelineSize);
+    fprintf(file, ",\n      \"LOCAL_MEM_SIZE\": %llu", (unsigned long long) caps.localMemSize);
+    fprintf(file, ",\n      \"MAX_CONSTANT_BUFFER_SIZE\": %llu", (unsigned long long) caps.maxConstantBufferSize);
+    fprintf(file, ",\n      \"MAX_CONSTANT_ARGS\": %u", caps.maxConstantArgs);
+    fprintf(file, ",\n      \"PREFERRED_VECTOR_WIDTH_INT\": %u", caps.preferredVectorWidthInt);
+    fprintf(file, ",\n      \"NATIVE_VECTOR_WIDTH_INT\": %u", caps.nativeVectorWidthInt);
+    fprintf(file, ",\n      \"PREFERRED_VECTOR_WIDTH_FLOAT\": %u", caps.preferredVectorWidthFloat);
+    fprintf(file, ",\n      \"PREFERRED_VECTOR_WIDTH_DOUBLE\": %u", caps.preferredVectorWidthDouble);
+    fprintf(file, ",\n      \"HOST_UNIFIED_MEMORY\": %d", caps.hostUnifiedMemory ? 1 : 0);
+    fprintf(file, ",\n      \"IMAGE_SUPPORT\": %d", caps.imageSupport ? 1 : 0);
+    fprintf(file, ",\n      \"IMAGE2D_MAX_WIDTH\": %llu", (unsigned long long) caps.image2dMaxWidth);
+    fprintf(file, ",\n      \"IMAGE2D_MAX_HEIGHT\": %llu\n    }", (unsigned long long) caps.image2dMaxHeight);
+}
+
+/**
+    Rewrites the snapshot file with every device known so far (called with the lock held).
+*/
+static void saveSnapshot()
+{
+    size_t slash = snapshotPath.rfind('/');
+    if (slash != string::npos) mkdir(snapshotPath.substr(0, slash).c_str(), 0755);
+
+    char suffix[32];
+    snprintf(suffix, sizeof suffix, ".%ld.tmp", (long) getpid());
+    string tmpName = snapshotPath + suffix;
+    FILE *file = fopen(tmpName.c_str(), "w");
+    if (file == NULL) { cout << "Capabilities: couldn't write " << tmpName << endl; return;}
+    fprintf(file, "{\n  \"devices\": [\n");
+    for (size_t d = 0; d < snapshot.size(); d++)
+    {
+        writeDevice(file, snapshot[d]);
+        fprintf(file, d + 1 < snapshot.size() ? ",\n" : "\n");
+    }
+    fprintf(file, "  ]\n}\n");
+    if (fclose(file) != 0 || rename(tmpName.c_str(), snapshotPath.c_str()) != 0)
+    {
+        cout << "Capabilities: couldn't write " << snapshotPath << endl;
+        remove(tmpName.c_str());
+    }
+}
+
+/**
+    Queries a numeric property, 0 if the runtime doesn't know it.
+*/
+template <typename T> static T queryNumber(cl_device_id device, cl_device_info param)
+{
+    T value = 0;
+    if (clGetDeviceInfo(device, param, sizeof(T), &value, NULL) != CL_SUCCESS) return 0;
+    return value;
+}
+
+void queryCapabilities(cl_device_id device, DeviceCapabilities *caps)
+{
+    caps->name = deviceInfoString(device, CL_DEVICE_NAME);
+    caps->vendor = deviceInfoString(device, CL_DEVICE_VENDOR);
+    caps->driverVersion = deviceInfoString(device, CL_DRIVER_VERSION);
+    caps->version = deviceInfoString(device, CL_DEVICE_VERSION);
+    caps->profile = deviceInfoString(device, CL_DEVICE_PROFILE);
+    caps->extensions = splitList(deviceInfoString(device, CL_DEVICE_EXTENSIONS));
+    caps->type = queryNumber<cl_device_type>(device, CL_DEVICE_TYPE);
+    caps->computeUnits = queryNumber<cl_uint>(device, CL_DEVICE_MAX_COMPUTE_UNITS);
+    caps->clockFrequency = queryNumber<cl_uint>(device, CL_DEVICE_MAX_CLOCK_FREQUENCY);
+    caps->maxWorkGroupSize = queryNumber<size_t>(device, CL_DEVICE_MAX_WORK_GROUP_SIZE);
+    cl_uint dimensions = queryNumber<cl_uint>(device, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS);
+    caps->maxWorkItemSizes.assign(dimensions, 0);
+    if (dimensions > 0 && clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES, dimensions * sizeof(size_t),
+                                          &caps->maxWorkItemSizes[0], NULL) != CL_SUCCESS)
+        caps->maxWorkItemSizes.clear();
+    caps->globalMemSize = queryNumber<cl_ulong>(device, CL_DEVICE_GLOBAL_MEM_SIZE);
+    caps->maxMemAllocSize = queryNumber<cl_ulong>(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE);
+    caps->globalMemCacheSize = queryNumber<cl_ulong>(device, CL_DEVICE_GLOBAL_MEM_CACHE_SIZE);
+    caps->globalMemCachelineSize = queryNumber<cl_uint>(device, CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE);
+    caps->localMemSize = queryNumber<cl_ulong>(device, CL_DEVICE_LOCAL_MEM_SIZE);
+    caps->maxConstantBufferSize = queryNumber<cl_ulong>(device, CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE);
+    caps->maxConstantArgs = queryNumber<cl_uint>(device, CL_DEVICE_MAX_CONSTANT_ARGS);
+    caps->preferredVectorWidthInt = queryNumber<cl_uint>(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT);
+    caps->nativeVectorWidthInt = queryNumber<cl_uint>(device, CL_DEVICE_NATIVE_VECTOR_WIDTH_INT);
+    caps->preferredVectorWidthFloat = queryNumber<cl_uint>(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT);
+    caps->preferredVectorWidthDouble = queryNumber<cl_uint>(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE);
+    caps->hostUnifiedMemory = queryNumber<cl_bool>(device, CL_DEVICE_HOST_UNIFIED_MEMORY) == CL_TRUE;
+    caps->imageSupport = queryNumber<cl_bool>(device, CL_DEVICE_IMAGE_SUPPORT) == CL_TRUE;
+    caps->image2dMaxWidth = queryNumber<size_t>(device, CL_DEVICE_IMAGE2D_MAX_WIDTH);
+    caps->image2dMaxHeight = queryNumber<size_t>(device, CL_DEVICE_IMAGE2D_MAX_HEIGHT);
+}
+
+size_t capabilitiesOpen(const char *path)
+{
+    lock_guard<mutex> guard(capabilitiesLock);
+    snapshot.clear();
+    byDevice.clear();
+    snapshotPath = path != NULL ? path : "";
+    if (path == NULL) return 0;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return 0;                                     // first run: the snapshot is created later
+    string text;
+    char buffer[1 << 16];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof buffer, file)) > 0) text.append(buffer, got);
+    fclose(file);
+
+    JsonValue root;
+    const char *p = text.c_str();
+    if (!parseValue(p, text.c_str() + text.size(), &root))
+    {
+        cout << "Capabilities: " << path << " is not valid JSON, querying the devices again" << endl;
+        return 0;
+    }
+    collectDevices(root, &snapshot);
+    return snapshot.size();
+}
+
+const DeviceCapabilities &deviceCapabilities(cl_device_id device)
+{
+    lock_guard<mutex> guard(capabilitiesLock);
+    map<cl_device_id, DeviceCapabilities>::iterator known = byDevice.find(device);
+    if (known != byDevice.end()) return known->second;
+
+    // sub-devices share the name of their parent, but not its compute units: they are always queried
+    DeviceCapabilities caps;
+    if (queryNumber<cl_device_id>(device, CL_DEVICE_PARENT_DEVICE) != NULL)      // OpenCL 1.2
+    {
+        queryCapabilities(device, &caps);
+        return byDevice[device] = caps;
+    }
+
+    // the name and driver version find the device in the snapshot, every other property comes from it
+    string name = deviceInfoString(device, CL_DEVICE_NAME);
+    string driverVersion = deviceInfoString(device, CL_DRIVER_VERSION);
+    for (size_t d = 0; d < snapshot.size(); d++)
+        if (snapshot[d].name == name && snapshot[d].driverVersion == driverVersion)
+            return byDevice[device] = snapshot[d];
+
+    queryCapabilities(device, &caps);
+    if (!snapshotPath.empty())
+    {
+        snapshot.push_back(caps);
+        saveSnapshot();
+    }
+    return byDevice[device] = caps;
+}
+
+bool hasExtension(const DeviceCapabilities &capabilities, const char *extension)
+{
+    for (size_t i = 0; i < capabilities.extensions.size(); i++)
+        if (capabilities.extensions[i] == extension) return true;
+    return false;
+}
@@ -0,0 +1,95 @@
+/**
+    Device capability snapshot. The properties the driver bases its tuning decisions on (work-group and work-item
+    limits, memory and cache sizes, vector widths, extensions...) are gathered in one struct per device, queried from
+    the runtime once and then kept in a JSON snapshot in the cache directory. The next runs load the snapshot, and
+    only ask the runtime for the name and driver version of each device, to find its entry.
+
+    The snapshot uses the property names of clInfo --json (CL_DEVICE_ without the prefix), and any JSON object with
+    a NAME and a DRIVER_VERSION is taken as a device: the output of clInfo --json can be used as a snapshot as well.
+    A new driver version makes a new entry, so a stale snapshot is never used.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLCAPABILITIES_H
+#define OPENCLCAPABILITIES_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define CAPABILITY_SNAPSHOT     "deviceCapabilities.json"       // file of the snapshot, in the cache directory
+
+/**
+    Capabilities of one device. Properties a runtime doesn't know (OpenCL 1.0) are 0.
+*/
+struct DeviceCapabilities
+{
+    std::string                 name;
+    std::string                 vendor;
+    std::string                 driverVersion;
+    std::string                 version;                    // OpenCL version of the device
+    std::string                 profile;                    // FULL_PROFILE or EMBEDDED_PROFILE
+    std::vector<std::string>    extensions;
+    cl_device_type              type;
+    cl_uint                     computeUnits;
+    cl_uint                     clockFrequency;             // MHz
+    size_t                      maxWorkGroupSize;
+    std::vector<size_t>         maxWorkItemSizes;           // one per dimension
+    cl_ulong                    globalMemSize;
+    cl_ulong                    maxMemAllocSize;
+    cl_ulong                    globalMemCacheSize;
+    cl_uint                     globalMemCachelineSize;
+    cl_ulong                    localMemSize;
+    cl_ulong                    maxConstantBufferSize;
+    cl_uint                     maxConstantArgs;
+    cl_uint                     preferredVectorWidthInt;
+    cl_uint                     nativeVectorWidthInt;       // OpenCL 1.1
+    cl_uint                     preferredVectorWidthFloat;
+    cl_uint                     preferredVectorWidthDouble;
+    bool                        hostUnifiedMemory;          // OpenCL 1.1
+    bool                        imageSupport;
+    size_t                      image2dMaxWidth;
+    size_t                      image2dMaxHeight;
+};
+
+/**
+    queryCapabilities asks the runtime for every capability of a device.
+    @param      device          device to query
+    @param      capabilities    filled with the properties of the device
+*/
+void queryCapabilities(cl_device_id device, DeviceCapabilities *capabilities);
+
+/**
+    capabilitiesOpen loads the snapshot kept in a file. Devices missing from it are queried on their first use, and
+    the file is then rewritten with them (through a temporary file and a rename).
+    @param      snapshotPath    snapshot file (<cache dir>/CAPABILITY_SNAPSHOT), or NULL to query every device
+    @return     devices         number of devices found in the snapshot
+*/
+size_t capabilitiesOpen(const char *snapshotPath);
+
+/**
+    deviceCapabilities gives the capabilities of a device: from the snapshot when it has the device, queried (and
+    added to the snapshot) otherwise. The result is kept for the whole run. Safe to call from several threads.
+    @param      device          device
+    @return     capabilities    capabilities of the device (valid until the end of the program)
+*/
+const DeviceCapabilities &deviceCapabilities(cl_device_id device);
+
+/**
+    hasExtension tells whether a device supports an extension.
+    @param      capabilities    capabilities of the device
+    @param      extension       name of the extension (cl_khr_fp64, cl_khr_subgroups...)
+    @return     supported       true if the extension is in the list of the device
+*/
+bool hasExtension(const DeviceCapabilities &capabilities, const char *extension);
+
+#endif
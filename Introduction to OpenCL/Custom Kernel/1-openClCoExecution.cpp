@@ -0,0 +1,168 @@
+/**
+    Heterogeneous co-execution of one zeroValues job. See 1-openClCoExecution.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include "1-openClCoExecution.h"
+#include "1-openClProfiler.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+/**
+    State shared by the host workers and the device feeder: the remaining range [front, back) and the counters of
+    each side, all protected by lock.
+*/
+struct SharedRange
+{
+    mutex               lock;
+    size_t              front;
+    size_t              back;
+    bool                useHost;
+    CoExecution         *co;
+    cl_kernel           kernel;
+    LaunchGeometry      geometry;
+    SimdLevel           simd;
+    const int           *input;
+    int                 *output;
+    int                 operand;
+    size_t              hostElements;
+    size_t              hostChunks;
+    size_t              deviceElements;
+    size_t              deviceBatches;
+};
+
+/**
+    Host end of the queue: one chunk from the front.
+*/
+static bool popFront(SharedRange *range, size_t *first, size_t *count)
+{
+    lock_guard<mutex> guard(range->lock);
+    if (range->front >= range->back) return false;
+    *first = range->front;
+    *count = range->back - range->front < range->co->hostChunk ? range->back - range->front : range->co->hostChunk;
+    range->front += *count;
+    range->hostElements += *count;
+    range->hostChunks++;
+    return true;
+}
+
+/**
+    Device end of the queue: a batch from the back. With host workers around, the batch is at most half of what is
+    left (but never smaller than a host chunk), so the last pieces of the range are shared instead of waited for.
+*/
+static bool popBack(SharedRange *range, size_t *first, size_t *count)
+{
+    lock_guard<mutex> guard(range->lock);
+    size_t remaining = range->back - range->front;
+    if (remaining == 0) return false;
+    size_t batch = range->co->deviceBatch;
+    if (range->useHost)
+    {
+        if (batch > remaining / 2) batch = remaining / 2;
+        if (batch < range->co->hostChunk) batch = range->co->hostChunk;
+    }
+    if (batch > remaining) batch = remaining;
+    range->back -= batch;
+    *first = range->back;
+    *count = batch;
+    range->deviceElements += batch;
+    range->deviceBatches++;
+    return true;
+}
+
+/**
+    Host worker, run by every thread of the host engine.
+*/
+static void hostWorker(void *argument, unsigned, unsigned)
+{
+    SharedRange *range = (SharedRange*) argument;
+    size_t first, count;
+    while (popFront(range, &first, &count))
+        hostZeroValues(range->simd, range->input + first, range->output + first, count, range->operand);
+}
+
+/**
+    Device feeder: write, kernel and read of one batch at a time, on the in-order queue of the device.
+*/
+static void deviceFeeder(SharedRange *range)
+{
+    cl_int clErr;
+    CoExecution *co = range->co;
+    size_t first, count;
+    while (popBack(range, &first, &count))
+    {
+        cl_int imax = (cl_int) count;
+        clErr  = clEnqueueWriteBuffer(co->queue, co->input, CL_FALSE, 0, count * sizeof(int), range->input + first, 0, NULL, NULL);
+        clErr |= clSetKernelArg(range->kernel,2,sizeof(cl_int),&imax);
+        clErr |= clEnqueueNDRangeKernel(co->queue, range->kernel, 1, NULL, &range->geometry.globalSize,
+                                        &range->geometry.localSize, 0, NULL, NULL);
+        clErr |= clEnqueueReadBuffer(co->queue, co->output, CL_TRUE, 0, count * sizeof(int), range->output + first, 0, NULL, NULL);
+        if (clErr != CL_SUCCESS) { cout << "Co-execution Error on the device: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    }
+}
+
+void coExecutionCreate(CoExecution *co, cl_context context, cl_device_id device, cl_command_queue queue,
+                       size_t hostChunk, size_t deviceBatch)
+{
+    cl_int clErr;
+    co->context = context;
+    co->device = device;
+    co->queue = queue;
+    co->hostChunk = hostChunk;
+    co->deviceBatch = deviceBatch;
+    co->input = clCreateBuffer(context, CL_MEM_READ_ONLY, deviceBatch * sizeof(int), NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    co->output = clCreateBuffer(context, CL_MEM_WRITE_ONLY, deviceBatch * sizeof(int), NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+}
+
+CoExecutionReport coExecutionRun(CoExecution *co, cl_kernel kernel, LaunchGeometry geometry, HostEngine *engine,
+                                 const int *input, int *output, size_t numberOfElements, int operand,
+                                 bool useHost, bool useDevice)
+{
+    cl_int clErr;
+    SharedRange range;
+    range.front = 0;
+    range.back = numberOfElements;
+    range.useHost = useHost;
+    range.co = co;
+    range.kernel = kernel;
+    range.geometry = geometry;
+    range.simd = engine->simd;
+    range.input = input;
+    range.output = output;
+    range.operand = operand;
+    range.hostElements = range.hostChunks = range.deviceElements = range.deviceBatches = 0;
+
+    clErr  = clSetKernelArg(kernel,0,sizeof(cl_mem),&co->input);
+    clErr |= clSetKernelArg(kernel,1,sizeof(cl_mem),&co->output);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    double start = wallClockMs();
+    thread feeder;
+    if (useDevice) feeder = thread(deviceFeeder, &range);
+    if (useHost) hostEngineParallel(engine, hostWorker, &range);
+    if (useDevice) feeder.join();
+
+    CoExecutionReport report;
+    report.wallMs = wallClockMs() - start;
+    report.hostElements = range.hostElements;
+    report.hostChunks = range.hostChunks;
+    report.deviceElements = range.deviceElements;
+    report.deviceBatches = range.deviceBatches;
+    return report;
+}
+
+void coExecutionRelease(CoExecution *co)
+{
+    clReleaseMemObject(co->input);
+    clReleaseMemObject(co->output);
+}
@@ -0,0 +1,90 @@
+/**
+    Heterogeneous co-execution of one zeroValues job on the native host engine (see 1-openClHostEngine.h) and an
+    OpenCL device at the same time. The index range lives in a shared double-ended work queue: the host workers pop
+    small chunks from its front, while a device feeder thread pops larger batches from its back, and whoever finishes
+    first keeps taking work until the range is drained. The device batches shrink as the range runs out, so the
+    device never holds a long tail the host threads could have shared.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLCOEXECUTION_H
+#define OPENCLCOEXECUTION_H
+
+#include <cstddef>
+#include "1-openClAutoTuner.h"
+#include "1-openClHostEngine.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define COEXEC_HOST_CHUNK       (1 << 16)       // default elements per host chunk (256KB of ints)
+
+/**
+    Device side of the co-execution: one buffer pair of deviceBatch ints, reused by every batch.
+*/
+struct CoExecution
+{
+    cl_context          context;
+    cl_device_id        device;
+    cl_command_queue    queue;
+    size_t              hostChunk;          // elements popped at a time by a host worker
+    size_t              deviceBatch;        // most elements popped at a time by the device feeder
+    cl_mem              input;
+    cl_mem              output;
+};
+
+/**
+    Share of the job taken by each side.
+*/
+struct CoExecutionReport
+{
+    double      wallMs;
+    size_t      hostElements;
+    size_t      hostChunks;
+    size_t      deviceElements;
+    size_t      deviceBatches;
+};
+
+/**
+    coExecutionCreate sets up the device buffers. The kernel geometry is tuned by the caller, on these buffers.
+    @param      co              co-execution to be created
+    @param      context         context of the device
+    @param      device          device running the kernel
+    @param      queue           command queue of the device
+    @param      hostChunk       elements popped at a time by a host worker
+    @param      deviceBatch     most elements popped at a time by the device feeder
+*/
+void coExecutionCreate(CoExecution *co, cl_context context, cl_device_id device, cl_command_queue queue,
+                       size_t hostChunk, size_t deviceBatch);
+
+/**
+    coExecutionRun runs one job, on the host workers, the device, or both of them.
+    @param      co              created co-execution
+    @param      kernel          zeroValues kernel (any vector width), run with (input, output, count) per batch
+    @param      geometry        launch geometry of the kernel for one batch
+    @param      engine          host engine (its threads are the host workers)
+    @param      input           host input, numberOfElements ints
+    @param      output          host output, numberOfElements ints
+    @param      numberOfElements    elements of the job
+    @param      operand         value added by the host workers (the same the kernel adds)
+    @param      useHost         let the host workers take work
+    @param      useDevice       let the device feeder take work
+    @return     report          share of each side, and wall time of the job
+*/
+CoExecutionReport coExecutionRun(CoExecution *co, cl_kernel kernel, LaunchGeometry geometry, HostEngine *engine,
+                                 const int *input, int *output, size_t numberOfElements, int operand,
+                                 bool useHost, bool useDevice);
+
+/**
+    coExecutionRelease releases the device buffers.
+    @param      co              co-execution to be released
+*/
+void coExecutionRelease(CoExecution *co);
+
+#endif
@@ -0,0 +1,173 @@
+/**
+    Compact engine. See 1-openClCompact.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include "1-openClCompact.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+const char *compactOrderName(CompactOrder order)
+{
+    switch (order) {
+        case COMPACT_UNORDERED: return "unordered";
+        case COMPACT_STABLE:    return "stable";
+    }
+    return "unknown";
+}
+
+// __local bytes of a block: its ballot words, its staged elements, and the base of compactFilter
+static size_t localBytes(size_t localSize, size_t blockElements)
+{
+    return ((localSize + 31) / 32 + blockElements + 1) * sizeof(cl_int);
+}
+
+void compactCreate(CompactEngine *engine, KernelLibrary *library, cl_command_queue queue)
+{
+    cl_int clErr;
+    const DeviceCapabilities &caps = deviceCapabilities(library->device);
+    engine->library = library;
+    engine->queue = queue;
+    scanCreate(&engine->scan, library, queue);
+    engine->counts = NULL;
+    engine->countCapacity = 0;
+    engine->counter = clCreateBuffer(library->context, CL_MEM_READ_WRITE, sizeof(cl_int), NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    // the biggest power of two every kernel can run with, then as many chunks per block as the __local memory holds
+    const char *names[] = {"compactFilter", "compactCount", "compactScatter"};
+    size_t limit = COMPACT_LOCAL_SIZE;
+    for (int k = 0; k < 3; k++)
+    {
+        size_t size;
+        clErr = clGetKernelWorkGroupInfo(kernelLibraryGet(library, names[k]), library->device,
+                                         CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &size, NULL);
+        if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        if (size < limit) limit = size;
+    }
+    engine->localSize = 1;
+    while (engine->localSize * 2 <= limit) engine->localSize *= 2;
+    size_t chunks = COMPACT_BLOCK_CHUNKS;
+    while (chunks > 1 && localBytes(engine->localSize, engine->localSize * chunks) > caps.localMemSize) chunks /= 2;
+    engine->blockElements = engine->localSize * chunks;
+}
+
+static void launch(CompactEngine *engine, cl_kernel kernel, size_t globalSize, size_t localSize,
+                   vector<cl_event> *events)
+{
+    cl_event event;
+    cl_int clErr = clEnqueueNDRangeKernel(engine->queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    events->push_back(event);
+}
+
+// the arguments shared by the three kernels: input, n, the predicate and the block size
+static void setCommonArgs(cl_kernel kernel, cl_mem input, cl_int n, const CompactPredicate &predicate,
+                          cl_int blockElements)
+{
+    cl_int clErr  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &input);
+    clErr |= clSetKernelArg(kernel, 1, sizeof(cl_int), &n);
+    clErr |= clSetKernelArg(kernel, 2, sizeof(cl_int), &predicate.operand);
+    clErr |= clSetKernelArg(kernel, 3, sizeof(cl_int), &predicate.low);
+    clErr |= clSetKernelArg(kernel, 4, sizeof(cl_int), &predicate.high);
+    clErr |= clSetKernelArg(kernel, 5, sizeof(cl_int), &blockElements);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+}
+
+CompactReport compactBuffer(CompactEngine *engine, CompactOrder order, const CompactPredicate &predicate,
+                            cl_mem input, cl_mem output, size_t numberOfElements, Profiler *profiler)
+{
+    cl_int clErr;
+    CompactReport report = {order, 0, 0, 0, 0, 0};
+    if (numberOfElements == 0) return report;
+    cl_int n = (cl_int) numberOfElements;
+    cl_int blockElements = (cl_int) engine->blockElements;
+    size_t local = engine->localSize;
+    size_t blocks = (numberOfElements + engine->blockElements - 1) / engine->blockElements;
+    size_t ballotBytes = (local + 31) / 32 * sizeof(cl_uint);
+    size_t stagedBytes = engine->blockElements * sizeof(cl_int);
+    report.blocks = blocks;
+
+    vector<cl_event> events;
+    if (order == COMPACT_UNORDERED)
+    {
+        cl_int zero = 0;
+        clErr = clEnqueueFillBuffer(engine->queue, engine->counter, &zero, sizeof(cl_int), 0, sizeof(cl_int), 0,
+                                    NULL, NULL);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueFillBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        cl_kernel filter = kernelLibraryGet(engine->library, "compactFilter");
+        setCommonArgs(filter, input, n, predicate, blockElements);
+        clErr  = clSetKernelArg(filter, 6, sizeof(cl_mem), &output);
+        clErr |= clSetKernelArg(filter, 7, sizeof(cl_mem), &engine->counter);
+        clErr |= clSetKernelArg(filter, 8, ballotBytes, NULL);
+        clErr |= clSetKernelArg(filter, 9, stagedBytes, NULL);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        launch(engine, filter, blocks * local, local, &events);
+    }
+    else
+    {
+        if (engine->counts == NULL || engine->countCapacity < blocks)
+        {
+            if (engine->counts != NULL) clReleaseMemObject(engine->counts);
+            engine->counts = clCreateBuffer(engine->library->context, CL_MEM_READ_WRITE, blocks * sizeof(cl_int), NULL,
+                                            &clErr);
+            if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+            engine->countCapacity = blocks;
+        }
+        cl_kernel count = kernelLibraryGet(engine->library, "compactCount");
+        setCommonArgs(count, input, n, predicate, blockElements);
+        clErr  = clSetKernelArg(count, 6, sizeof(cl_mem), &engine->counts);
+        clErr |= clSetKernelArg(count, 7, ballotBytes, NULL);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        launch(engine, count, blocks * local, local, &events);
+
+        // first output position of each block
+        ScanReport scanned = scanBuffer(&engine->scan, SCAN_EXCLUSIVE, SCAN_AUTO, engine->counts, engine->counts,
+                                        blocks, profiler);
+        report.kernels += scanned.kernels;
+        report.kernelMs += scanned.kernelMs;
+
+        cl_kernel scatter = kernelLibraryGet(engine->library, "compactScatter");
+        setCommonArgs(scatter, input, n, predicate, blockElements);
+        clErr  = clSetKernelArg(scatter, 6, sizeof(cl_mem), &engine->counts);
+        clErr |= clSetKernelArg(scatter, 7, sizeof(cl_mem), &output);
+        clErr |= clSetKernelArg(scatter, 8, sizeof(cl_mem), &engine->counter);
+        clErr |= clSetKernelArg(scatter, 9, ballotBytes, NULL);
+        clErr |= clSetKernelArg(scatter, 10, stagedBytes, NULL);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        launch(engine, scatter, blocks * local, local, &events);
+    }
+
+    // the count is all the host needs to read the kept elements
+    cl_int kept;
+    clErr = clEnqueueReadBuffer(engine->queue, engine->counter, CL_TRUE, 0, sizeof(cl_int), &kept, 0, NULL, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueReadBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    report.count = (size_t) kept;
+
+    for (size_t e = 0; e < events.size(); e++)
+    {
+        double ms = eventMilliseconds(events[e]);
+        if (ms > 0) report.kernelMs += ms;
+        if (profiler != NULL) profilerAddStage(profiler, "compact", events[e], 0, numberOfElements);
+        else clReleaseEvent(events[e]);
+    }
+    report.kernels += events.size();
+    if (report.kernelMs > 0)
+        report.gbPerSecond = (numberOfElements + report.count) * sizeof(cl_int) / (report.kernelMs * 1e6);
+    return report;
+}
+
+void compactRelease(CompactEngine *engine)
+{
+    scanRelease(&engine->scan);
+    clReleaseMemObject(engine->counter);
+    if (engine->counts != NULL) clReleaseMemObject(engine->counts);
+}
@@ -0,0 +1,115 @@
+/**
+    Compact engine (compactKernel.cl): stream compaction of an int device buffer. Every element goes through the
+    zeroValues transform (value + operand), and the results within [low, high] are written densely to the output,
+    with their count. Only the kept elements, and the count, have to be read back to the host.
+
+    Each work-group takes a block of the input: a ballot in __local memory gives the rank of each kept element in
+    its block, and the kept elements of a block are written out as one coalesced run. The runs are placed either:
+
+    - unordered, in a single pass: one global atomic_add per block reserves its room in the output. The blocks land
+      in the order they finish, the elements of a block stay in order.
+    - stable, in three steps: the count of each block, their exclusive scan (1-openClScan.h), then the blocks
+      written at their scanned positions. The output keeps the order of the input.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLCOMPACT_H
+#define OPENCLCOMPACT_H
+
+#include <cstddef>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+#include "1-openClScan.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define COMPACT_LOCAL_SIZE      256     // biggest work-group size (a power of two)
+#define COMPACT_BLOCK_CHUNKS    8       // chunks of work-group size in each block, at most
+
+enum CompactOrder
+{
+    COMPACT_UNORDERED,      // one pass, one atomic per block
+    COMPACT_STABLE          // count, scan and scatter: the order of the input
+};
+
+/**
+    Transform and filter: values[i] + operand is kept when it is within [low, high].
+*/
+struct CompactPredicate
+{
+    cl_int      operand;
+    cl_int      low;
+    cl_int      high;
+};
+
+/**
+    Kernels of one device, and the buffers reused between compactions.
+*/
+struct CompactEngine
+{
+    KernelLibrary       *library;
+    cl_command_queue    queue;
+    ScanEngine          scan;
+    size_t              localSize;
+    size_t              blockElements;      // elements of the block of one work-group
+    cl_mem              counter;            // kept elements (one int)
+    cl_mem              counts;             // kept elements of each block, then its first output position
+    size_t              countCapacity;      // ints counts can hold
+};
+
+/**
+    Cost of one compaction.
+*/
+struct CompactReport
+{
+    CompactOrder    order;
+    size_t          count;          // elements kept, in the first count ints of the output
+    size_t          blocks;         // work-groups of each kernel
+    size_t          kernels;        // kernels launched, scans included
+    double          kernelMs;       // device time of the kernels
+    double          gbPerSecond;    // input read and kept elements written, over kernelMs
+};
+
+/**
+    compactCreate picks the work-group size and the block size that fits the __local memory.
+    @param      engine          engine to be created
+    @param      library         kernel library of the device, with compactKernel.cl and scanKernel.cl built in
+    @param      queue           command queue of the device, created with CL_QUEUE_PROFILING_ENABLE
+*/
+void compactCreate(CompactEngine *engine, KernelLibrary *library, cl_command_queue queue);
+
+/**
+    compactBuffer transforms and filters a device buffer into another one, and reads back the count of kept elements.
+    @param      engine          engine created by compactCreate
+    @param      order           COMPACT_UNORDERED or COMPACT_STABLE
+    @param      predicate       transform and range of the kept elements
+    @param      input           ints to compact
+    @param      output          room for numberOfElements ints (not input), the kept ones come first
+    @param      numberOfElements    elements of input (at most 0x7fffffff)
+    @param      profiler        profiler recording every kernel (may be NULL)
+    @return     report          count, kernels and device time
+*/
+CompactReport compactBuffer(CompactEngine *engine, CompactOrder order, const CompactPredicate &predicate,
+                            cl_mem input, cl_mem output, size_t numberOfElements, Profiler *profiler);
+
+/**
+    compactOrderName gives the name of an order.
+    @param      order           order
+    @return     name            "unordered" or "stable"
+*/
+const char *compactOrderName(CompactOrder order);
+
+/**
+    compactRelease releases the buffers of the engine (the kernels belong to the library).
+    @param      engine          engine to be released
+*/
+void compactRelease(CompactEngine *engine);
+
+#endif
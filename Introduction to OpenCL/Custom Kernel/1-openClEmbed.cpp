@@ -0,0 +1,47 @@
+/**
+    Build-time tool of the kernel library (see 1-openClKernelLibrary.h): turns every .cl file given on the command
+    line into a byte array of a generated C++ file, so the driver needs no kernel file at runtime.
+
+    Usage: 1-openClEmbed <generated .cpp> <kernel.cl>...
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) { fprintf(stderr, "Usage: %s <generated .cpp> <kernel.cl>...\n", argv[0]); return EXIT_FAILURE;}
+    FILE *out = fopen(argv[1], "w");
+    if (out == NULL) { fprintf(stderr, "Couldn't create %s\n", argv[1]); return EXIT_FAILURE;}
+
+    fprintf(out, "// Generated by 1-openClEmbed from the KERNELS of 1-Makefile. Don't edit, edit the .cl files.\n\n");
+    fprintf(out, "#include \"1-openClKernelLibrary.h\"\n");
+    for (int f = 2; f < argc; f++)
+    {
+        FILE *in = fopen(argv[f], "rb");
+        if (in == NULL) { fprintf(stderr, "Couldn't open %s\n", argv[f]); fclose(out); remove(argv[1]); return EXIT_FAILURE;}
+        fprintf(out, "\nstatic const char source%d[] = {", f - 2);
+        int c;
+        long size = 0;
+        while ((c = fgetc(in)) != EOF)
+            fprintf(out, "%s0x%02x,", size++ % 16 == 0 ? "\n    " : " ", c);
+        fprintf(out, "\n    0x00\n};\n");
+        fclose(in);
+    }
+
+    fprintf(out, "\nconst EmbeddedSource embeddedSources[] = {\n");
+    for (int f = 2; f < argc; f++)
+    {
+        const char *name = strrchr(argv[f], '/') != NULL ? strrchr(argv[f], '/') + 1 : argv[f];
+        fprintf(out, "    {\"%s\", source%d, sizeof(source%d) - 1},\n", name, f - 2, f - 2);
+    }
+    fprintf(out, "};\n\nconst size_t numEmbeddedSources = %d;\n", argc - 2);
+
+    if (fclose(out) != 0) { fprintf(stderr, "Couldn't write %s\n", argv[1]); remove(argv[1]); return EXIT_FAILURE;}
+    return 0;
+}
@@ -0,0 +1,617 @@
+/**
+    Demos of the device engines. See 1-openClEngineDemos.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "1-openClEngineDemos.h"
+#include "1-openClAutoTuner.h"
+#include "1-openClVectorKernels.h"
+#include "1-openClHostMemory.h"
+#include "1-openClHostEngine.h"
+#include "1-openClHistogram.h"
+#include "1-openClGemm.h"
+#include "1-openClStencil.h"
+#include "1-openClTranspose.h"
+#include "1-openClCompact.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+static cl_mem createBuffer(const DemoDevice &demo, cl_mem_flags flags, size_t bytes, const void *host)
+{
+    cl_int clErr;
+    cl_mem buffer = clCreateBuffer(demo.context, flags, bytes, (void*) host, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    return buffer;
+}
+
+// read-only buffer written from the host, the write recorded in the profiler as stage
+static cl_mem writeInput(const DemoDevice &demo, size_t bytes, const void *host, const char *stage)
+{
+    cl_mem buffer = createBuffer(demo, CL_MEM_READ_ONLY, bytes, NULL);
+    cl_event event;
+    cl_int clErr = clEnqueueWriteBuffer(demo.queue, buffer, CL_TRUE, 0, bytes, host, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    profilerAddStage(demo.profiler, stage, event, bytes, 0);
+    return buffer;
+}
+
+static void readOutput(const DemoDevice &demo, cl_mem buffer, size_t bytes, void *host)
+{
+    cl_int clErr = clEnqueueReadBuffer(demo.queue, buffer, CL_TRUE, 0, bytes, host, 0, NULL, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueReadBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+}
+
+void demoReductions(const DemoDevice &demo, cl_kernel kernel, cl_uint width, const char *tuningFile, int tuneMode,
+                    const int *input, const int *output, size_t numberOfElements, int operations)
+{
+    cl_int clErr;
+    size_t bufferSize = numberOfElements * sizeof(int);
+    cl_mem inputBuffer = writeInput(demo, bufferSize, input, "reduce: write vectorA");
+    cl_mem outputBuffer = createBuffer(demo, CL_MEM_READ_WRITE, bufferSize, NULL);
+
+    // the job, with its output left on the device
+    cl_int imax = (cl_int) numberOfElements;
+    clErr  = clSetKernelArg(kernel,0,sizeof(cl_mem),&inputBuffer);
+    clErr |= clSetKernelArg(kernel,1,sizeof(cl_mem),&outputBuffer);
+    clErr |= clSetKernelArg(kernel,2,sizeof(cl_int),&imax);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    size_t workItems = vectorWorkItems(numberOfElements, width);
+    LaunchGeometry geometry = tuneMode == 0 ? defaultGeometry(demo.device, kernel, workItems) :
+                              autoTuneGeometry(demo.queue, demo.device, kernel, zeroValuesKernelName(width), workItems,
+                                               tuningFile, tuneMode == 2);
+    cl_event event;
+    clErr = clEnqueueNDRangeKernel(demo.queue, kernel, 1, NULL, &geometry.globalSize, &geometry.localSize, 0, NULL,
+                                   &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    profilerAddStage(demo.profiler, (string("reduce: kernel ") + zeroValuesKernelName(width)).c_str(), event, 0,
+                     numberOfElements);
+
+    // float copy of the output, converted on the host
+    float *floats = (float*) allocateHostBuffer(numberOfElements * sizeof(float));
+    for (size_t i = 0; i < numberOfElements; i++) floats[i] = (float) output[i];
+    cl_mem floatBuffer = writeInput(demo, numberOfElements * sizeof(float), floats, "reduce: write floats");
+
+    ReductionEngine engine;
+    reductionCreate(&engine, demo.library, demo.queue);
+    cout << endl << "Reductions on the device (" << (engine.subGroups ? "sub-groups" : "local memory tree")
+         << ", output of " << bufferSize << " bytes left on the device):" << endl;
+    ReduceOperation all[] = {REDUCE_SUM, REDUCE_MIN, REDUCE_MAX, REDUCE_ARGMAX};
+    for (int o = 0; o < 4; o++)
+    {
+        if ((operations & (1 << all[o])) == 0) continue;
+        for (int e = 0; e < 2; e++)
+        {
+            ReduceElement element = e == 0 ? REDUCE_INT : REDUCE_FLOAT;
+            ReduceResult result = reduceBuffer(&engine, all[o], element, e == 0 ? outputBuffer : floatBuffer,
+                                               numberOfElements, demo.profiler);
+
+            // host reduction of the same data, the argmax being the first index of the largest value
+            double hostStart = wallClockMs();
+            long long hostSum = 0;
+            double hostRealSum = 0, hostValue = e == 0 ? output[0] : floats[0];
+            cl_int hostIndex = 0;
+            for (size_t i = 0; i < numberOfElements; i++)
+            {
+                double value = e == 0 ? output[i] : floats[i];
+                hostSum += output[i];
+                hostRealSum += floats[i];
+                if (all[o] == REDUCE_MIN && value < hostValue) hostValue = value;
+                if ((all[o] == REDUCE_MAX || all[o] == REDUCE_ARGMAX) && value > hostValue)
+                {
+                    hostValue = value;
+                    hostIndex = (cl_int) i;
+                }
+            }
+            double hostMs = wallClockMs() - hostStart;
+
+            double deviceValue = e == 0 ? (double) result.integer : result.real;
+            bool matches;
+            if (all[o] == REDUCE_SUM && e == 0) matches = result.integer == hostSum;
+            else if (all[o] == REDUCE_SUM) matches = fabs(deviceValue - hostRealSum) <= 1e-3 * fabs(hostRealSum);
+            else matches = deviceValue == hostValue && (all[o] != REDUCE_ARGMAX || result.index == hostIndex);
+
+            cout << "\t" << reduceOperationName(all[o]) << (e == 0 ? " int:   " : " float: ");
+            if (all[o] == REDUCE_SUM && e == 0) cout << result.integer;
+            else cout << deviceValue;
+            if (all[o] == REDUCE_ARGMAX) cout << " at " << result.index;
+            cout << (matches ? " (matches the host)" : " (MISMATCH with the host)") << ", " << result.passes
+                 << " pass(es) in " << result.kernelMs << " ms, " << numberOfElements * (e == 0 ? sizeof(int) : sizeof(float))
+                 / (result.kernelMs * 1e6) << " GB/s, " << result.bytesRead << " bytes read back (host: " << hostMs
+                 << " ms)" << endl;
+        }
+    }
+
+    reductionRelease(&engine);
+    freeHostBuffer(floats);
+    clReleaseMemObject(inputBuffer);
+    clReleaseMemObject(outputBuffer);
+    clReleaseMemObject(floatBuffer);
+}
+
+void demoScan(const DemoDevice &demo, const int *input, size_t numberOfElements, ScanKind kind)
+{
+    size_t bufferSize = numberOfElements * sizeof(int);
+    cl_mem inputBuffer = writeInput(demo, bufferSize, input, "scan: write vectorA");
+    cl_mem outputBuffer = createBuffer(demo, CL_MEM_READ_WRITE, bufferSize, NULL);
+
+    // host scan, with the same wrap around as the device (unsigned, to stay defined)
+    double hostStart = wallClockMs();
+    int *expected = (int*) allocateHostBuffer(bufferSize);
+    unsigned int sum = 0;
+    for (size_t i = 0; i < numberOfElements; i++)
+    {
+        if (kind == SCAN_INCLUSIVE) sum += (unsigned int) input[i];
+        expected[i] = (int) sum;
+        if (kind == SCAN_EXCLUSIVE) sum += (unsigned int) input[i];
+    }
+    double hostMs = wallClockMs() - hostStart;
+
+    ScanEngine engine;
+    scanCreate(&engine, demo.library, demo.queue);
+    int *scanned = (int*) allocateHostBuffer(bufferSize);
+    cout << endl << (kind == SCAN_INCLUSIVE ? "Inclusive" : "Exclusive") << " scan on the device (tiles of "
+         << 2 * engine.localSize << " elements, host scan " << hostMs << " ms):" << endl;
+    ScanAlgorithm algorithms[] = {SCAN_MULTI_LEVEL, SCAN_DECOUPLED_LOOKBACK};
+    for (int a = 0; a < 2; a++)
+    {
+        if (algorithms[a] == SCAN_DECOUPLED_LOOKBACK && !engine.lookback)
+        {
+            cout << "\t" << scanAlgorithmName(algorithms[a]) << ": not supported by the device" << endl;
+            continue;
+        }
+        ScanReport report = scanBuffer(&engine, kind, algorithms[a], inputBuffer, outputBuffer, numberOfElements,
+                                       demo.profiler);
+        readOutput(demo, outputBuffer, bufferSize, scanned);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < numberOfElements; i++) if (scanned[i] != expected[i]) mismatches++;
+        cout << "\t" << scanAlgorithmName(report.algorithm) << ": " << report.kernelMs << " ms, " << report.gbPerSecond
+             << " GB/s, " << report.kernels << " kernel(s) on " << report.levels << " level(s), " << mismatches
+             << " mismatching elements" << endl;
+    }
+
+    scanRelease(&engine);
+    freeHostBuffer(scanned);
+    freeHostBuffer(expected);
+    clReleaseMemObject(inputBuffer);
+    clReleaseMemObject(outputBuffer);
+}
+
+void demoRadixSort(const DemoDevice &demo, const int *input, size_t numberOfElements, RadixKeyType keyType)
+{
+    if (!radixSortFits(demo.device, numberOfElements, true))
+    {
+        cout << endl << "The radix sort of " << numberOfElements << " keys doesn't fit the device: skipped" << endl;
+        return;
+    }
+
+    // about 4 copies of each key, half of them negative for int and float keys
+    size_t bufferSize = numberOfElements * sizeof(cl_uint);
+    cl_uint range = (cl_uint) (numberOfElements / 4 + 1);
+    cl_uint *keys = (cl_uint*) allocateHostBuffer(bufferSize);
+    cl_uint *values = (cl_uint*) allocateHostBuffer(bufferSize);
+    for (size_t i = 0; i < numberOfElements; i++)
+    {
+        cl_uint hash = ((cl_uint) input[i] ^ (cl_uint) i) * 2654435761u;
+        cl_int key = (cl_int) ((hash >> 1) % range) - (keyType == RADIX_UINT ? 0 : (cl_int) (range / 2));
+        if (keyType == RADIX_FLOAT)
+        {
+            float real = key * 0.5f;
+            memcpy(&keys[i], &real, sizeof(float));
+        }
+        else keys[i] = (cl_uint) key;
+        values[i] = (cl_uint) i;
+    }
+
+    // expected order: by key, then by index
+    vector<cl_uint> order(numberOfElements);
+    for (size_t i = 0; i < numberOfElements; i++) order[i] = (cl_uint) i;
+    sort(order.begin(), order.end(), [keys, keyType](cl_uint a, cl_uint b) {
+        if (keys[a] == keys[b]) return a < b;
+        if (keyType == RADIX_INT) return (cl_int) keys[a] < (cl_int) keys[b];
+        if (keyType == RADIX_FLOAT)
+        {
+            float x, y;
+            memcpy(&x, &keys[a], sizeof(float));
+            memcpy(&y, &keys[b], sizeof(float));
+            return x < y;
+        }
+        return keys[a] < keys[b];
+    });
+
+    // the host baseline: std::sort of the keys, as their own type
+    double hostStart = wallClockMs();
+    if (keyType == RADIX_INT)
+    {
+        vector<cl_int> copy((cl_int*) keys, (cl_int*) keys + numberOfElements);
+        hostStart = wallClockMs();
+        sort(copy.begin(), copy.end());
+    }
+    else if (keyType == RADIX_FLOAT)
+    {
+        vector<float> copy(numberOfElements);
+        memcpy(copy.data(), keys, bufferSize);
+        hostStart = wallClockMs();
+        sort(copy.begin(), copy.end());
+    }
+    else
+    {
+        vector<cl_uint> copy(keys, keys + numberOfElements);
+        hostStart = wallClockMs();
+        sort(copy.begin(), copy.end());
+    }
+    double hostMs = wallClockMs() - hostStart;
+
+    // sorted in place: read-write buffers
+    cl_mem keyBuffer = createBuffer(demo, CL_MEM_READ_WRITE, bufferSize, NULL);
+    cl_mem valueBuffer = createBuffer(demo, CL_MEM_READ_WRITE, bufferSize, NULL);
+    cl_event event;
+    cl_int clErr = clEnqueueWriteBuffer(demo.queue, keyBuffer, CL_TRUE, 0, bufferSize, keys, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    profilerAddStage(demo.profiler, "sort: write keys", event, bufferSize, 0);
+    clErr = clEnqueueWriteBuffer(demo.queue, valueBuffer, CL_TRUE, 0, bufferSize, values, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    profilerAddStage(demo.profiler, "sort: write payloads", event, bufferSize, 0);
+
+    RadixSortEngine engine;
+    radixSortCreate(&engine, demo.library, demo.queue);
+    RadixSortReport report = radixSort(&engine, keyType, keyBuffer, valueBuffer, numberOfElements, demo.profiler);
+    readOutput(demo, keyBuffer, bufferSize, keys);
+    readOutput(demo, valueBuffer, bufferSize, values);
+
+    // the payloads must come out in the expected order, and carry their keys along
+    size_t mismatches = 0;
+    for (size_t i = 0; i < numberOfElements; i++) if (values[i] != order[i]) mismatches++;
+    const char *typeName = keyType == RADIX_INT ? "int" : keyType == RADIX_FLOAT ? "float" : "uint";
+    cout << endl << "Radix sort of " << numberOfElements << " " << typeName << " keys with payloads ("
+         << report.blocks << " blocks of " << engine.blockElements << " keys per pass):" << endl;
+    cout << "\t" << "device:    " << report.wallMs << " ms (" << report.kernelMs << " ms in " << report.kernels
+         << " kernels), " << numberOfElements / (report.wallMs * 1e3) << " Mkeys/s, " << mismatches
+         << " mismatching elements" << endl;
+    cout << "\t" << "std::sort: " << hostMs << " ms, " << numberOfElements / (hostMs * 1e3) << " Mkeys/s (keys only)" << endl;
+
+    radixSortRelease(&engine);
+    freeHostBuffer(keys);
+    freeHostBuffer(values);
+    clReleaseMemObject(keyBuffer);
+    clReleaseMemObject(valueBuffer);
+}
+
+void demoHistogram(const DemoDevice &demo, const int *input, size_t numberOfElements, size_t bins)
+{
+    size_t bufferSize = numberOfElements * sizeof(int);
+    const cl_int low = 0, high = 65535;
+
+    // the square of a uniform value in [0, 65535], scaled back to the same range
+    int *values = (int*) allocateHostBuffer(bufferSize);
+    for (size_t i = 0; i < numberOfElements; i++)
+    {
+        cl_uint hash = ((cl_uint) input[i] ^ (cl_uint) i) * 2654435761u;
+        values[i] = (int) (((hash >> 16) * (hash >> 16)) >> 16);
+    }
+    double hostStart = wallClockMs();
+    vector<cl_uint> expected(bins, 0);
+    for (size_t i = 0; i < numberOfElements; i++)
+        expected[(size_t) ((cl_long) (values[i] - low) * bins / ((cl_long) high - low + 1))]++;
+    double hostMs = wallClockMs() - hostStart;
+
+    cl_mem valueBuffer = writeInput(demo, bufferSize, values, "histogram: write values");
+    cl_mem countBuffer = createBuffer(demo, CL_MEM_READ_WRITE, bins * sizeof(cl_uint), NULL);
+
+    HistogramEngine engine;
+    histogramCreate(&engine, demo.library, demo.queue);
+    vector<cl_uint> counted(bins);
+    cout << endl << "Histogram of " << numberOfElements << " values in " << bins << " bins (work-groups of "
+         << engine.localSize << ", wavefronts of " << engine.wavefront << ", host " << hostMs << " ms):" << endl;
+    HistogramStrategy strategies[] = {HISTOGRAM_PRIVATIZED, HISTOGRAM_GLOBAL};
+    for (int s = 0; s < 2; s++)
+    {
+        if (strategies[s] == HISTOGRAM_PRIVATIZED && histogramReplicas(&engine, bins) == 0)
+        {
+            cout << "\t" << histogramStrategyName(strategies[s]) << ": the bins don't fit the __local memory" << endl;
+            continue;
+        }
+        HistogramReport report = histogramBuffer(&engine, strategies[s], valueBuffer, numberOfElements, low, high, bins,
+                                                 countBuffer, demo.profiler);
+        readOutput(demo, countBuffer, bins * sizeof(cl_uint), counted.data());
+        size_t mismatches = 0;
+        for (size_t b = 0; b < bins; b++) if (counted[b] != expected[b]) mismatches++;
+        cout << "\t" << histogramStrategyName(report.strategy) << ": " << report.kernelMs << " ms, "
+             << report.gbPerSecond << " GB/s, " << report.groups << " work-groups";
+        if (report.replicas > 0) cout << " of " << report.replicas << " replica(s)";
+        cout << ", " << mismatches << " mismatching bins" << endl;
+    }
+
+    histogramRelease(&engine);
+    freeHostBuffer(values);
+    clReleaseMemObject(valueBuffer);
+    clReleaseMemObject(countBuffer);
+}
+
+// one precision of demoGemm: the host baseline, then the naive and the tiled kernel, checked against it
+template <typename T>
+static void demoGemmPrecision(const DemoDevice &demo, GemmEngine *engine, HostEngine *pool, GemmPrecision precision,
+                              size_t n)
+{
+    size_t bufferSize = n * n * sizeof(T);
+    T *A = (T*) allocateHostBuffer(bufferSize);
+    T *B = (T*) allocateHostBuffer(bufferSize);
+    T *expected = (T*) allocateHostBuffer(bufferSize);
+    T *C = (T*) allocateHostBuffer(bufferSize);
+    for (size_t i = 0; i < n * n; i++)
+    {
+        A[i] = (T) ((i * 2654435761u) % 2001) / 1000 - 1;           // in [-1, 1]
+        B[i] = (T) ((i * 40503u + 7) % 2001) / 1000 - 1;
+    }
+    double hostMs = gemmHost(pool, n, n, n, (T) 1, A, B, (T) 0, expected);
+    double flop = 2.0 * n * n * n;
+    cout << "\t" << (precision == GEMM_DOUBLE ? "double" : "float") << " host:  " << hostMs << " ms, "
+         << flop / (hostMs * 1e6) << " GFLOP/s (" << pool->threads.size() << " threads)" << endl;
+
+    cl_mem bufferA = createBuffer(demo, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, bufferSize, A);
+    cl_mem bufferB = createBuffer(demo, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, bufferSize, B);
+    cl_mem bufferC = createBuffer(demo, CL_MEM_WRITE_ONLY, bufferSize, NULL);
+
+    GemmKernel kernels[] = {GEMM_NAIVE, GEMM_TILED};
+    for (int k = 0; k < 2; k++)
+    {
+        GemmReport report = gemmRun(engine, kernels[k], precision, n, n, n, 1, bufferA, bufferB, 0, bufferC,
+                                    demo.profiler);
+        readOutput(demo, bufferC, bufferSize, C);
+        double maxError = 0;
+        for (size_t i = 0; i < n * n; i++)
+        {
+            double error = fabs((double) C[i] - expected[i]) / (fabs((double) expected[i]) + 1);
+            if (error > maxError) maxError = error;
+        }
+        cout << "\t" << (precision == GEMM_DOUBLE ? "double " : "float ") << gemmKernelName(kernels[k]) << ": "
+             << report.kernelMs << " ms, " << report.gflops << " GFLOP/s, max relative error " << maxError << endl;
+    }
+
+    freeHostBuffer(A);
+    freeHostBuffer(B);
+    freeHostBuffer(expected);
+    freeHostBuffer(C);
+    clReleaseMemObject(bufferA);
+    clReleaseMemObject(bufferB);
+    clReleaseMemObject(bufferC);
+}
+
+void demoGemm(const DemoDevice &demo, size_t n, unsigned hostThreads)
+{
+    GemmEngine engine;
+    gemmCreate(&engine, demo.library, demo.queue);
+    HostEngine pool;
+    hostEngineCreate(&pool, hostThreads, SIMD_AVX512);
+    cout << endl << "GEMM of " << n << " x " << n << " matrices (tiled: work-groups of " << engine.tiling[GEMM_FLOAT].side
+         << " x " << engine.tiling[GEMM_FLOAT].side << ", tiles " << engine.tiling[GEMM_FLOAT].tileK << " deep):" << endl;
+    demoGemmPrecision<float>(demo, &engine, &pool, GEMM_FLOAT, n);
+    if (engine.doubles) demoGemmPrecision<double>(demo, &engine, &pool, GEMM_DOUBLE, n);
+    else cout << "\t" << "double: the device doesn't support cl_khr_fp64" << endl;
+    hostEngineRelease(&pool);
+}
+
+void demoStencil(const DemoDevice &demo, const int *input, size_t numberOfElements, size_t filterRadius)
+{
+    size_t width = (size_t) sqrt((double) numberOfElements);
+    size_t height = numberOfElements / width;
+    size_t elements = width * height;
+    size_t bufferSize = elements * sizeof(float);
+    int radius = (int) filterRadius;
+    float *grid = (float*) allocateHostBuffer(bufferSize);
+    float *expected = (float*) allocateHostBuffer(bufferSize);
+    float *result = (float*) allocateHostBuffer(bufferSize);
+    for (size_t i = 0; i < elements; i++) grid[i] = (float) (input[i] % 256);
+
+    // binomial weights, normalized: the 2D filter is their outer product
+    vector<float> weights(2 * radius + 1, 0);
+    weights[0] = 1;
+    for (int k = 1; k <= 2 * radius; k++)
+        for (int j = k; j > 0; j--) weights[j] += weights[j - 1];
+    float total = 0;
+    for (size_t k = 0; k < weights.size(); k++) total += weights[k];
+    for (size_t k = 0; k < weights.size(); k++) weights[k] /= total;
+
+    StencilFilter square, separable;
+    square.radiusX = square.radiusY = separable.radiusX = separable.radiusY = radius;
+    square.separable = false;
+    separable.separable = true;
+    for (size_t y = 0; y < weights.size(); y++)
+        for (size_t x = 0; x < weights.size(); x++) square.coefficients.push_back(weights[y] * weights[x]);
+    separable.coefficients = weights;
+    separable.coefficients.insert(separable.coefficients.end(), weights.begin(), weights.end());
+
+    double hostStart = wallClockMs();
+    for (size_t y = 0; y < height; y++)
+        for (size_t x = 0; x < width; x++)
+        {
+            float sum = 0;
+            const float *coefficient = &square.coefficients[0];
+            for (int dy = -radius; dy <= radius; dy++)
+            {
+                size_t row = (size_t) min(max((int) y + dy, 0), (int) height - 1) * width;
+                for (int dx = -radius; dx <= radius; dx++)
+                    sum += *coefficient++ * grid[row + min(max((int) x + dx, 0), (int) width - 1)];
+            }
+            expected[y * width + x] = sum;
+        }
+    double hostMs = wallClockMs() - hostStart;
+
+    cl_mem inputBuffer = createBuffer(demo, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, bufferSize, grid);
+    cl_mem outputBuffer = createBuffer(demo, CL_MEM_READ_WRITE, bufferSize, NULL);
+
+    StencilEngine engine;
+    stencilCreate(&engine, demo.library, demo.queue);
+    cout << endl << "Stencil of a " << width << " x " << height << " grid, radius " << radius << " (work-groups of "
+         << engine.side << " x " << engine.side << ", images " << (engine.images ? "supported" : "not supported")
+         << ", host " << hostMs << " ms):" << endl;
+    const StencilFilter *filters[] = {&square, &separable};
+    for (int f = 0; f < 2; f++)
+    {
+        if (!stencilFilterFits(&engine, *filters[f]))
+        {
+            cout << "\t" << (f == 0 ? "non-separable" : "separable") << ": the filter doesn't fit the __constant memory" << endl;
+            continue;
+        }
+        for (int run = 0; run < 2; run++)
+        {
+            StencilReport report = stencilApply(&engine, STENCIL_AUTO, *filters[f], inputBuffer, outputBuffer, width,
+                                                height, demo.profiler);
+            readOutput(demo, outputBuffer, bufferSize, result);
+            double maxError = 0;
+            for (size_t i = 0; i < elements; i++) maxError = max(maxError, (double) fabs(result[i] - expected[i]));
+            cout << "\t" << (f == 0 ? "non-separable" : "separable") << " " << stencilPathName(report.path) << ": "
+                 << report.kernelMs << " ms, " << report.gbPerSecond << " GB/s";
+            if (report.measured) cout << " (measured: local " << report.localMs << " ms, image " << report.imageMs << " ms)";
+            cout << ", max error " << maxError << endl;
+        }
+    }
+
+    stencilRelease(&engine);
+    freeHostBuffer(grid);
+    freeHostBuffer(expected);
+    freeHostBuffer(result);
+    clReleaseMemObject(inputBuffer);
+    clReleaseMemObject(outputBuffer);
+}
+
+void demoTranspose(const DemoDevice &demo, const int *input, size_t numberOfElements, size_t components)
+{
+    size_t columns = numberOfElements < 1000 ? numberOfElements : 1000;
+    size_t rows = numberOfElements / columns;
+    size_t count = numberOfElements / components;
+    size_t bufferSize = numberOfElements * sizeof(int);
+    cl_mem inputBuffer = createBuffer(demo, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, bufferSize, input);
+    cl_mem outputBuffer = createBuffer(demo, CL_MEM_READ_WRITE, bufferSize, NULL);
+    cl_mem backBuffer = createBuffer(demo, CL_MEM_READ_WRITE, bufferSize, NULL);
+    int *result = (int*) allocateHostBuffer(bufferSize);
+
+    TransposeEngine engine;
+    transposeCreate(&engine, demo.library, demo.queue);
+    cout << endl << "Layout changes (tiles of " << engine.side << " x " << engine.side << ", " << engine.rows
+         << " rows of work-items):" << endl;
+
+    TransposeReport copy = transposeCopyBaseline(&engine, inputBuffer, outputBuffer, rows * columns * sizeof(int),
+                                                 demo.profiler);
+    cout << "\t" << "copy buffer:        " << copy.kernelMs << " ms, " << copy.gbPerSecond << " GB/s" << endl;
+
+    TransposeReport report = transposeMatrix(&engine, inputBuffer, outputBuffer, rows, columns, demo.profiler);
+    readOutput(demo, outputBuffer, rows * columns * sizeof(int), result);
+    size_t mismatches = 0;
+    for (size_t r = 0; r < rows; r++)
+        for (size_t c = 0; c < columns; c++) if (result[c * rows + r] != input[r * columns + c]) mismatches++;
+    cout << "\t" << "transpose " << rows << " x " << columns << ": " << report.kernelMs << " ms, " << report.gbPerSecond
+         << " GB/s (" << 100 * report.gbPerSecond / copy.gbPerSecond << "% of the copy), " << mismatches
+         << " mismatching elements" << endl;
+
+    // records of components elements to arrays, and back
+    report = layoutDeinterleave(&engine, inputBuffer, outputBuffer, count, components, demo.profiler);
+    readOutput(demo, outputBuffer, count * components * sizeof(int), result);
+    mismatches = 0;
+    for (size_t i = 0; i < count; i++)
+        for (size_t c = 0; c < components; c++) if (result[c * count + i] != input[i * components + c]) mismatches++;
+    cout << "\t" << "deinterleave " << count << " x " << components << " (" << report.kernel << "): " << report.kernelMs
+         << " ms, " << report.gbPerSecond << " GB/s, " << mismatches << " mismatching elements" << endl;
+
+    report = layoutInterleave(&engine, outputBuffer, backBuffer, count, components, demo.profiler);
+    readOutput(demo, backBuffer, count * components * sizeof(int), result);
+    mismatches = 0;
+    for (size_t i = 0; i < count * components; i++) if (result[i] != input[i]) mismatches++;
+    cout << "\t" << "interleave " << count << " x " << components << " (" << report.kernel << "): " << report.kernelMs
+         << " ms, " << report.gbPerSecond << " GB/s, " << mismatches << " mismatching elements" << endl;
+
+    freeHostBuffer(result);
+    clReleaseMemObject(inputBuffer);
+    clReleaseMemObject(outputBuffer);
+    clReleaseMemObject(backBuffer);
+}
+
+void demoCompact(const DemoDevice &demo, const int *input, size_t numberOfElements, size_t percent, cl_int operand)
+{
+    cl_int clErr;
+    size_t bufferSize = numberOfElements * sizeof(int);
+    CompactPredicate predicate;
+    predicate.operand = operand;
+    predicate.low = operand;
+    predicate.high = operand + (cl_int) (percent * 65536 / 100) - 1;
+
+    // uniform values in [0, 65535]
+    int *values = (int*) allocateHostBuffer(bufferSize);
+    int *result = (int*) allocateHostBuffer(bufferSize);
+    for (size_t i = 0; i < numberOfElements; i++)
+    {
+        cl_uint hash = ((cl_uint) input[i] ^ (cl_uint) i) * 2654435761u;
+        values[i] = (int) (hash >> 16);
+    }
+    vector<int> expected;
+    for (size_t i = 0; i < numberOfElements; i++)
+    {
+        int value = values[i] + predicate.operand;
+        if (value >= predicate.low && value <= predicate.high) expected.push_back(value);
+    }
+
+    cl_mem valueBuffer = writeInput(demo, bufferSize, values, "compact: write values");
+    cl_mem outputBuffer = createBuffer(demo, CL_MEM_READ_WRITE, bufferSize, NULL);
+
+    // the baseline: the whole output of zeroValues crosses the bus, and the host filters it
+    double baselineStart = wallClockMs();
+    cl_int imax = (cl_int) numberOfElements;
+    cl_kernel kernel = kernelLibraryGet(demo.library, "zeroValues");
+    clErr  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &valueBuffer);
+    clErr |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &outputBuffer);
+    clErr |= clSetKernelArg(kernel, 2, sizeof(cl_int), &imax);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    LaunchGeometry geometry = defaultGeometry(demo.device, kernel, numberOfElements);
+    cl_event event;
+    clErr = clEnqueueNDRangeKernel(demo.queue, kernel, 1, NULL, &geometry.globalSize, &geometry.localSize, 0, NULL,
+                                   &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    profilerAddStage(demo.profiler, "compact: zeroValues", event, 0, numberOfElements);
+    readOutput(demo, outputBuffer, bufferSize, result);
+    size_t kept = 0;
+    for (size_t i = 0; i < numberOfElements; i++)
+        if (result[i] >= predicate.low && result[i] <= predicate.high) result[kept++] = result[i];
+    double baselineMs = wallClockMs() - baselineStart;
+
+    CompactEngine engine;
+    compactCreate(&engine, demo.library, demo.queue);
+    cout << endl << "Compaction of " << numberOfElements << " values, " << expected.size() << " kept (blocks of "
+         << engine.blockElements << ", work-groups of " << engine.localSize << "):" << endl;
+    cout << "\t" << "zeroValues, host filter: " << baselineMs << " ms, " << bufferSize << " bytes read back, "
+         << (kept == expected.size() ? "ok" : "mismatch") << endl;
+    CompactOrder orders[] = {COMPACT_UNORDERED, COMPACT_STABLE};
+    for (int o = 0; o < 2; o++)
+    {
+        double start = wallClockMs();
+        CompactReport report = compactBuffer(&engine, orders[o], predicate, valueBuffer, outputBuffer, numberOfElements,
+                                             demo.profiler);
+        if (report.count > 0) readOutput(demo, outputBuffer, report.count * sizeof(int), result);
+        double wallMs = wallClockMs() - start;
+
+        // the unordered compaction only has to keep the same values
+        size_t mismatches = report.count == expected.size() ? 0 : 1;
+        if (mismatches == 0 && orders[o] == COMPACT_UNORDERED) sort(result, result + report.count);
+        vector<int> reference(expected);
+        if (mismatches == 0 && orders[o] == COMPACT_UNORDERED) sort(reference.begin(), reference.end());
+        for (size_t i = 0; mismatches == 0 && i < report.count; i++) if (result[i] != reference[i]) mismatches++;
+        cout << "\t" << compactOrderName(report.order) << ": " << wallMs << " ms (kernels " << report.kernelMs << " ms, "
+             << report.gbPerSecond << " GB/s, " << report.kernels << " kernel(s)), "
+             << (report.count + 1) * sizeof(int) << " bytes read back, " << (mismatches == 0 ? "ok" : "mismatch") << endl;
+    }
+
+    compactRelease(&engine);
+    freeHostBuffer(values);
+    freeHostBuffer(result);
+    clReleaseMemObject(valueBuffer);
+    clReleaseMemObject(outputBuffer);
+}
@@ -0,0 +1,131 @@
+/**
+    Demos of the device engines (reduction, scan, radix sort, histogram, GEMM, stencil, layout changes and
+    compaction), run by the driver after its job on the same device. Each one derives its data from the input of the
+    job, runs its engine, checks the result against the host and prints the timings. They need the whole input on
+    the device, so the driver skips them for a streamed job (GEMM excepted, which makes its own matrices).
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLENGINEDEMOS_H
+#define OPENCLENGINEDEMOS_H
+
+#include <cstddef>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+#include "1-openClReduction.h"
+#include "1-openClScan.h"
+#include "1-openClRadixSort.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+/**
+    Device the demos run on, and the profiler recording their transfers and kernels.
+*/
+struct DemoDevice
+{
+    cl_context          context;
+    cl_device_id        device;
+    cl_command_queue    queue;
+    KernelLibrary       *library;
+    Profiler            *profiler;
+};
+
+/**
+    demoReductions runs the job again into a device buffer that is only reduced (see 1-openClReduction.h): every
+    operation asked for reads back one scalar. The same operations then run on a float copy of the output, and every
+    result is checked against a host reduction of the output of the job.
+    @param      demo            device of the demo
+    @param      kernel          zeroValues variant of the job
+    @param      width           vector width of the variant (1, 4, 8 or 16)
+    @param      tuningFile      tuning file of the auto-tuner, or NULL
+    @param      tuneMode        0: default geometry, 1: stored or tuned once, 2: always tune again
+    @param      input           input of the job
+    @param      output          output of the job, as read back by the driver
+    @param      numberOfElements    elements of input and output
+    @param      operations      reductions to run (bit 1 << ReduceOperation)
+*/
+void demoReductions(const DemoDevice &demo, cl_kernel kernel, cl_uint width, const char *tuningFile, int tuneMode,
+                    const int *input, const int *output, size_t numberOfElements, int operations);
+
+/**
+    demoScan scans the input (see 1-openClScan.h) with every algorithm the device can run, checked against a host
+    scan.
+    @param      demo            device of the demo
+    @param      input           values to scan
+    @param      numberOfElements    elements of input
+    @param      kind            SCAN_EXCLUSIVE or SCAN_INCLUSIVE
+*/
+void demoScan(const DemoDevice &demo, const int *input, size_t numberOfElements, ScanKind kind);
+
+/**
+    demoRadixSort sorts keys derived from the input (see 1-openClRadixSort.h), with many duplicates, and their
+    indices as payloads. Checked against std::sort of (key, index) pairs, which gives the order a stable sort must
+    give, and timed against std::sort of the keys alone.
+    @param      demo            device of the demo
+    @param      input           values the keys are derived from
+    @param      numberOfElements    elements of input
+    @param      keyType         RADIX_INT, RADIX_UINT or RADIX_FLOAT
+*/
+void demoRadixSort(const DemoDevice &demo, const int *input, size_t numberOfElements, RadixKeyType keyType);
+
+/**
+    demoHistogram counts values derived from the input (see 1-openClHistogram.h), skewed towards the low bins so the
+    atomics contend, with the privatized strategy and the global fallback. Checked against a host histogram.
+    @param      demo            device of the demo
+    @param      input           values the histogram values are derived from
+    @param      numberOfElements    elements of input
+    @param      bins            bins of the histogram
+*/
+void demoHistogram(const DemoDevice &demo, const int *input, size_t numberOfElements, size_t bins);
+
+/**
+    demoGemm multiplies square matrices (see 1-openClGemm.h), naive and tiled, in float and (with cl_khr_fp64) in
+    double, against the blocked multithreaded host version.
+    @param      demo            device of the demo
+    @param      n               rows and columns of the matrices
+    @param      hostThreads     threads of the host version (0: one per hardware thread)
+*/
+void demoGemm(const DemoDevice &demo, size_t n, unsigned hostThreads);
+
+/**
+    demoStencil convolves a grid made of the input (see 1-openClStencil.h) with a binomial filter, as one
+    non-separable filter and as a row and a column filter. Each is run twice with automatic selection (the first run
+    measures both paths, the second reuses the choice), and checked against the host.
+    @param      demo            device of the demo
+    @param      input           values of the grid
+    @param      numberOfElements    elements of input (the grid is the biggest near-square that fits)
+    @param      filterRadius    radius of the filters
+*/
+void demoStencil(const DemoDevice &demo, const int *input, size_t numberOfElements, size_t filterRadius);
+
+/**
+    demoTranspose changes the layout of the input (see 1-openClTranspose.h): the transpose of a matrix whose sides
+    aren't multiples of the tile, and the deinterleave and interleave of records, each checked against the host and
+    compared with a clEnqueueCopyBuffer of the same size.
+    @param      demo            device of the demo
+    @param      input           values to move
+    @param      numberOfElements    elements of input
+    @param      components      components of the records
+*/
+void demoTranspose(const DemoDevice &demo, const int *input, size_t numberOfElements, size_t components);
+
+/**
+    demoCompact runs zeroValues on values derived from the input, then keeps only the results within a range (see
+    1-openClCompact.h). Unordered and stable compactions are checked against the host, and timed against zeroValues
+    with the whole output read back and filtered on the host.
+    @param      demo            device of the demo
+    @param      input           values the compacted values are derived from
+    @param      numberOfElements    elements of input
+    @param      percent         share of the values kept
+    @param      operand         value added by zeroValues (ZV_OPERAND in zeroValuesKernel.cl)
+*/
+void demoCompact(const DemoDevice &demo, const int *input, size_t numberOfElements, size_t percent, cl_int operand);
+
+#endif
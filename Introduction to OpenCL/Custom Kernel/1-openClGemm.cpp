@@ -0,0 +1,204 @@
+/**
+    GEMM engine. See 1-openClGemm.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include "1-openClGemm.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+// kernels of gemmKernel.cl, per kernel and precision
+static const char *gemmKernels[2][2] = {
+    {"gemmNaiveFloat", "gemmNaiveDouble"},
+    {"gemmTiledFloat", "gemmTiledDouble"}
+};
+
+const char *gemmKernelName(GemmKernel kernel)
+{
+    switch (kernel) {
+        case GEMM_NAIVE:    return "naive";
+        case GEMM_TILED:    return "tiled";
+    }
+    return "unknown";
+}
+
+// biggest square work-group (side a power of two, at most GEMM_MAX_SIDE) of a kernel
+static size_t squareSide(cl_kernel kernel, cl_device_id device, const DeviceCapabilities &caps)
+{
+    size_t limit;
+    cl_int clErr = clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &limit, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    if (caps.maxWorkGroupSize > 0 && caps.maxWorkGroupSize < limit) limit = caps.maxWorkGroupSize;
+    size_t side = 1;
+    while (side * 2 <= GEMM_MAX_SIDE && side * 2 * side * 2 <= limit &&
+           (caps.maxWorkItemSizes.size() < 2 ||
+            (side * 2 <= caps.maxWorkItemSizes[0] && side * 2 <= caps.maxWorkItemSizes[1])))
+        side *= 2;
+    return side;
+}
+
+// tiles of A and B as big as the __local memory allows: shallower tiles first, then smaller work-groups
+static GemmTiling chooseTiling(cl_kernel kernel, cl_device_id device, const DeviceCapabilities &caps, size_t elementSize)
+{
+    GemmTiling tiling = {squareSide(kernel, device, caps), GEMM_MAX_TILE_K};
+    while (2 * GEMM_BLOCK * tiling.side * tiling.tileK * elementSize > caps.localMemSize)
+    {
+        if (tiling.tileK > GEMM_BLOCK) tiling.tileK /= 2;
+        else if (tiling.side > 1) { tiling.side /= 2; tiling.tileK = GEMM_MAX_TILE_K; }
+        else break;
+    }
+    return tiling;
+}
+
+void gemmCreate(GemmEngine *engine, KernelLibrary *library, cl_command_queue queue)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(library->device);
+    engine->library = library;
+    engine->queue = queue;
+    engine->doubles = hasExtension(caps, "cl_khr_fp64");
+    engine->tiling[GEMM_FLOAT] = chooseTiling(kernelLibraryGet(library, "gemmTiledFloat"), library->device, caps,
+                                              sizeof(cl_float));
+    engine->tiling[GEMM_DOUBLE] = engine->tiling[GEMM_FLOAT];
+    if (engine->doubles)
+        engine->tiling[GEMM_DOUBLE] = chooseTiling(kernelLibraryGet(library, "gemmTiledDouble"), library->device, caps,
+                                                   sizeof(cl_double));
+}
+
+GemmReport gemmRun(GemmEngine *engine, GemmKernel kernel, GemmPrecision precision, size_t M, size_t N, size_t K,
+                   double alpha, cl_mem A, cl_mem B, double beta, cl_mem C, Profiler *profiler)
+{
+    cl_int clErr;
+    GemmReport report = {0, 0};
+    if (precision == GEMM_DOUBLE && !engine->doubles)
+    {
+        cout << "GEMM Error: the device doesn't support cl_khr_fp64" << endl;
+        exit(EXIT_FAILURE);
+    }
+    cl_device_id device = engine->library->device;
+    cl_kernel gemm = kernelLibraryGet(engine->library, gemmKernels[kernel][precision]);
+    size_t elementSize = precision == GEMM_DOUBLE ? sizeof(cl_double) : sizeof(cl_float);
+    cl_int m = (cl_int) M, n = (cl_int) N, k = (cl_int) K;
+    cl_float alphaFloat = (cl_float) alpha, betaFloat = (cl_float) beta;
+    cl_double alphaDouble = alpha, betaDouble = beta;
+    void *alphaArg = precision == GEMM_DOUBLE ? (void*) &alphaDouble : (void*) &alphaFloat;
+    void *betaArg = precision == GEMM_DOUBLE ? (void*) &betaDouble : (void*) &betaFloat;
+
+    clErr  = clSetKernelArg(gemm, 0, sizeof(cl_int), &m);
+    clErr |= clSetKernelArg(gemm, 1, sizeof(cl_int), &n);
+    clErr |= clSetKernelArg(gemm, 2, sizeof(cl_int), &k);
+    clErr |= clSetKernelArg(gemm, 3, elementSize, alphaArg);
+    clErr |= clSetKernelArg(gemm, 4, sizeof(cl_mem), &A);
+    clErr |= clSetKernelArg(gemm, 5, sizeof(cl_mem), &B);
+    clErr |= clSetKernelArg(gemm, 6, elementSize, betaArg);
+    clErr |= clSetKernelArg(gemm, 7, sizeof(cl_mem), &C);
+
+    // dimension 0 along the columns of C, dimension 1 along its rows
+    size_t local[2], global[2];
+    if (kernel == GEMM_TILED)
+    {
+        const GemmTiling &tiling = engine->tiling[precision];
+        cl_int tileK = (cl_int) tiling.tileK;
+        size_t tileSide = GEMM_BLOCK * tiling.side;
+        clErr |= clSetKernelArg(gemm, 8, sizeof(cl_int), &tileK);
+        clErr |= clSetKernelArg(gemm, 9, tileSide * tiling.tileK * elementSize, NULL);
+        clErr |= clSetKernelArg(gemm, 10, tileSide * tiling.tileK * elementSize, NULL);
+        local[0] = local[1] = tiling.side;
+        global[0] = (N + tileSide - 1) / tileSide * tiling.side;
+        global[1] = (M + tileSide - 1) / tileSide * tiling.side;
+    }
+    else
+    {
+        local[0] = local[1] = squareSide(gemm, device, deviceCapabilities(device));
+        global[0] = (N + local[0] - 1) / local[0] * local[0];
+        global[1] = (M + local[1] - 1) / local[1] * local[1];
+    }
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    cl_event event;
+    clErr = clEnqueueNDRangeKernel(engine->queue, gemm, 2, NULL, global, local, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    clErr = clFinish(engine->queue);
+    if (clErr != CL_SUCCESS) { cout << "clFinish Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    double ms = eventMilliseconds(event);
+    if (ms > 0) report.kernelMs = ms;
+    string stage = string(precision == GEMM_DOUBLE ? "dgemm " : "sgemm ") + gemmKernelName(kernel);
+    if (profiler != NULL) profilerAddStage(profiler, stage.c_str(), event, 0, M * N);
+    else clReleaseEvent(event);
+    if (report.kernelMs > 0) report.gflops = 2.0 * M * N * K / (report.kernelMs * 1e6);
+    return report;
+}
+
+/**
+    Arguments of gemmHost, shared by every thread.
+*/
+template <typename T>
+struct GemmHostTask
+{
+    size_t      M, N, K;
+    T           alpha, beta;
+    const T     *A, *B;
+    T           *C;
+};
+
+// the blocks of GEMM_HOST_BLOCK rows of C go round-robin to the threads; the inner loop runs along rows of B and C
+template <typename T>
+static void gemmHostRows(void *argument, unsigned worker, unsigned numThreads)
+{
+    GemmHostTask<T> *task = (GemmHostTask<T>*) argument;
+    size_t M = task->M, N = task->N, K = task->K;
+    for (size_t i0 = (size_t) worker * GEMM_HOST_BLOCK; i0 < M; i0 += (size_t) numThreads * GEMM_HOST_BLOCK)
+    {
+        size_t i1 = i0 + GEMM_HOST_BLOCK < M ? i0 + GEMM_HOST_BLOCK : M;
+        for (size_t i = i0; i < i1; i++)
+            for (size_t j = 0; j < N; j++)
+                task->C[i * N + j] = task->beta != 0 ? task->beta * task->C[i * N + j] : 0;
+        for (size_t k0 = 0; k0 < K; k0 += GEMM_HOST_BLOCK)
+        {
+            size_t k1 = k0 + GEMM_HOST_BLOCK < K ? k0 + GEMM_HOST_BLOCK : K;
+            for (size_t j0 = 0; j0 < N; j0 += GEMM_HOST_BLOCK)
+            {
+                size_t j1 = j0 + GEMM_HOST_BLOCK < N ? j0 + GEMM_HOST_BLOCK : N;
+                for (size_t i = i0; i < i1; i++)
+                {
+                    T *c = task->C + i * N;
+                    for (size_t k = k0; k < k1; k++)
+                    {
+                        T a = task->alpha * task->A[i * K + k];
+                        const T *b = task->B + k * N;
+                        for (size_t j = j0; j < j1; j++) c[j] += a * b[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+static double gemmHostRun(HostEngine *pool, size_t M, size_t N, size_t K, T alpha, const T *A, const T *B, T beta, T *C)
+{
+    double start = wallClockMs();
+    GemmHostTask<T> task = {M, N, K, alpha, beta, A, B, C};
+    hostEngineParallel(pool, gemmHostRows<T>, &task);
+    return wallClockMs() - start;
+}
+
+double gemmHost(HostEngine *pool, size_t M, size_t N, size_t K, float alpha, const float *A, const float *B,
+                float beta, float *C)
+{
+    return gemmHostRun<float>(pool, M, N, K, alpha, A, B, beta, C);
+}
+
+double gemmHost(HostEngine *pool, size_t M, size_t N, size_t K, double alpha, const double *A, const double *B,
+                double beta, double *C)
+{
+    return gemmHostRun<double>(pool, M, N, K, alpha, A, B, beta, C);
+}
@@ -0,0 +1,132 @@
+/**
+    GEMM engine (gemmKernel.cl): C = alpha * A * B + beta * C for dense row-major matrices in float (SGEMM) and, on
+    devices with cl_khr_fp64, in double (DGEMM). There are two kernels:
+
+    - naive: one work-item per element of C, every operand read from global memory. Kept as the reference the tiled
+      kernel is measured against.
+    - tiled: the tiles of A and B are staged in __local memory with vector loads, and every work-item accumulates a
+      4 x 4 block of C in registers, so each element loaded from __local memory is used 4 times. The work-group is
+      the biggest square (16 x 16 at most) the device and the kernel allow, and the depth of the tiles (tileK) the
+      biggest power of two whose tiles fit CL_DEVICE_LOCAL_MEM_SIZE, separately for each precision.
+
+    gemmHost is the baseline on the CPU: blocked for the caches, and split between the threads of a host engine
+    (see 1-openClHostEngine.h).
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLGEMM_H
+#define OPENCLGEMM_H
+
+#include <cstddef>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+#include "1-openClHostEngine.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define GEMM_BLOCK              4       // as in gemmKernel.cl: rows and columns of C per work-item of the tiled kernel
+#define GEMM_MAX_SIDE           16      // biggest side of the work-group of the tiled kernel
+#define GEMM_MAX_TILE_K         32      // deepest tiles of the tiled kernel
+#define GEMM_HOST_BLOCK         64      // rows, columns and depth of the blocks of gemmHost
+
+enum GemmPrecision
+{
+    GEMM_FLOAT,
+    GEMM_DOUBLE             // needs cl_khr_fp64
+};
+
+enum GemmKernel
+{
+    GEMM_NAIVE,
+    GEMM_TILED
+};
+
+/**
+    Work-group and tile depth of the tiled kernel, for one precision.
+*/
+struct GemmTiling
+{
+    size_t      side;           // the work-group is side x side work-items, the tile of C 4 * side x 4 * side
+    size_t      tileK;          // columns of A (rows of B) staged at a time
+};
+
+/**
+    Kernels of one device, and the tiling of each precision.
+*/
+struct GemmEngine
+{
+    KernelLibrary       *library;
+    cl_command_queue    queue;
+    bool                doubles;            // the device has cl_khr_fp64
+    GemmTiling          tiling[2];          // per GemmPrecision
+};
+
+/**
+    Cost of one multiplication.
+*/
+struct GemmReport
+{
+    double      kernelMs;       // device time of the kernel
+    double      gflops;         // 2 * M * N * K floating point operations, over kernelMs
+};
+
+/**
+    gemmCreate picks the tiling of each precision from the limits of the device.
+    @param      engine          engine to be created
+    @param      library         kernel library of the device, with gemmKernel.cl built in
+    @param      queue           command queue of the device, created with CL_QUEUE_PROFILING_ENABLE
+*/
+void gemmCreate(GemmEngine *engine, KernelLibrary *library, cl_command_queue queue);
+
+/**
+    gemmRun multiplies two device matrices, and waits for the result.
+    @param      engine          engine created by gemmCreate
+    @param      kernel          GEMM_NAIVE or GEMM_TILED
+    @param      precision       GEMM_FLOAT, or GEMM_DOUBLE when engine->doubles
+    @param      M               rows of A and C
+    @param      N               columns of B and C
+    @param      K               columns of A, rows of B
+    @param      alpha           factor of A * B
+    @param      A               M x K matrix
+    @param      B               K x N matrix
+    @param      beta            factor of C (C isn't read when beta is 0)
+    @param      C               M x N matrix, overwritten with the result
+    @param      profiler        profiler recording the kernel (may be NULL)
+    @return     report          device time and GFLOP/s
+*/
+GemmReport gemmRun(GemmEngine *engine, GemmKernel kernel, GemmPrecision precision, size_t M, size_t N, size_t K,
+                   double alpha, cl_mem A, cl_mem B, double beta, cl_mem C, Profiler *profiler);
+
+/**
+    gemmHost multiplies two host matrices on the threads of a host engine, one block of rows of C at a time.
+    @param      pool            host engine created by hostEngineCreate
+    @param      M               rows of A and C
+    @param      N               columns of B and C
+    @param      K               columns of A, rows of B
+    @param      alpha           factor of A * B
+    @param      A               M x K matrix
+    @param      B               K x N matrix
+    @param      beta            factor of C (C isn't read when beta is 0)
+    @param      C               M x N matrix, overwritten with the result
+    @return     milliseconds    wall time of the multiplication
+*/
+double gemmHost(HostEngine *pool, size_t M, size_t N, size_t K, float alpha, const float *A, const float *B,
+                float beta, float *C);
+double gemmHost(HostEngine *pool, size_t M, size_t N, size_t K, double alpha, const double *A, const double *B,
+                double beta, double *C);
+
+/**
+    gemmKernelName gives the name of a kernel.
+    @param      kernel          kernel
+    @return     name            "naive" or "tiled"
+*/
+const char *gemmKernelName(GemmKernel kernel);
+
+#endif
@@ -0,0 +1,172 @@
+/**
+    Histogram engine. See 1-openClHistogram.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "1-openClHistogram.h"
+#include "1-openClAutoTuner.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+const char *histogramStrategyName(HistogramStrategy strategy)
+{
+    switch (strategy) {
+        case HISTOGRAM_AUTO:        return "auto";
+        case HISTOGRAM_PRIVATIZED:  return "privatized";
+        case HISTOGRAM_GLOBAL:      return "global";
+    }
+    return "unknown";
+}
+
+void histogramCreate(HistogramEngine *engine, KernelLibrary *library, cl_command_queue queue)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(library->device);
+    engine->library = library;
+    engine->queue = queue;
+    engine->maxGroups = (caps.computeUnits > 0 ? caps.computeUnits : 1) * HISTOGRAM_GROUPS_PER_CU;
+    engine->localMemSize = caps.localMemSize;
+    engine->partials = NULL;
+    engine->partialCapacity = 0;
+
+    // biggest power of two the kernel can run with, and the width of the hardware's wavefronts (warps)
+    cl_kernel kernel = kernelLibraryGet(library, "histogramLocal");
+    size_t limit, multiple;
+    cl_int clErr  = clGetKernelWorkGroupInfo(kernel, library->device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t),
+                                             &limit, NULL);
+    clErr |= clGetKernelWorkGroupInfo(kernel, library->device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+                                      sizeof(size_t), &multiple, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    engine->localSize = 1;
+    while (engine->localSize * 2 <= limit && engine->localSize * 2 <= HISTOGRAM_LOCAL_SIZE) engine->localSize *= 2;
+    engine->wavefront = multiple > 0 && multiple <= engine->localSize ? multiple : engine->localSize;
+}
+
+size_t histogramReplicas(const HistogramEngine *engine, size_t bins)
+{
+    size_t wavefronts = engine->localSize / engine->wavefront;
+    if (bins * sizeof(cl_uint) > engine->localMemSize) return 0;
+    size_t replicas = 1;
+    while (replicas * 2 <= wavefronts && replicas * 2 <= HISTOGRAM_MAX_REPLICAS &&
+           replicas * 2 * bins * sizeof(cl_uint) <= engine->localMemSize)
+        replicas *= 2;
+    return replicas;
+}
+
+static void launch(HistogramEngine *engine, cl_kernel kernel, size_t globalSize, size_t localSize,
+                   vector<cl_event> *events)
+{
+    cl_event event;
+    cl_int clErr = clEnqueueNDRangeKernel(engine->queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    events->push_back(event);
+}
+
+HistogramReport histogramBuffer(HistogramEngine *engine, HistogramStrategy strategy, cl_mem values,
+                                size_t numberOfElements, cl_int low, cl_int high, size_t bins, cl_mem histogram,
+                                Profiler *profiler)
+{
+    cl_int clErr;
+    HistogramReport report = {HISTOGRAM_GLOBAL, 0, 0, 0, 0, 0};
+    if (bins == 0) return report;
+    if (strategy != HISTOGRAM_GLOBAL) report.replicas = histogramReplicas(engine, bins);
+    if (report.replicas > 0) report.strategy = HISTOGRAM_PRIVATIZED;
+
+    cl_device_id device = engine->library->device;
+    cl_int n = (cl_int) numberOfElements;
+    cl_long lowValue = low;
+    cl_long span = (cl_long) high - low + 1;
+    cl_int binCount = (cl_int) bins;
+    vector<cl_event> events;
+
+    if (report.strategy == HISTOGRAM_PRIVATIZED)
+    {
+        size_t local = engine->localSize;
+        size_t groups = (numberOfElements + local - 1) / local;
+        if (groups > engine->maxGroups) groups = engine->maxGroups;
+        if (groups == 0) groups = 1;
+        report.groups = groups;
+        if (engine->partialCapacity < groups * bins)
+        {
+            if (engine->partials != NULL) clReleaseMemObject(engine->partials);
+            engine->partials = clCreateBuffer(engine->library->context, CL_MEM_READ_WRITE, groups * bins * sizeof(cl_uint),
+                                              NULL, &clErr);
+            if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+            engine->partialCapacity = groups * bins;
+        }
+
+        cl_int replicas = (cl_int) report.replicas;
+        cl_int wavefront = (cl_int) engine->wavefront;
+        cl_kernel count = kernelLibraryGet(engine->library, "histogramLocal");
+        clErr  = clSetKernelArg(count, 0, sizeof(cl_mem), &values);
+        clErr |= clSetKernelArg(count, 1, sizeof(cl_int), &n);
+        clErr |= clSetKernelArg(count, 2, sizeof(cl_long), &lowValue);
+        clErr |= clSetKernelArg(count, 3, sizeof(cl_long), &span);
+        clErr |= clSetKernelArg(count, 4, sizeof(cl_int), &binCount);
+        clErr |= clSetKernelArg(count, 5, sizeof(cl_int), &replicas);
+        clErr |= clSetKernelArg(count, 6, sizeof(cl_int), &wavefront);
+        clErr |= clSetKernelArg(count, 7, sizeof(cl_mem), &engine->partials);
+        clErr |= clSetKernelArg(count, 8, report.replicas * bins * sizeof(cl_uint), NULL);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        launch(engine, count, groups * local, local, &events);
+
+        cl_int groupCount = (cl_int) groups;
+        cl_kernel merge = kernelLibraryGet(engine->library, "histogramMerge");
+        clErr  = clSetKernelArg(merge, 0, sizeof(cl_mem), &engine->partials);
+        clErr |= clSetKernelArg(merge, 1, sizeof(cl_int), &groupCount);
+        clErr |= clSetKernelArg(merge, 2, sizeof(cl_int), &binCount);
+        clErr |= clSetKernelArg(merge, 3, sizeof(cl_mem), &histogram);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        LaunchGeometry geometry = defaultGeometry(device, merge, bins);
+        launch(engine, merge, geometry.globalSize, geometry.localSize, &events);
+    }
+    else
+    {
+        // the bins don't fit the __local memory (or global memory was asked for): cleared, then counted in place
+        cl_event event;
+        cl_uint zero = 0;
+        clErr = clEnqueueFillBuffer(engine->queue, histogram, &zero, sizeof(cl_uint), 0, bins * sizeof(cl_uint), 0,
+                                    NULL, &event);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueFillBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        events.push_back(event);
+
+        cl_kernel count = kernelLibraryGet(engine->library, "histogramGlobal");
+        clErr  = clSetKernelArg(count, 0, sizeof(cl_mem), &values);
+        clErr |= clSetKernelArg(count, 1, sizeof(cl_int), &n);
+        clErr |= clSetKernelArg(count, 2, sizeof(cl_long), &lowValue);
+        clErr |= clSetKernelArg(count, 3, sizeof(cl_long), &span);
+        clErr |= clSetKernelArg(count, 4, sizeof(cl_int), &binCount);
+        clErr |= clSetKernelArg(count, 5, sizeof(cl_mem), &histogram);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        LaunchGeometry geometry = defaultGeometry(device, count, numberOfElements);
+        report.groups = geometry.globalSize / geometry.localSize;
+        launch(engine, count, geometry.globalSize, geometry.localSize, &events);
+    }
+    clErr = clFinish(engine->queue);
+    if (clErr != CL_SUCCESS) { cout << "clFinish Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    string stage = string("histogram (") + histogramStrategyName(report.strategy) + ")";
+    for (size_t e = 0; e < events.size(); e++)
+    {
+        double ms = eventMilliseconds(events[e]);
+        if (ms > 0) report.kernelMs += ms;
+        if (profiler != NULL) profilerAddStage(profiler, stage.c_str(), events[e], 0, numberOfElements);
+        else clReleaseEvent(events[e]);
+    }
+    report.kernels = events.size();
+    if (report.kernelMs > 0) report.gbPerSecond = numberOfElements * sizeof(cl_int) / (report.kernelMs * 1e6);
+    return report;
+}
+
+void histogramRelease(HistogramEngine *engine)
+{
+    if (engine->partials != NULL) clReleaseMemObject(engine->partials);
+}
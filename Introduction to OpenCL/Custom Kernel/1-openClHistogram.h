@@ -0,0 +1,116 @@
+/**
+    Histogram engine (histogramKernel.cl): count of the int values of a device buffer in any number of bins of equal
+    width over [low, high]. Values out of the range aren't counted.
+
+    A histogram straight in global memory makes every work-item contend on the atomics of the same few bins when the
+    values are skewed. The privatized strategy keeps the atomics in __local memory instead: each work-group counts
+    its share of the buffer in its own copy of the bins, replicated once per wavefront (so that only the work-items
+    of one wavefront contend on a bin), then a second kernel merges the histograms of the work-groups. The replicas
+    have to fit CL_DEVICE_LOCAL_MEM_SIZE: there are fewer of them as the bins grow, and when even one copy of the
+    bins doesn't fit, the engine falls back to atomics in global memory.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLHISTOGRAM_H
+#define OPENCLHISTOGRAM_H
+
+#include <cstddef>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define HISTOGRAM_LOCAL_SIZE        256     // biggest work-group size of the privatized strategy
+#define HISTOGRAM_GROUPS_PER_CU     4       // work-groups per compute unit of the privatized strategy
+#define HISTOGRAM_MAX_REPLICAS      16      // copies of the bins in __local memory, at most
+
+enum HistogramStrategy
+{
+    HISTOGRAM_AUTO,             // privatized when the bins fit the __local memory, global otherwise
+    HISTOGRAM_PRIVATIZED,       // __local sub-histograms, merged by a second kernel
+    HISTOGRAM_GLOBAL            // atomics on the histogram in global memory
+};
+
+/**
+    Kernels of one device, and the buffer of the partial histograms (grown on demand).
+*/
+struct HistogramEngine
+{
+    KernelLibrary       *library;
+    cl_command_queue    queue;
+    size_t              localSize;          // work-group size of the privatized strategy
+    size_t              wavefront;          // work-items sharing a replica (preferred work-group size multiple)
+    size_t              maxGroups;          // work-groups of the privatized strategy, at most
+    cl_ulong            localMemSize;       // CL_DEVICE_LOCAL_MEM_SIZE
+    cl_mem              partials;           // one histogram per work-group
+    size_t              partialCapacity;    // bins partials can hold
+};
+
+/**
+    Cost of one histogram.
+*/
+struct HistogramReport
+{
+    HistogramStrategy   strategy;       // strategy that ran (never HISTOGRAM_AUTO)
+    size_t              replicas;       // copies of the bins in the __local memory of each work-group (0: global)
+    size_t              groups;         // work-groups counting the values
+    size_t              kernels;        // commands enqueued (kernels, and the clearing of a global histogram)
+    double              kernelMs;       // device time of the commands
+    double              gbPerSecond;    // values read, over kernelMs
+};
+
+/**
+    histogramCreate picks the work-group size and the wavefront width of the device.
+    @param      engine          engine to be created
+    @param      library         kernel library of the device, with histogramKernel.cl built in
+    @param      queue           command queue of the device, created with CL_QUEUE_PROFILING_ENABLE
+*/
+void histogramCreate(HistogramEngine *engine, KernelLibrary *library, cl_command_queue queue);
+
+/**
+    histogramReplicas gives the copies of the bins each work-group of the privatized strategy keeps.
+    @param      engine          engine created by histogramCreate
+    @param      bins            bins of the histogram
+    @return     replicas        a power of two, or 0 if one copy of the bins doesn't fit the __local memory
+*/
+size_t histogramReplicas(const HistogramEngine *engine, size_t bins);
+
+/**
+    histogramBuffer counts the values of a device buffer into a histogram, and waits for the result.
+    @param      engine          engine created by histogramCreate
+    @param      strategy        strategy to use (HISTOGRAM_PRIVATIZED falls back to global memory when the bins
+                                don't fit the __local memory)
+    @param      values          ints to count
+    @param      numberOfElements    elements of values (at most 0x7fffffff)
+    @param      low             lowest value counted
+    @param      high            highest value counted
+    @param      bins            bins of the histogram, each (high - low + 1) / bins values wide
+    @param      histogram       one uint per bin, overwritten
+    @param      profiler        profiler recording every kernel (may be NULL)
+    @return     report          strategy, replicas and device time
+*/
+HistogramReport histogramBuffer(HistogramEngine *engine, HistogramStrategy strategy, cl_mem values,
+                                size_t numberOfElements, cl_int low, cl_int high, size_t bins, cl_mem histogram,
+                                Profiler *profiler);
+
+/**
+    histogramStrategyName gives the name of a strategy.
+    @param      strategy        strategy
+    @return     name            "auto", "privatized" or "global"
+*/
+const char *histogramStrategyName(HistogramStrategy strategy);
+
+/**
+    histogramRelease releases the buffers of the engine (the kernels belong to the library).
+    @param      engine          engine to be released
+*/
+void histogramRelease(HistogramEngine *engine);
+
+#endif
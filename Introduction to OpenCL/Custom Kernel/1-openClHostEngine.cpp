@@ -0,0 +1,216 @@
+/**
+    Native host engine for the zeroValues transform. See 1-openClHostEngine.h for the description of each function.
+
+    The SIMD loops are compiled with per-function target attributes, so the file builds without -mavx2/-mavx512f and
+    the widest one is only called after the CPU reported it.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include "1-openClHostEngine.h"
+#include "1-openClProfiler.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define HOST_ENGINE_X86
+    #include <immintrin.h>
+#elif defined(__aarch64__)
+    #define HOST_ENGINE_NEON
+    #include <arm_neon.h>
+#endif
+
+using namespace std;
+
+#define SLICE_ALIGNMENT     16          // slices start at multiples of 16 ints (one cache line)
+
+SimdLevel detectSimdLevel()
+{
+#if defined(HOST_ENGINE_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+    return SIMD_SCALAR;
+#elif defined(HOST_ENGINE_NEON)
+    return SIMD_NEON;                   // NEON is part of every ARM64 CPU
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+const char *simdLevelName(SimdLevel level)
+{
+    switch (level) {
+        case SIMD_SCALAR:   return "scalar";
+        case SIMD_NEON:     return "NEON";
+        case SIMD_SSE2:     return "SSE2";
+        case SIMD_AVX2:     return "AVX2";
+        case SIMD_AVX512:   return "AVX-512";
+    }
+    return "unknown";
+}
+
+static void zeroValuesScalar(const int *input, int *output, size_t count, int operand)
+{
+    for (size_t i = 0; i < count; i++) output[i] = input[i] + operand;
+}
+
+#if defined(HOST_ENGINE_X86)
+__attribute__((target("sse2")))
+static void zeroValuesSse2(const int *input, int *output, size_t count, int operand)
+{
+    __m128i add = _mm_set1_epi32(operand);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i*) (output + i), _mm_add_epi32(_mm_loadu_si128((const __m128i*) (input + i)), add));
+    zeroValuesScalar(input + i, output + i, count - i, operand);
+}
+
+__attribute__((target("avx2")))
+static void zeroValuesAvx2(const int *input, int *output, size_t count, int operand)
+{
+    __m256i add = _mm256_set1_epi32(operand);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_si256((__m256i*) (output + i), _mm256_add_epi32(_mm256_loadu_si256((const __m256i*) (input + i)), add));
+    zeroValuesScalar(input + i, output + i, count - i, operand);
+}
+
+__attribute__((target("avx512f")))
+static void zeroValuesAvx512(const int *input, int *output, size_t count, int operand)
+{
+    __m512i add = _mm512_set1_epi32(operand);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+        _mm512_storeu_si512((void*) (output + i), _mm512_add_epi32(_mm512_loadu_si512((const void*) (input + i)), add));
+    zeroValuesScalar(input + i, output + i, count - i, operand);
+}
+#endif
+
+#if defined(HOST_ENGINE_NEON)
+static void zeroValuesNeon(const int *input, int *output, size_t count, int operand)
+{
+    int32x4_t add = vdupq_n_s32(operand);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        vst1q_s32(output + i, vaddq_s32(vld1q_s32(input + i), add));
+    zeroValuesScalar(input + i, output + i, count - i, operand);
+}
+#endif
+
+void hostZeroValues(SimdLevel level, const int *input, int *output, size_t count, int operand)
+{
+    switch (level) {
+#if defined(HOST_ENGINE_X86)
+        case SIMD_AVX512:   zeroValuesAvx512(input, output, count, operand); return;
+        case SIMD_AVX2:     zeroValuesAvx2(input, output, count, operand); return;
+        case SIMD_SSE2:     zeroValuesSse2(input, output, count, operand); return;
+#endif
+#if defined(HOST_ENGINE_NEON)
+        case SIMD_NEON:     zeroValuesNeon(input, output, count, operand); return;
+#endif
+        default:            zeroValuesScalar(input, output, count, operand); return;
+    }
+}
+
+/**
+    Loop of every thread of the pool: wait for a new generation, run it, report it done.
+*/
+static void workerLoop(HostEngine *engine, unsigned worker)
+{
+    unsigned seen = 0;
+    unique_lock<mutex> guard(engine->lock);
+    while (true)
+    {
+        while (!engine->quit && engine->generation == seen) engine->wake.wait(guard);
+        if (engine->quit) return;
+        seen = engine->generation;
+        HostTaskFunction function = engine->function;
+        void *argument = engine->argument;
+        unsigned numThreads = (unsigned) engine->threads.size();
+
+        guard.unlock();
+        function(argument, worker, numThreads);
+        guard.lock();
+        if (--engine->pending == 0) engine->done.notify_all();
+    }
+}
+
+void hostEngineCreate(HostEngine *engine, unsigned numThreads, SimdLevel simd)
+{
+    SimdLevel supported = detectSimdLevel();
+    engine->simd = simd > supported ? supported : simd;
+    if (engine->simd == SIMD_NEON && supported != SIMD_NEON) engine->simd = SIMD_SCALAR;
+    if (numThreads == 0) numThreads = thread::hardware_concurrency();
+    if (numThreads == 0) numThreads = 1;
+    engine->function = NULL;
+    engine->argument = NULL;
+    engine->generation = 0;
+    engine->pending = 0;
+    engine->quit = false;
+
+    // the lock keeps the threads from reading threads.size() before every thread is in
+    lock_guard<mutex> guard(engine->lock);
+    for (unsigned t = 0; t < numThreads; t++)
+        engine->threads.push_back(thread(workerLoop, engine, t));
+}
+
+void hostEngineParallel(HostEngine *engine, HostTaskFunction function, void *argument)
+{
+    unique_lock<mutex> guard(engine->lock);
+    engine->function = function;
+    engine->argument = argument;
+    engine->pending = (unsigned) engine->threads.size();
+    engine->generation++;
+    engine->wake.notify_all();
+    while (engine->pending > 0) engine->done.wait(guard);
+}
+
+/**
+    Arguments of hostEngineRun, shared by every thread.
+*/
+struct ZeroValuesTask
+{
+    SimdLevel       simd;
+    const int       *input;
+    int             *output;
+    size_t          numberOfElements;
+    int             operand;
+};
+
+static void zeroValuesSlice(void *argument, unsigned worker, unsigned numThreads)
+{
+    ZeroValuesTask *task = (ZeroValuesTask*) argument;
+    size_t share = (task->numberOfElements / numThreads + SLICE_ALIGNMENT - 1) / SLICE_ALIGNMENT * SLICE_ALIGNMENT;
+    size_t first = worker * share;
+    if (first >= task->numberOfElements) return;
+    size_t count = first + share > task->numberOfElements ? task->numberOfElements - first : share;
+    if (worker == numThreads - 1) count = task->numberOfElements - first;
+    hostZeroValues(task->simd, task->input + first, task->output + first, count, task->operand);
+}
+
+double hostEngineRun(HostEngine *engine, const int *input, int *output, size_t numberOfElements, int operand)
+{
+    ZeroValuesTask task;
+    task.simd = engine->simd;
+    task.input = input;
+    task.output = output;
+    task.numberOfElements = numberOfElements;
+    task.operand = operand;
+
+    double start = wallClockMs();
+    hostEngineParallel(engine, zeroValuesSlice, &task);
+    return wallClockMs() - start;
+}
+
+void hostEngineRelease(HostEngine *engine)
+{
+    {
+        lock_guard<mutex> guard(engine->lock);
+        engine->quit = true;
+        engine->wake.notify_all();
+    }
+    for (size_t t = 0; t < engine->threads.size(); t++) engine->threads[t].join();
+    engine->threads.clear();
+}
@@ -0,0 +1,114 @@
+/**
+    Native host engine doing the zeroValues transform (out[i] = in[i] + operand) without OpenCL. A pool of threads
+    splits the range, and each thread runs an explicit SIMD loop chosen at runtime from what the CPU supports
+    (AVX-512, AVX2 or SSE2 on x86, NEON on ARM64, plain C++ otherwise), so one binary runs well on every machine.
+
+    The driver uses it when no OpenCL device is found, and runs it beside every OpenCL job as a baseline, to tell
+    whether the offload pays off for a given size.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLHOSTENGINE_H
+#define OPENCLHOSTENGINE_H
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+    Instruction sets of the SIMD loop, from the slowest to the fastest
+*/
+enum SimdLevel
+{
+    SIMD_SCALAR,            // plain C++ loop
+    SIMD_NEON,              // ARM64, 4 ints per instruction
+    SIMD_SSE2,              // x86, 4 ints per instruction
+    SIMD_AVX2,              // x86, 8 ints per instruction
+    SIMD_AVX512             // x86, 16 ints per instruction
+};
+
+/**
+    Function run by every thread of the pool. worker goes from 0 to numThreads - 1.
+*/
+typedef void (*HostTaskFunction)(void *argument, unsigned worker, unsigned numThreads);
+
+/**
+    Thread pool of the engine. The threads sleep on wake until a new generation of work is posted, and the caller
+    sleeps on done until every thread has finished it.
+*/
+struct HostEngine
+{
+    SimdLevel                   simd;
+    std::vector<std::thread>    threads;
+    std::mutex                  lock;
+    std::condition_variable     wake;
+    std::condition_variable     done;
+    HostTaskFunction            function;
+    void                        *argument;
+    unsigned                    generation;     // incremented by every hostEngineParallel
+    unsigned                    pending;        // threads still running the current generation
+    bool                        quit;
+};
+
+/**
+    detectSimdLevel asks the CPU (and the OS, for the AVX register state) for the widest instruction set available.
+    @return     level           widest usable instruction set
+*/
+SimdLevel detectSimdLevel();
+
+/**
+    simdLevelName gives the printable name of an instruction set.
+    @param      level           instruction set
+    @return     name            "scalar", "NEON", "SSE2", "AVX2" or "AVX-512"
+*/
+const char *simdLevelName(SimdLevel level);
+
+/**
+    hostZeroValues runs the transform on one thread, with the given instruction set.
+    @param      level           instruction set (must be supported by the CPU)
+    @param      input           input, count ints
+    @param      output          output, count ints
+    @param      count           number of elements
+    @param      operand         value added to every element
+*/
+void hostZeroValues(SimdLevel level, const int *input, int *output, size_t count, int operand);
+
+/**
+    hostEngineCreate starts the thread pool.
+    @param      engine          engine to be created
+    @param      numThreads      threads of the pool (0: one per hardware thread)
+    @param      simd            instruction set, lowered to detectSimdLevel() if the CPU doesn't support it
+*/
+void hostEngineCreate(HostEngine *engine, unsigned numThreads, SimdLevel simd);
+
+/**
+    hostEngineParallel runs a function on every thread of the pool, and waits for all of them.
+    @param      engine          created engine
+    @param      function        function run by every thread
+    @param      argument        argument given to the function
+*/
+void hostEngineParallel(HostEngine *engine, HostTaskFunction function, void *argument);
+
+/**
+    hostEngineRun runs the transform over the whole range, split in one contiguous slice per thread.
+    @param      engine          created engine
+    @param      input           input, numberOfElements ints
+    @param      output          output, numberOfElements ints
+    @param      numberOfElements    number of elements
+    @param      operand         value added to every element
+    @return     milliseconds    wall time of the run
+*/
+double hostEngineRun(HostEngine *engine, const int *input, int *output, size_t numberOfElements, int operand);
+
+/**
+    hostEngineRelease stops and joins the threads of the pool.
+    @param      engine          engine to be released
+*/
+void hostEngineRelease(HostEngine *engine);
+
+#endif
@@ -0,0 +1,51 @@
+/**
+    Host memory helpers for the OpenCL driver. See 1-openClHostMemory.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include "1-openClHostMemory.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+void *allocateHostBuffer(size_t bytes)
+{
+    void *pointer = NULL;
+    size_t rounded = (bytes + HOST_MEMORY_ALIGNMENT - 1) / HOST_MEMORY_ALIGNMENT * HOST_MEMORY_ALIGNMENT;
+    if (rounded == 0) rounded = HOST_MEMORY_ALIGNMENT;
+    if (posix_memalign(&pointer, HOST_MEMORY_ALIGNMENT, rounded) != 0)
+        { cout << "Couldn't allocate " << rounded << " bytes of host memory. Quitting..." << endl; exit(EXIT_FAILURE);}
+    return pointer;
+}
+
+void freeHostBuffer(void *pointer)
+{
+    free(pointer);
+}
+
+bool deviceHasUnifiedMemory(cl_device_id device)
+{
+    return deviceCapabilities(device).hostUnifiedMemory;       // false on OpenCL 1.0 runtimes, which don't know it
+}
+
+MemoryMode resolveMemoryMode(MemoryMode mode, cl_device_id device)
+{
+    if (mode != MEMORY_AUTO) return mode;
+    return deviceHasUnifiedMemory(device) ? MEMORY_ZERO_COPY : MEMORY_COPY;
+}
+
+const char *memoryModeName(MemoryMode mode)
+{
+    switch (mode) {
+        case MEMORY_COPY:           return "copy";
+        case MEMORY_ZERO_COPY:      return "zero-copy";
+        case MEMORY_AUTO:           return "auto";
+    }
+    return "unknown";
+}
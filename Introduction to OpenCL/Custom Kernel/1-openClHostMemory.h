@@ -0,0 +1,70 @@
+/**
+    Host memory helpers for the OpenCL driver: page aligned allocations (that runtimes can use in place with
+    CL_MEM_USE_HOST_PTR), and the selection between copying buffers and zero-copy buffers.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLHOSTMEMORY_H
+#define OPENCLHOSTMEMORY_H
+
+#include <cstddef>
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define HOST_MEMORY_ALIGNMENT   4096        // page size, also what CPU and integrated GPU runtimes need for zero-copy
+
+/**
+    How the driver moves data between host and device
+*/
+enum MemoryMode
+{
+    MEMORY_COPY,            // device buffers, filled with clEnqueueWriteBuffer and read with clEnqueueReadBuffer
+    MEMORY_ZERO_COPY,       // CL_MEM_USE_HOST_PTR buffers over the host arrays, synchronized with map/unmap
+    MEMORY_AUTO             // zero-copy if the device shares the host memory, copy otherwise
+};
+
+/**
+    allocateHostBuffer allocates host memory aligned to HOST_MEMORY_ALIGNMENT, with its size rounded up to a multiple
+    of the alignment. It exits the application if there is no memory left.
+    @param      bytes           requested size
+    @return     pointer         aligned memory, to be released with freeHostBuffer
+*/
+void *allocateHostBuffer(size_t bytes);
+
+/**
+    freeHostBuffer releases memory from allocateHostBuffer.
+    @param      pointer         memory to release (NULL is ignored)
+*/
+void freeHostBuffer(void *pointer);
+
+/**
+    deviceHasUnifiedMemory tells if a device shares the host memory (CL_DEVICE_HOST_UNIFIED_MEMORY), as CPU and
+    integrated GPU devices do.
+    @param      device          device to query
+    @return     unified         true if host and device memory are the same
+*/
+bool deviceHasUnifiedMemory(cl_device_id device);
+
+/**
+    resolveMemoryMode turns MEMORY_AUTO into MEMORY_ZERO_COPY or MEMORY_COPY for a given device.
+    @param      mode            requested mode
+    @param      device          device running the kernels
+    @return     mode            MEMORY_COPY or MEMORY_ZERO_COPY
+*/
+MemoryMode resolveMemoryMode(MemoryMode mode, cl_device_id device);
+
+/**
+    memoryModeName gives a printable name of a memory mode.
+    @param      mode            memory mode
+    @return     name            "copy", "zero-copy" or "auto"
+*/
+const char *memoryModeName(MemoryMode mode);
+
+#endif
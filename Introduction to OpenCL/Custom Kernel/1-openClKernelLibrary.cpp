@@ -0,0 +1,74 @@
+/**
+    Embedded kernel library. See 1-openClKernelLibrary.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+const string &kernelLibrarySource()
+{
+    static string source;
+    if (source.empty())
+        for (size_t s = 0; s < numEmbeddedSources; s++)
+        {
+            source += string("// ---- ") + embeddedSources[s].name + "\n";
+            source.append(embeddedSources[s].source, embeddedSources[s].size);
+            source += "\n";
+        }
+    return source;
+}
+
+void kernelLibraryCreate(KernelLibrary *library, cl_context context, cl_device_id device, const char *source,
+                         size_t sourceSize, const char *options, const char *cacheDir, ProgramCacheResult *result)
+{
+    library->context = context;
+    library->device = device;
+    library->program = buildProgramCached(context, device, source, sourceSize, options, cacheDir, result);
+    library->kernels.clear();
+}
+
+void kernelLibraryCreateAsync(KernelLibrary *library, cl_context context, cl_device_id device, const char *source,
+                              size_t sourceSize, const char *options, const char *cacheDir, ProgramCacheResult *result,
+                              KernelLibraryBuild *build)
+{
+    library->context = context;
+    library->device = device;
+    library->program = NULL;
+    build->worker = thread(kernelLibraryCreate, library, context, device, source, sourceSize, options, cacheDir, result);
+}
+
+double kernelLibraryWait(KernelLibraryBuild *build)
+{
+    double start = wallClockMs();
+    if (build->worker.joinable()) build->worker.join();
+    return wallClockMs() - start;
+}
+
+cl_kernel kernelLibraryGet(KernelLibrary *library, const char *name)
+{
+    map<string, cl_kernel>::iterator found = library->kernels.find(name);
+    if (found != library->kernels.end()) return found->second;
+
+    cl_int clErr;
+    cl_kernel kernel = clCreateKernel(library->program, name, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateKernel Error (" << name << "): " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    library->kernels[name] = kernel;
+    return kernel;
+}
+
+void kernelLibraryRelease(KernelLibrary *library)
+{
+    for (map<string, cl_kernel>::iterator k = library->kernels.begin(); k != library->kernels.end(); ++k)
+        clReleaseKernel(k->second);
+    library->kernels.clear();
+    clReleaseProgram(library->program);
+}
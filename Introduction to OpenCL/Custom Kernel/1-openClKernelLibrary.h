@@ -0,0 +1,123 @@
+/**
+    Embedded kernel library. Every .cl file listed in the KERNELS of 1-Makefile is compiled into the binary at build
+    time (1-openClEmbed generates 1-openClKernelSources.cpp from them), so startup reads no file and no kernel can
+    be truncated. All the sources are built as one cl_program per device, and kernels are looked up by name
+    through a registry that creates each of them on its first use.
+
+    The sources share one program, so they must not define the same kernel, function or macro twice.
+
+    The build can run on a worker thread (kernelLibraryCreateAsync), so the host prepares its data and the device
+    buffers meanwhile, and only joins the build (kernelLibraryWait) before creating the first kernel.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLKERNELLIBRARY_H
+#define OPENCLKERNELLIBRARY_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <thread>
+#include "1-openClProgramCache.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+/**
+    One embedded .cl file (generated, see 1-openClEmbed.cpp).
+*/
+struct EmbeddedSource
+{
+    const char      *name;          // file name, without directories
+    const char      *source;        // content, null terminated
+    size_t          size;           // length of the content, in bytes
+};
+
+extern const EmbeddedSource     embeddedSources[];
+extern const size_t             numEmbeddedSources;
+
+/**
+    Program with every kernel of the library, for one device, and the kernels created so far.
+*/
+struct KernelLibrary
+{
+    cl_context                          context;
+    cl_device_id                        device;
+    cl_program                          program;
+    std::map<std::string, cl_kernel>    kernels;
+};
+
+/**
+    Build of a library running on a worker thread.
+*/
+struct KernelLibraryBuild
+{
+    std::thread     worker;
+};
+
+/**
+    kernelLibrarySource gives the source of the whole library: every embedded file, in the order of KERNELS.
+    @return     source          concatenated sources
+*/
+const std::string &kernelLibrarySource();
+
+/**
+    kernelLibraryCreate builds the program of the library for one device (through the on-disk program cache).
+    @param      library         library to be created
+    @param      context         context of the device
+    @param      device          device that the program is built for
+    @param      source          source of the library (kernelLibrarySource())
+    @param      sourceSize      length of the source, in bytes
+    @param      options         build options given to clBuildProgram
+    @param      cacheDir        directory of the program cache, or NULL
+    @param      result          filled with the cold/warm outcome and timings (may be NULL)
+*/
+void kernelLibraryCreate(KernelLibrary *library, cl_context context, cl_device_id device, const char *source,
+                         size_t sourceSize, const char *options, const char *cacheDir, ProgramCacheResult *result);
+
+/**
+    kernelLibraryCreateAsync starts kernelLibraryCreate on a worker thread, and returns right away. Neither the
+    library nor the result can be used until kernelLibraryWait returns.
+    @param      library         library to be created
+    @param      context         context of the device
+    @param      device          device that the program is built for
+    @param      source          source of the library (kernelLibrarySource(), must outlive the build)
+    @param      sourceSize      length of the source, in bytes
+    @param      options         build options given to clBuildProgram (must outlive the build)
+    @param      cacheDir        directory of the program cache, or NULL
+    @param      result          filled with the cold/warm outcome and timings (may be NULL)
+    @param      build           worker thread of the build
+*/
+void kernelLibraryCreateAsync(KernelLibrary *library, cl_context context, cl_device_id device, const char *source,
+                              size_t sourceSize, const char *options, const char *cacheDir, ProgramCacheResult *result,
+                              KernelLibraryBuild *build);
+
+/**
+    kernelLibraryWait joins a build started by kernelLibraryCreateAsync (returns at once if it was already joined).
+    @param      build           build to be joined
+    @return     milliseconds    time spent blocked, waiting for the build to finish
+*/
+double kernelLibraryWait(KernelLibraryBuild *build);
+
+/**
+    kernelLibraryGet returns a kernel of the library, creating it the first time its name is asked for. The kernel
+    belongs to the library (don't release it), and is shared by every caller asking for the same name.
+    @param      library         created library
+    @param      name            name of the kernel function
+    @return     kernel          kernel object (the application exits if there is no such kernel)
+*/
+cl_kernel kernelLibraryGet(KernelLibrary *library, const char *name);
+
+/**
+    kernelLibraryRelease releases every kernel created, and the program.
+    @param      library         library to be released
+*/
+void kernelLibraryRelease(KernelLibrary *library);
+
+#endif
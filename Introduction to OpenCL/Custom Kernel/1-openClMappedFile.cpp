@@ -0,0 +1,115 @@
+/**
+    Memory-mapped datasets. See 1-openClMappedFile.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "1-openClMappedFile.h"
+
+using namespace std;
+
+static size_t pageSize()
+{
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t) size : 4096;
+}
+
+bool mapFileRead(MappedFile *file, const char *path)
+{
+    struct stat info;
+    file->data = NULL;
+    file->writable = false;
+    file->fd = open(path, O_RDONLY);
+    if (file->fd < 0) { cout << "Couldn't open " << path << endl; return false;}
+    if (fstat(file->fd, &info) != 0 || info.st_size == 0)
+        { cout << "Couldn't map " << path << " (empty or unreadable)" << endl; close(file->fd); return false;}
+    file->bytes = (size_t) info.st_size;
+
+    void *data = mmap(NULL, file->bytes, PROT_READ, MAP_SHARED, file->fd, 0);
+    if (data == MAP_FAILED) { cout << "Couldn't map " << path << endl; close(file->fd); return false;}
+    file->data = data;
+    madvise(file->data, file->bytes, MADV_SEQUENTIAL);      // aggressive read-ahead, pages freed behind
+    return true;
+}
+
+bool mapFileWrite(MappedFile *file, const char *path, size_t bytes)
+{
+    file->data = NULL;
+    file->writable = true;
+    file->bytes = bytes;
+    file->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file->fd < 0) { cout << "Couldn't create " << path << endl; return false;}
+    if (bytes == 0 || ftruncate(file->fd, (off_t) bytes) != 0)
+        { cout << "Couldn't size " << path << endl; close(file->fd); return false;}
+
+    void *data = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, 0);
+    if (data == MAP_FAILED) { cout << "Couldn't map " << path << endl; close(file->fd); return false;}
+    file->data = data;
+    madvise(file->data, file->bytes, MADV_SEQUENTIAL);
+    return true;
+}
+
+/**
+    Clips a range to the file, and widens it to whole pages (madvise and msync take page aligned addresses).
+*/
+static bool pageRange(const MappedFile *file, size_t offset, size_t bytes, char **start, size_t *length)
+{
+    if (offset >= file->bytes) return false;
+    if (bytes > file->bytes - offset) bytes = file->bytes - offset;
+    size_t page = pageSize();
+    size_t first = offset / page * page;
+    *start = (char*) file->data + first;
+    *length = offset + bytes - first;
+    return *length > 0;
+}
+
+void adviseWillNeed(MappedFile *file, size_t offset, size_t bytes)
+{
+    char *start;
+    size_t length;
+    if (pageRange(file, offset, bytes, &start, &length)) madvise(start, length, MADV_WILLNEED);
+}
+
+void adviseDone(MappedFile *file, size_t offset, size_t bytes)
+{
+    char *start;
+    size_t length;
+    if (!pageRange(file, offset, bytes, &start, &length)) return;
+    if (file->writable) msync(start, length, MS_SYNC);
+    madvise(start, length, MADV_DONTNEED);
+}
+
+size_t physicalMemoryBytes()
+{
+    long pages = sysconf(_SC_PHYS_PAGES);
+    return pages > 0 ? (size_t) pages * pageSize() : 0;
+}
+
+size_t mappedWindowBytes(const MappedFile *file)
+{
+    size_t share = physicalMemoryBytes() / MAPPED_WINDOW_SHARE;
+    if (share == 0 || file->bytes <= share) return file->bytes;
+    size_t page = pageSize();
+    return share / page * page;
+}
+
+bool unmapFile(MappedFile *file)
+{
+    bool ok = true;
+    if (file->data != NULL)
+    {
+        if (file->writable) ok = msync(file->data, file->bytes, MS_SYNC) == 0;
+        munmap(file->data, file->bytes);
+        file->data = NULL;
+    }
+    if (file->fd >= 0) close(file->fd);
+    file->fd = -1;
+    return ok;
+}
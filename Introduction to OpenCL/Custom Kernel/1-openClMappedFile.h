@@ -0,0 +1,89 @@
+/**
+    Memory-mapped datasets. The input of the driver can be a binary file of native-endian ints, mapped read-only with
+    a sequential access hint instead of being copied into the heap: the mapped pages go straight into the device
+    buffers (or are the CL_MEM_USE_HOST_PTR backing of a zero-copy buffer). With binary output, the results can be
+    written into a mapped output file the same way.
+
+    Files bigger than the device memory go through the streaming pipeline (see 1-openClStreaming.h); files bigger
+    than a share of the RAM are streamed one window of the mapping at a time, prefetching the next window and
+    dropping the pages of the finished one, so the process never holds the whole file.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLMAPPEDFILE_H
+#define OPENCLMAPPEDFILE_H
+
+#include <cstddef>
+
+#define MAPPED_WINDOW_SHARE     8       // a window is at most 1/8 of the physical memory
+
+/**
+    One mapped file. data is page aligned.
+*/
+struct MappedFile
+{
+    int         fd;
+    void        *data;
+    size_t      bytes;
+    bool        writable;
+};
+
+/**
+    mapFileRead maps a whole file read-only, advising sequential access.
+    @param      file            mapping to be created
+    @param      path            file to map
+    @return     success         false if the file can't be opened or mapped (or is empty)
+*/
+bool mapFileRead(MappedFile *file, const char *path);
+
+/**
+    mapFileWrite creates (or truncates) a file of the given size and maps it for writing, advising sequential access.
+    @param      file            mapping to be created
+    @param      path            file to create
+    @param      bytes           size of the file
+    @return     success         false if the file can't be created, sized or mapped
+*/
+bool mapFileWrite(MappedFile *file, const char *path, size_t bytes);
+
+/**
+    adviseWillNeed asks the kernel to start reading a range of the mapping ahead of its use.
+    @param      file            mapped file
+    @param      offset          first byte of the range
+    @param      bytes           length of the range (clipped to the file)
+*/
+void adviseWillNeed(MappedFile *file, size_t offset, size_t bytes);
+
+/**
+    adviseDone tells the kernel a range of the mapping won't be used again, so its pages can be dropped (written
+    back first, for a writable mapping).
+    @param      file            mapped file
+    @param      offset          first byte of the range
+    @param      bytes           length of the range (clipped to the file)
+*/
+void adviseDone(MappedFile *file, size_t offset, size_t bytes);
+
+/**
+    physicalMemoryBytes gives the physical memory of the machine.
+    @return     bytes           physical memory, or 0 if unknown
+*/
+size_t physicalMemoryBytes();
+
+/**
+    mappedWindowBytes gives the size of the windows a mapping is streamed in: the whole file when it fits in a share
+    of the physical memory (MAPPED_WINDOW_SHARE), page aligned windows of that share otherwise.
+    @param      file            mapped file
+    @return     bytes           window size
+*/
+size_t mappedWindowBytes(const MappedFile *file);
+
+/**
+    unmapFile unmaps a file (flushing a writable mapping) and closes it.
+    @param      file            mapping to be released
+    @return     success         false if the data of a writable mapping couldn't be flushed
+*/
+bool unmapFile(MappedFile *file);
+
+#endif
@@ -0,0 +1,302 @@
+/**
+    Multi-platform, multi-device partitioning of one zeroValues job. See 1-openClMultiDevice.h for the description of
+    each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "1-openClMultiDevice.h"
+#include "1-openClCapabilities.h"
+#include "1-openClStreaming.h"
+#include "1-openClUtilities.h"
+#include "1-openClVectorKernels.h"
+
+using namespace std;
+
+#define SLICE_ALIGNMENT     1024        // slices start at multiples of 1024 elements (4KB)
+
+/**
+    Sets up the context and queue of one device (the kernel library is built later, in parallel for every device).
+*/
+static DeviceWorker createWorker(cl_platform_id platform, cl_device_id device, bool subDevice, cl_uint vectorWidth)
+{
+    DeviceWorker worker;
+    cl_int clErr;
+    worker.name = deviceCapabilities(device).name;
+    worker.device = device;
+    worker.subDevice = subDevice;
+    worker.vectorWidth = vectorWidth != 0 ? vectorWidth : selectVectorWidth(device);
+    worker.throughput = 0;
+
+    cl_context_properties properties[] = {CL_CONTEXT_PLATFORM, (cl_context_properties) platform, 0};
+    worker.context = clCreateContext(properties,1,&device,NULL,NULL,&clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateContext Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    worker.queue = clCreateCommandQueue(worker.context,device,CL_QUEUE_PROFILING_ENABLE,&clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateCommandQueue Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    return worker;
+}
+
+void multiDeviceCreate(MultiDevice *multi, const char *source, size_t sourceSize, const char *cacheDir,
+                       cl_uint subDevices, cl_uint vectorWidth, Profiler *profiler)
+{
+    cl_int clErr;
+    cl_uint numPlatforms;
+    double phaseStart = wallClockMs();
+
+    clErr = clGetPlatformIDs(0, NULL, &numPlatforms);
+    if (clErr != CL_SUCCESS) { cout << "clGetPlatformIDs Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    vector<cl_platform_id> platforms(numPlatforms);
+    clErr = clGetPlatformIDs(numPlatforms, &platforms[0], NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetPlatformIDs Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    for (cl_uint p = 0; p < numPlatforms; p++)
+    {
+        cl_uint numDevices;
+        if (clGetDeviceIDs(platforms[p], CL_DEVICE_TYPE_ALL, 0, NULL, &numDevices) != CL_SUCCESS || numDevices == 0) continue;
+        vector<cl_device_id> devices(numDevices);
+        clErr = clGetDeviceIDs(platforms[p], CL_DEVICE_TYPE_ALL, numDevices, &devices[0], NULL);
+        if (clErr != CL_SUCCESS) { cout << "clGetDeviceIDs Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+        for (cl_uint d = 0; d < numDevices; d++)
+        {
+            cl_bool available = CL_FALSE, compiler = CL_FALSE;       // may change between runs: never cached
+            clGetDeviceInfo(devices[d],CL_DEVICE_AVAILABLE,sizeof(cl_bool),&available,NULL);
+            clGetDeviceInfo(devices[d],CL_DEVICE_COMPILER_AVAILABLE,sizeof(cl_bool),&compiler,NULL);
+            if (!available || !compiler) continue;
+            const DeviceCapabilities &caps = deviceCapabilities(devices[d]);
+            cl_device_type type = caps.type;
+
+            // CPU devices can be split in equal sub-devices, each one getting its own share of the job
+            if ((type & CL_DEVICE_TYPE_CPU) && subDevices > 1)
+            {
+                cl_uint computeUnits = caps.computeUnits;
+                cl_uint unitsEach = computeUnits / subDevices > 0 ? computeUnits / subDevices : 1;
+                cl_device_partition_property partition[] = {CL_DEVICE_PARTITION_EQUALLY, (cl_device_partition_property) unitsEach, 0};
+                cl_uint numSubDevices = 0;
+                clErr = clCreateSubDevices(devices[d], partition, 0, NULL, &numSubDevices);
+                if (clErr == CL_SUCCESS && numSubDevices > 0)
+                {
+                    vector<cl_device_id> sub(numSubDevices);
+                    clErr = clCreateSubDevices(devices[d], partition, numSubDevices, &sub[0], NULL);
+                    if (clErr != CL_SUCCESS) { cout << "clCreateSubDevices Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+                    for (cl_uint s = 0; s < numSubDevices && s < subDevices; s++)
+                        multi->workers.push_back(createWorker(platforms[p], sub[s], true, vectorWidth));
+                    for (cl_uint s = subDevices; s < numSubDevices; s++) clReleaseDevice(sub[s]);
+                    continue;
+                }
+                cout << "clCreateSubDevices Error: " << checkError(clErr) << ". Using the whole CPU device." << endl;
+            }
+            multi->workers.push_back(createWorker(platforms[p], devices[d], false, vectorWidth));
+        }
+    }
+    if (multi->workers.empty()) { cout << "No usable OpenCL device found. Quitting..." << endl; exit(EXIT_FAILURE);}
+
+    // the programs are built at the same time, one worker thread per device (the workers don't move any more)
+    vector<KernelLibraryBuild> builds(multi->workers.size());
+    for (size_t w = 0; w < multi->workers.size(); w++)
+        kernelLibraryCreateAsync(&multi->workers[w].library, multi->workers[w].context, multi->workers[w].device,
+                                 source, sourceSize, "", cacheDir, NULL, &builds[w]);
+    for (size_t w = 0; w < multi->workers.size(); w++)
+    {
+        kernelLibraryWait(&builds[w]);
+        multi->workers[w].kernel = kernelLibraryGet(&multi->workers[w].library,
+                                                    zeroValuesKernelName(multi->workers[w].vectorWidth));
+    }
+    profilerAddPhase(profiler, "multi-device setup", wallClockMs() - phaseStart);
+}
+
+/**
+    Stages recorded by one slice (the profiler itself is only touched by the main thread).
+*/
+struct SliceStages
+{
+    vector<string>      names;
+    vector<cl_event>    events;
+    vector<size_t>      bytes;
+    vector<size_t>      elements;
+    double              milliseconds;
+    bool                streamed;
+};
+
+/**
+    Runs the zeroValues variant of the worker on one device, over input[0, count), writing output[0, count). Whole buffers are used when the
+    slice fits the device, the streaming pipeline otherwise.
+*/
+static void runSlice(DeviceWorker *worker, const int *input, int *output, size_t count, SliceStages *stages)
+{
+    cl_int clErr;
+    double start = wallClockMs();
+    size_t bufferSize = count * sizeof(int);
+    stages->streamed = count > 0x7fffffff || streamingRequired(worker->device, bufferSize);
+
+    if (stages->streamed)
+    {
+        StreamPipeline pipeline;
+        streamPipelineCreate(&pipeline, worker->context, worker->device, streamChunkElements(worker->device, count, 3, 0), 3);
+        vector<cl_event> events;
+        streamPipelineRun(&pipeline, worker->kernel, input, output, count, worker->geometry, &events);
+
+        // three events per chunk, profiled by the main thread like those of whole buffers
+        const char *names[] = {"write", "kernel", "read"};
+        for (size_t e = 0; e < events.size(); e++)
+        {
+            size_t first = e / 3 * pipeline.chunkElements;
+            size_t chunkCount = count - first < pipeline.chunkElements ? count - first : pipeline.chunkElements;
+            char name[64];
+            snprintf(name, sizeof name, "chunk %d %s", (int) (e / 3), names[e % 3]);
+            stages->names.push_back(name); stages->events.push_back(events[e]);
+            stages->bytes.push_back(e % 3 == 1 ? 0 : chunkCount * sizeof(int));
+            stages->elements.push_back(e % 3 == 1 ? chunkCount : 0);
+        }
+        streamPipelineRelease(&pipeline);
+        stages->milliseconds = wallClockMs() - start;
+        return;
+    }
+
+    cl_mem inputBuffer = clCreateBuffer(worker->context, CL_MEM_READ_ONLY, bufferSize, NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    cl_mem outputBuffer = clCreateBuffer(worker->context, CL_MEM_WRITE_ONLY, bufferSize, NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    cl_int imax = (cl_int) count;
+    clErr  = clSetKernelArg(worker->kernel,0,sizeof(cl_mem),&inputBuffer);
+    clErr |= clSetKernelArg(worker->kernel,1,sizeof(cl_mem),&outputBuffer);
+    clErr |= clSetKernelArg(worker->kernel,2,sizeof(cl_int),&imax);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    cl_event event;
+    clErr = clEnqueueWriteBuffer(worker->queue, inputBuffer, CL_FALSE, 0, bufferSize, input, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    stages->names.push_back("write"); stages->events.push_back(event);
+    stages->bytes.push_back(bufferSize); stages->elements.push_back(0);
+
+    clErr = clEnqueueNDRangeKernel(worker->queue, worker->kernel, 1, NULL, &worker->geometry.globalSize,
+                                   &worker->geometry.localSize, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    stages->names.push_back(string("kernel ") + zeroValuesKernelName(worker->vectorWidth)); stages->events.push_back(event);
+    stages->bytes.push_back(0); stages->elements.push_back(count);
+
+    clErr = clEnqueueReadBuffer(worker->queue, outputBuffer, CL_TRUE, 0, bufferSize, output, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueReadBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    stages->names.push_back("read"); stages->events.push_back(event);
+    stages->bytes.push_back(bufferSize); stages->elements.push_back(0);
+
+    stages->milliseconds = wallClockMs() - start;
+    clReleaseMemObject(inputBuffer);
+    clReleaseMemObject(outputBuffer);
+}
+
+void multiDeviceCalibrate(MultiDevice *multi, const int *input, int *output, size_t sampleElements,
+                          const char *tuningFile, int tuneMode, bool compareVector)
+{
+    cl_int clErr;
+    for (size_t w = 0; w < multi->workers.size(); w++)
+    {
+        DeviceWorker &worker = multi->workers[w];
+        size_t bufferSize = sampleElements * sizeof(int);
+        cl_mem inputBuffer = clCreateBuffer(worker.context, CL_MEM_READ_ONLY, bufferSize, NULL, &clErr);
+        if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        cl_mem outputBuffer = clCreateBuffer(worker.context, CL_MEM_WRITE_ONLY, bufferSize, NULL, &clErr);
+        if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        cl_int imax = (cl_int) sampleElements;
+        clErr  = clSetKernelArg(worker.kernel,0,sizeof(cl_mem),&inputBuffer);
+        clErr |= clSetKernelArg(worker.kernel,1,sizeof(cl_mem),&outputBuffer);
+        clErr |= clSetKernelArg(worker.kernel,2,sizeof(cl_int),&imax);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+        size_t workItems = vectorWorkItems(sampleElements, worker.vectorWidth);
+        if (tuneMode == 0)
+            worker.geometry = defaultGeometry(worker.device, worker.kernel, workItems);
+        else
+            worker.geometry = autoTuneGeometry(worker.queue, worker.device, worker.kernel,
+                                               zeroValuesKernelName(worker.vectorWidth), workItems, tuningFile, tuneMode == 2);
+
+        // the whole round trip counts, since that is what a slice costs: best of two runs
+        double best = -1;
+        for (int rep = 0; rep < 2; rep++)
+        {
+            double start = wallClockMs();
+            clErr  = clEnqueueWriteBuffer(worker.queue, inputBuffer, CL_FALSE, 0, bufferSize, input, 0, NULL, NULL);
+            clErr |= clEnqueueNDRangeKernel(worker.queue, worker.kernel, 1, NULL, &worker.geometry.globalSize,
+                                            &worker.geometry.localSize, 0, NULL, NULL);
+            clErr |= clEnqueueReadBuffer(worker.queue, outputBuffer, CL_TRUE, 0, bufferSize, output, 0, NULL, NULL);
+            if (clErr != CL_SUCCESS) { cout << "Calibration Error on " << worker.name << ": " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+            double ms = wallClockMs() - start;
+            if (best < 0 || ms < best) best = ms;
+        }
+        worker.throughput = sampleElements / (best > 1e-3 ? best : 1e-3);
+        clReleaseMemObject(inputBuffer);
+        clReleaseMemObject(outputBuffer);
+
+        if (compareVector)
+            compareVectorWidths(worker.context, worker.device, worker.queue, &worker.library, input, sampleElements,
+                                tuningFile, tuneMode);
+    }
+}
+
+double multiDeviceRun(MultiDevice *multi, const int *input, int *output, size_t numberOfElements, Profiler *profiler)
+{
+    size_t numWorkers = multi->workers.size();
+    double total = 0;
+    for (size_t w = 0; w < numWorkers; w++) total += multi->workers[w].throughput;
+
+    // slices proportional to the measured throughput, aligned, and the last device takes the remainder
+    vector<size_t> first(numWorkers), count(numWorkers);
+    size_t next = 0;
+    for (size_t w = 0; w < numWorkers; w++)
+    {
+        size_t share = (size_t) (numberOfElements * (multi->workers[w].throughput / total));
+        share = share / SLICE_ALIGNMENT * SLICE_ALIGNMENT;
+        if (w == numWorkers - 1 || next + share > numberOfElements) share = numberOfElements - next;
+        first[w] = next;
+        count[w] = share;
+        next += share;
+    }
+
+    double start = wallClockMs();
+    vector<SliceStages> stages(numWorkers);
+    vector<thread> threads;
+    for (size_t w = 0; w < numWorkers; w++)
+        if (count[w] > 0)
+            threads.push_back(thread(runSlice, &multi->workers[w], input + first[w], output + first[w], count[w], &stages[w]));
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+    double milliseconds = wallClockMs() - start;
+
+    cout << endl << "Multi-device partition (" << numWorkers << " devices):" << endl;
+    for (size_t w = 0; w < numWorkers; w++)
+    {
+        DeviceWorker &worker = multi->workers[w];
+        cout << "\tdevice " << w << ": " << worker.name << (worker.subDevice ? " (sub-device)" : "") << "  "
+             << zeroValuesKernelName(worker.vectorWidth) << ", " << worker.throughput << " elem/ms calibrated, " << count[w] << " elements ["
+             << first[w] << ", " << first[w] + count[w] << ")";
+        if (count[w] > 0) cout << ", " << stages[w].milliseconds << " ms" << (stages[w].streamed ? " (streamed)" : "");
+        cout << endl;
+
+        char name[64];
+        for (size_t s = 0; s < stages[w].events.size(); s++)
+        {
+            snprintf(name, sizeof name, "device %d: %s", (int) w, stages[w].names[s].c_str());
+            profilerAddStage(profiler, name, stages[w].events[s], stages[w].bytes[s], stages[w].elements[s]);
+        }
+    }
+    return milliseconds;
+}
+
+void multiDeviceRelease(MultiDevice *multi)
+{
+    for (size_t w = 0; w < multi->workers.size(); w++)
+    {
+        DeviceWorker &worker = multi->workers[w];
+        kernelLibraryRelease(&worker.library);
+        clReleaseCommandQueue(worker.queue);
+        clReleaseContext(worker.context);
+        if (worker.subDevice) clReleaseDevice(worker.device);
+    }
+    multi->workers.clear();
+}
@@ -0,0 +1,99 @@
+/**
+    Multi-platform, multi-device partitioning of one zeroValues job. Every usable device of every platform gets its
+    own context, queue, program and kernel. A short calibration run measures the throughput of each device, and the
+    job is split in contiguous slices proportional to it. Each slice is driven by its own host thread (whole buffers,
+    or the streaming pipeline if the slice doesn't fit the device), and read back in place into the output array.
+
+    CPU devices can be partitioned into sub-devices (clCreateSubDevices, OpenCL 1.2), which also allows testing the
+    partitioning on a machine with a single CPU runtime.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLMULTIDEVICE_H
+#define OPENCLMULTIDEVICE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "1-openClAutoTuner.h"
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+/**
+    One device taking part of the job.
+*/
+struct DeviceWorker
+{
+    std::string         name;
+    cl_device_id        device;
+    bool                subDevice;          // created by clCreateSubDevices (released with the worker)
+    cl_context          context;
+    cl_command_queue    queue;
+    KernelLibrary       library;
+    cl_kernel           kernel;             // zeroValues variant, from the library
+    cl_uint             vectorWidth;        // vector width of the zeroValues variant (see 1-openClVectorKernels.h)
+    LaunchGeometry      geometry;
+    double              throughput;         // elements per millisecond, from the calibration
+};
+
+struct MultiDevice
+{
+    std::vector<DeviceWorker>   workers;
+};
+
+/**
+    multiDeviceCreate finds every available device (with a compiler) of every platform, and sets up a worker for it.
+    The programs of the workers are built at the same time, one thread per device.
+    @param      multi           workers to be created
+    @param      source          source of the kernel library (see 1-openClKernelLibrary.h)
+    @param      sourceSize      length of the source, in bytes
+    @param      cacheDir        program cache directory (see 1-openClProgramCache.h), or NULL
+    @param      subDevices      number of sub-devices each CPU device is split into (0 or 1 to keep it whole)
+    @param      vectorWidth     vector width of the kernel variant, or 0 to pick it per device
+    @param      profiler        profiler receiving the setup phases
+*/
+void multiDeviceCreate(MultiDevice *multi, const char *source, size_t sourceSize, const char *cacheDir,
+                       cl_uint subDevices, cl_uint vectorWidth, Profiler *profiler);
+
+/**
+    multiDeviceCalibrate runs a sample of the job on each device (write, kernel and read), to measure its throughput.
+    The launch geometry of each device is tuned here as well.
+    @param      multi           workers created by multiDeviceCreate
+    @param      input           sample input, at least sampleElements ints
+    @param      output          sample output, at least sampleElements ints
+    @param      sampleElements  elements of the calibration run
+    @param      tuningFile      tuning file of the auto-tuner, or NULL
+    @param      tuneMode        0: default geometry, 1: stored or tuned once, 2: always tune again
+    @param      compareVector   also benchmark every vector width against the scalar kernel on each device
+*/
+void multiDeviceCalibrate(MultiDevice *multi, const int *input, int *output, size_t sampleElements,
+                          const char *tuningFile, int tuneMode, bool compareVector);
+
+/**
+    multiDeviceRun splits the job between the workers, proportionally to their throughput, runs every slice
+    concurrently and waits for all of them. The stages of each device are added to the profiler.
+    @param      multi           calibrated workers
+    @param      input           host input, numberOfElements ints
+    @param      output          host output, numberOfElements ints (each slice is read back in place)
+    @param      numberOfElements    elements of the job
+    @param      profiler        profiler receiving the stages of every device
+    @return     milliseconds    wall time of the whole job
+*/
+double multiDeviceRun(MultiDevice *multi, const int *input, int *output, size_t numberOfElements, Profiler *profiler);
+
+/**
+    multiDeviceRelease releases every worker.
+    @param      multi           workers to be released
+*/
+void multiDeviceRelease(MultiDevice *multi);
+
+#endif
@@ -0,0 +1,246 @@
+/**
+    Output stage of the results. See 1-openClOutput.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "1-openClOutput.h"
+#include "1-openClProgramCache.h"
+
+using namespace std;
+
+#define FNV_OFFSET          14695981039346656037ULL
+#define WRITE_BUFFER_SIZE   (16 << 20)          // buffer of the fwrite fallback of writeBinary
+#define TEXT_SEPARATOR      "   "
+#define MAX_TEXT_ELEMENT    14                  // "-2147483648" and the separator
+#define TEXT_BLOCK          (1 << 16)           // elements formatted at a time by each thread (under 1MB of text)
+
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+    Per-block results of summarizeResults.
+*/
+struct SummaryTask
+{
+    const int                       *values;
+    size_t                          count;
+    size_t                          numBlocks;
+    vector<unsigned long long>      hashes;
+    vector<long long>               sums;
+    vector<int>                     mins;
+    vector<int>                     maxs;
+};
+
+static void summarizeBlocks(void *argument, unsigned worker, unsigned numThreads)
+{
+    SummaryTask *task = (SummaryTask*) argument;
+    for (size_t b = worker; b < task->numBlocks; b += numThreads)
+    {
+        size_t first = b * OUTPUT_BLOCK;
+        size_t count = task->count - first < OUTPUT_BLOCK ? task->count - first : OUTPUT_BLOCK;
+        const int *values = task->values + first;
+        long long sum = 0;
+        int min = values[0], max = values[0];
+        for (size_t i = 0; i < count; i++)
+        {
+            sum += values[i];
+            if (values[i] < min) min = values[i];
+            if (values[i] > max) max = values[i];
+        }
+        task->hashes[b] = hashBytes(values, count * sizeof(int), FNV_OFFSET);
+        task->sums[b] = sum;
+        task->mins[b] = min;
+        task->maxs[b] = max;
+    }
+}
+
+ResultSummary summarizeResults(HostEngine *engine, const int *values, size_t count)
+{
+    ResultSummary summary;
+    summary.count = count;
+    summary.checksum = FNV_OFFSET;
+    summary.sum = 0;
+    summary.min = summary.max = 0;
+    if (count == 0) return summary;
+
+    SummaryTask task;
+    task.values = values;
+    task.count = count;
+    task.numBlocks = (count + OUTPUT_BLOCK - 1) / OUTPUT_BLOCK;
+    task.hashes.resize(task.numBlocks);
+    task.sums.resize(task.numBlocks);
+    task.mins.resize(task.numBlocks);
+    task.maxs.resize(task.numBlocks);
+    hostEngineParallel(engine, summarizeBlocks, &task);
+
+    summary.min = task.mins[0];
+    summary.max = task.maxs[0];
+    for (size_t b = 0; b < task.numBlocks; b++)
+    {
+        summary.checksum = hashBytes(&task.hashes[b], sizeof(unsigned long long), summary.checksum);
+        summary.sum += task.sums[b];
+        if (task.mins[b] < summary.min) summary.min = task.mins[b];
+        if (task.maxs[b] > summary.max) summary.max = task.maxs[b];
+    }
+    return summary;
+}
+
+void writeSummary(HostEngine *engine, const int *values, size_t count, size_t edge, FILE *out)
+{
+    ResultSummary summary = summarizeResults(engine, values, count);
+    fprintf(out, "\nResult:  %llu elements, checksum %016llx, sum %lld, min %d, max %d\n",
+            (unsigned long long) summary.count, summary.checksum, summary.sum, summary.min, summary.max);
+
+    char text[MAX_TEXT_ELEMENT];
+    size_t head = edge < count ? edge : count;
+    fprintf(out, "\tfirst %llu: ", (unsigned long long) head);
+    for (size_t i = 0; i < head; i++) { *formatInt(values[i], text) = '\0'; fprintf(out, "%s" TEXT_SEPARATOR, text); }
+    fprintf(out, "\n");
+    size_t tail = edge < count - head ? edge : count - head;
+    if (tail > 0)
+    {
+        fprintf(out, "\tlast %llu:  ", (unsigned long long) tail);
+        for (size_t i = count - tail; i < count; i++) { *formatInt(values[i], text) = '\0'; fprintf(out, "%s" TEXT_SEPARATOR, text); }
+        fprintf(out, "\n");
+    }
+}
+
+/**
+    Copy of the results into the mapped file, one block per thread at a time.
+*/
+struct CopyTask
+{
+    const int       *values;
+    int             *mapped;
+    size_t          count;
+};
+
+static void copyBlocks(void *argument, unsigned worker, unsigned numThreads)
+{
+    CopyTask *task = (CopyTask*) argument;
+    size_t numBlocks = (task->count + OUTPUT_BLOCK - 1) / OUTPUT_BLOCK;
+    for (size_t b = worker; b < numBlocks; b += numThreads)
+    {
+        size_t first = b * OUTPUT_BLOCK;
+        size_t count = task->count - first < OUTPUT_BLOCK ? task->count - first : OUTPUT_BLOCK;
+        memcpy(task->mapped + first, task->values + first, count * sizeof(int));
+    }
+}
+
+bool writeBinary(HostEngine *engine, const int *values, size_t count, const char *path)
+{
+    size_t bytes = count * sizeof(int);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) { cout << "Couldn't create " << path << endl; return false;}
+
+    void *mapped = MAP_FAILED;
+    if (bytes > 0 && ftruncate(fd, (off_t) bytes) == 0)
+        mapped = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped != MAP_FAILED)
+    {
+        CopyTask task;
+        task.values = values;
+        task.mapped = (int*) mapped;
+        task.count = count;
+        hostEngineParallel(engine, copyBlocks, &task);
+        bool ok = munmap(mapped, bytes) == 0;
+        return (close(fd) == 0) && ok;
+    }
+
+    // the file system can't map it (or it is empty): one big buffered write
+    FILE *file = fdopen(fd, "wb");
+    if (file == NULL) { close(fd); cout << "Couldn't write " << path << endl; return false;}
+    vector<char> buffer(WRITE_BUFFER_SIZE);
+    setvbuf(file, &buffer[0], _IOFBF, buffer.size());
+    bool ok = fwrite(values, sizeof(int), count, file) == count;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) cout << "Couldn't write " << path << endl;
+    return ok;
+}
+
+char *formatInt(int value, char *out)
+{
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int) value : (unsigned int) value;
+    if (value < 0) *out++ = '-';
+
+    // digits are produced from the right, two at a time, then copied in order
+    char digits[10];
+    char *end = digits + sizeof digits, *p = end;
+    while (magnitude >= 100)
+    {
+        unsigned int pair = (magnitude % 100) * 2;
+        magnitude /= 100;
+        *--p = digitPairs[pair + 1];
+        *--p = digitPairs[pair];
+    }
+    if (magnitude >= 10)
+    {
+        *--p = digitPairs[magnitude * 2 + 1];
+        *--p = digitPairs[magnitude * 2];
+    }
+    else *--p = (char) ('0' + magnitude);
+    while (p < end) *out++ = *p++;
+    return out;
+}
+
+/**
+    One round of writeText: block firstBlock + worker is formatted into buffers[worker].
+*/
+struct TextTask
+{
+    const int               *values;
+    size_t                  count;
+    size_t                  firstBlock;
+    vector<vector<char> >   buffers;
+    vector<size_t>          lengths;
+};
+
+static void formatBlocks(void *argument, unsigned worker, unsigned)
+{
+    TextTask *task = (TextTask*) argument;
+    size_t first = (task->firstBlock + worker) * TEXT_BLOCK;
+    task->lengths[worker] = 0;
+    if (first >= task->count) return;
+    size_t count = task->count - first < TEXT_BLOCK ? task->count - first : TEXT_BLOCK;
+
+    char *start = &task->buffers[worker][0], *out = start;
+    for (size_t i = first; i < first + count; i++)
+    {
+        out = formatInt(task->values[i], out);
+        memcpy(out, TEXT_SEPARATOR, sizeof TEXT_SEPARATOR - 1);
+        out += sizeof TEXT_SEPARATOR - 1;
+    }
+    task->lengths[worker] = out - start;
+}
+
+bool writeText(HostEngine *engine, const int *values, size_t count, FILE *out)
+{
+    unsigned numThreads = (unsigned) engine->threads.size();
+    TextTask task;
+    task.values = values;
+    task.count = count;
+    task.buffers.resize(numThreads, vector<char>(TEXT_BLOCK * MAX_TEXT_ELEMENT));
+    task.lengths.resize(numThreads);
+
+    bool ok = true;
+    size_t numBlocks = (count + TEXT_BLOCK - 1) / TEXT_BLOCK;
+    for (task.firstBlock = 0; task.firstBlock < numBlocks && ok; task.firstBlock += numThreads)
+    {
+        hostEngineParallel(engine, formatBlocks, &task);
+        for (unsigned t = 0; t < numThreads && ok; t++)
+            ok = fwrite(&task.buffers[t][0], 1, task.lengths[t], out) == task.lengths[t];
+    }
+    ok = ok && fputc('\n', out) != EOF;
+    return ok;
+}
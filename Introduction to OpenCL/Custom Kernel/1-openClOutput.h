@@ -0,0 +1,96 @@
+/**
+    Output stage of the results, replacing the per-element cout of the driver (which took far longer than the
+    device work). Three modes:
+    -> summary:  element count, checksum, min/max and the first/last N elements (the default)
+    -> binary:   the raw ints, written through a memory-mapped file (or a large buffered writer if mmap fails)
+    -> text:     the ints as decimal text, formatted in parallel by the threads of the host engine into large
+                 buffers that are then written in order
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLOUTPUT_H
+#define OPENCLOUTPUT_H
+
+#include <cstddef>
+#include <cstdio>
+#include "1-openClHostEngine.h"
+
+/**
+    Output modes of the results
+*/
+enum OutputMode
+{
+    OUTPUT_SUMMARY,         // checksum, min/max, first/last elements
+    OUTPUT_BINARY,          // raw native-endian ints
+    OUTPUT_TEXT             // decimal text, separated by three spaces (like the old cout loop)
+};
+
+/**
+    Summary of an array of results.
+    The checksum is the FNV-1a hash (see hashBytes in 1-openClProgramCache.h) of the hashes of consecutive blocks of
+    OUTPUT_BLOCK elements, so the blocks can be hashed in parallel and the value doesn't depend on the thread count.
+*/
+struct ResultSummary
+{
+    size_t                  count;
+    unsigned long long      checksum;
+    long long               sum;
+    int                     min;
+    int                     max;
+};
+
+#define OUTPUT_BLOCK    (1 << 20)       // elements per parallel block of the checksum and the binary copy
+
+/**
+    summarizeResults computes the summary of an array, with the threads of the host engine.
+    @param      engine          host engine
+    @param      values          results
+    @param      count           number of results
+    @return     summary         count, checksum, sum, min and max
+*/
+ResultSummary summarizeResults(HostEngine *engine, const int *values, size_t count);
+
+/**
+    writeSummary prints the summary of an array, and its first and last elements.
+    @param      engine          host engine
+    @param      values          results
+    @param      count           number of results
+    @param      edge            number of first and last elements printed
+    @param      out             destination of the summary
+*/
+void writeSummary(HostEngine *engine, const int *values, size_t count, size_t edge, FILE *out);
+
+/**
+    writeBinary writes the raw results to a file, through mmap (the file is sized with ftruncate, and the pages
+    copied in parallel), or a buffered fwrite with a large buffer when the file can't be mapped.
+    @param      engine          host engine
+    @param      values          results
+    @param      count           number of results
+    @param      path            destination file
+    @return     success         false if the file couldn't be written
+*/
+bool writeBinary(HostEngine *engine, const int *values, size_t count, const char *path);
+
+/**
+    formatInt writes the decimal text of an int, two digits at a time.
+    @param      value           value to format
+    @param      out             destination, with room for at least 11 characters
+    @return     end             one past the last character written
+*/
+char *formatInt(int value, char *out);
+
+/**
+    writeText writes the results as decimal text. The threads of the host engine each format one block of elements
+    into their own buffer, and the buffers are written in order, one round of blocks at a time.
+    @param      engine          host engine
+    @param      values          results
+    @param      count           number of results
+    @param      out             destination of the text
+    @return     success         false if the text couldn't be written
+*/
+bool writeText(HostEngine *engine, const int *values, size_t count, FILE *out);
+
+#endif
@@ -0,0 +1,189 @@
+/**
+    Event based profiler for the OpenCL driver. See 1-openClProfiler.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "1-openClProfiler.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+double wallClockMs()
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void profilerAddPhase(Profiler *profiler, const char *name, double milliseconds)
+{
+    ProfiledPhase phase;
+    phase.name = name;
+    phase.milliseconds = milliseconds;
+    profiler->phases.push_back(phase);
+}
+
+void profilerAddStage(Profiler *profiler, const char *name, cl_event event, size_t bytes, size_t elements)
+{
+    ProfiledStage stage;
+    stage.name = name;
+    stage.event = event;
+    stage.bytes = bytes;
+    stage.elements = elements;
+    profiler->stages.push_back(stage);
+}
+
+/**
+    Timestamps (in nanoseconds, device clock) of one stage. valid is false when the runtime could not profile it.
+*/
+struct StageTimes
+{
+    bool        valid;
+    cl_ulong    queued, submit, start, end;
+};
+
+static StageTimes readStageTimes(const ProfiledStage &stage)
+{
+    StageTimes t = {false, 0, 0, 0, 0};
+    cl_int clErr;
+    if (stage.event == NULL) return t;
+
+    clErr = clWaitForEvents(1, &stage.event);
+    if (clErr != CL_SUCCESS) { cout << "clWaitForEvents Error: " << checkError(clErr) << endl; return t;}
+    clErr  = clGetEventProfilingInfo(stage.event, CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &t.queued, NULL);
+    clErr |= clGetEventProfilingInfo(stage.event, CL_PROFILING_COMMAND_SUBMIT, sizeof(cl_ulong), &t.submit, NULL);
+    clErr |= clGetEventProfilingInfo(stage.event, CL_PROFILING_COMMAND_START,  sizeof(cl_ulong), &t.start,  NULL);
+    clErr |= clGetEventProfilingInfo(stage.event, CL_PROFILING_COMMAND_END,    sizeof(cl_ulong), &t.end,    NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetEventProfilingInfo Error on stage " << stage.name << endl; return t;}
+    t.valid = true;
+    return t;
+}
+
+void profilerReport(Profiler *profiler, ProfileFormat format, FILE *out)
+{
+    size_t i;
+    vector<StageTimes> times;
+    for (i = 0; i < profiler->stages.size(); i++)
+        times.push_back(readStageTimes(profiler->stages[i]));
+
+    // every stage is reported relative to the first queued command, so the timeline reads from 0
+    cl_ulong origin = 0;
+    for (i = 0; i < times.size(); i++)
+        if (times[i].valid && (origin == 0 || times[i].queued < origin)) origin = times[i].queued;
+
+    if (format == PROFILE_TEXT)
+    {
+        fprintf(out, "\nHost phases:\n");
+        for (i = 0; i < profiler->phases.size(); i++)
+            fprintf(out, "\t%-28s %12.3f ms\n", profiler->phases[i].name.c_str(), profiler->phases[i].milliseconds);
+
+        fprintf(out, "\nDevice stages (ms from first queued command):\n");
+        fprintf(out, "\t%-28s %10s %10s %10s %10s %10s %12s\n",
+                "stage", "queued", "submit", "start", "end", "duration", "throughput");
+        for (i = 0; i < profiler->stages.size(); i++)
+        {
+            const ProfiledStage &s = profiler->stages[i];
+            const StageTimes &t = times[i];
+            if (!t.valid) { fprintf(out, "\t%-28s %10s\n", s.name.c_str(), "n/a"); continue; }
+            double ns = (double) (t.end - t.start);
+            fprintf(out, "\t%-28s %10.3f %10.3f %10.3f %10.3f %10.3f ",
+                    s.name.c_str(), (t.queued - origin) * 1e-6, (t.submit - origin) * 1e-6,
+                    (t.start - origin) * 1e-6, (t.end - origin) * 1e-6, ns * 1e-6);
+            if (ns <= 0) fprintf(out, "%12s\n", "-");
+            else if (s.bytes > 0) fprintf(out, "%8.3f GB/s\n", s.bytes / ns);
+            else if (s.elements > 0) fprintf(out, "%6.3f Gelem/s\n", s.elements / ns);
+            else fprintf(out, "%12s\n", "-");
+        }
+    }
+    else if (format == PROFILE_CSV)
+    {
+        fprintf(out, "kind,name,queued_ns,submit_ns,start_ns,end_ns,duration_ms,bytes,elements,gb_per_s,elements_per_s\n");
+        for (i = 0; i < profiler->phases.size(); i++)
+            fprintf(out, "phase,%s,,,,,%.6f,,,,\n", profiler->phases[i].name.c_str(), profiler->phases[i].milliseconds);
+        for (i = 0; i < profiler->stages.size(); i++)
+        {
+            const ProfiledStage &s = profiler->stages[i];
+            const StageTimes &t = times[i];
+            if (!t.valid) { fprintf(out, "stage,%s,,,,,,%zu,%zu,,\n", s.name.c_str(), s.bytes, s.elements); continue; }
+            double ns = (double) (t.end - t.start);
+            fprintf(out, "stage,%s,%llu,%llu,%llu,%llu,%.6f,%zu,%zu,%.6f,%.1f\n", s.name.c_str(),
+                    (unsigned long long) (t.queued - origin), (unsigned long long) (t.submit - origin),
+                    (unsigned long long) (t.start - origin), (unsigned long long) (t.end - origin),
+                    ns * 1e-6, s.bytes, s.elements, ns > 0 ? s.bytes / ns : 0.0, ns > 0 ? s.elements / ns * 1e9 : 0.0);
+        }
+    }
+    else
+    {
+        fprintf(out, "{\n  \"phases\": [");
+        for (i = 0; i < profiler->phases.size(); i++)
+            fprintf(out, "%s\n    {\"name\": \"%s\", \"ms\": %.6f}", i ? "," : "",
+                    profiler->phases[i].name.c_str(), profiler->phases[i].milliseconds);
+        fprintf(out, "\n  ],\n  \"stages\": [");
+        for (i = 0; i < profiler->stages.size(); i++)
+        {
+            const ProfiledStage &s = profiler->stages[i];
+            const StageTimes &t = times[i];
+            fprintf(out, "%s\n    {\"name\": \"%s\", \"bytes\": %zu, \"elements\": %zu", i ? "," : "",
+                    s.name.c_str(), s.bytes, s.elements);
+            if (t.valid)
+            {
+                double ns = (double) (t.end - t.start);
+                fprintf(out, ", \"queued_ns\": %llu, \"submit_ns\": %llu, \"start_ns\": %llu, \"end_ns\": %llu"
+                             ", \"duration_ms\": %.6f, \"gb_per_s\": %.6f, \"elements_per_s\": %.1f",
+                        (unsigned long long) (t.queued - origin), (unsigned long long) (t.submit - origin),
+                        (unsigned long long) (t.start - origin), (unsigned long long) (t.end - origin),
+                        ns * 1e-6, ns > 0 ? s.bytes / ns : 0.0, ns > 0 ? s.elements / ns * 1e9 : 0.0);
+            }
+            fprintf(out, "}");
+        }
+        fprintf(out, "\n  ]\n}\n");
+    }
+    fflush(out);
+}
+
+double eventMilliseconds(cl_event event)
+{
+    ProfiledStage stage;
+    stage.name = "event";
+    stage.event = event;
+    StageTimes t = readStageTimes(stage);
+    return t.valid ? (t.end - t.start) * 1e-6 : -1;
+}
+
+// nearest rank percentile of sorted samples
+static double percentile(const vector<double> &sorted, double fraction)
+{
+    size_t rank = (size_t) ceil(fraction * sorted.size());
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+SampleStatistics sampleStatistics(vector<double> samples)
+{
+    SampleStatistics s = {samples.size(), 0, 0, 0, 0, 0, 0};
+    if (samples.empty()) return s;
+
+    sort(samples.begin(), samples.end());
+    s.min = samples[0];
+    s.median = samples.size() % 2 == 1 ? samples[samples.size() / 2]
+                                       : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2;
+    s.p90 = percentile(samples, 0.90);
+    s.p99 = percentile(samples, 0.99);
+    for (size_t i = 0; i < samples.size(); i++) s.mean += samples[i];
+    s.mean /= samples.size();
+    for (size_t i = 0; i < samples.size(); i++) s.stddev += (samples[i] - s.mean) * (samples[i] - s.mean);
+    s.stddev = samples.size() > 1 ? sqrt(s.stddev / (samples.size() - 1)) : 0;
+    return s;
+}
+
+void profilerRelease(Profiler *profiler)
+{
+    for (size_t i = 0; i < profiler->stages.size(); i++)
+        if (profiler->stages[i].event != NULL) clReleaseEvent(profiler->stages[i].event);
+    profiler->stages.clear();
+    profiler->phases.clear();
+}
@@ -0,0 +1,130 @@
+/**
+    Event based profiler for the OpenCL driver. Every enqueue of the driver hands its cl_event to the profiler, which
+    later reads the queued -> submit -> start -> end timestamps of each stage (the command queue must be created with
+    CL_QUEUE_PROFILING_ENABLE). Host side phases (platform discovery, program build, buffer creation...) are timed
+    with the wall clock. The report can be printed as human readable text, CSV or JSON.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLPROFILER_H
+#define OPENCLPROFILER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+/**
+    Output formats of the profiler report
+*/
+enum ProfileFormat
+{
+    PROFILE_TEXT,           // human readable table
+    PROFILE_CSV,            // one line per stage/phase, with header
+    PROFILE_JSON            // one object with "phases" and "stages" arrays
+};
+
+/**
+    One device side stage (a write, a kernel or a read), identified by the event of its enqueue.
+    bytes is the amount of memory moved by transfers (0 for kernels), elements the amount of elements processed by
+    kernels (0 for transfers).
+*/
+struct ProfiledStage
+{
+    std::string     name;
+    cl_event        event;
+    size_t          bytes;
+    size_t          elements;
+};
+
+/**
+    One host side phase, timed with the wall clock.
+*/
+struct ProfiledPhase
+{
+    std::string     name;
+    double          milliseconds;
+};
+
+/**
+    Summary of repeated measures of the same quantity (percentiles by nearest rank).
+*/
+struct SampleStatistics
+{
+    size_t      count;
+    double      min;
+    double      median;
+    double      p90;
+    double      p99;
+    double      mean;
+    double      stddev;
+};
+
+struct Profiler
+{
+    std::vector<ProfiledStage>  stages;
+    std::vector<ProfiledPhase>  phases;
+};
+
+/**
+    wallClockMs gives a monotonic wall clock time, to measure host side phases.
+    @return     milliseconds    time since an arbitrary (but fixed) point in the past
+*/
+double wallClockMs();
+
+/**
+    profilerAddPhase records the duration of one host side phase.
+    @param      profiler        profiler collecting the measurements
+    @param      name            name of the phase, as shown in the report
+    @param      milliseconds    duration of the phase (use wallClockMs() before and after it)
+*/
+void profilerAddPhase(Profiler *profiler, const char *name, double milliseconds);
+
+/**
+    profilerAddStage records one enqueued command. The profiler takes ownership of the event, and releases it in
+    profilerRelease. Passing a NULL event is allowed, and the stage is then skipped in the report.
+    @param      profiler        profiler collecting the measurements
+    @param      name            name of the stage, as shown in the report
+    @param      event           event returned by the clEnqueue* call
+    @param      bytes           bytes moved by the command (transfers), or 0
+    @param      elements        elements processed by the command (kernels), or 0
+*/
+void profilerAddStage(Profiler *profiler, const char *name, cl_event event, size_t bytes, size_t elements);
+
+/**
+    profilerReport waits for all the recorded events, and writes the report of every phase and stage.
+    @param      profiler        profiler with the measurements
+    @param      format          PROFILE_TEXT, PROFILE_CSV or PROFILE_JSON
+    @param      out             stream where the report is written (ex.: stdout, or an opened file)
+*/
+void profilerReport(Profiler *profiler, ProfileFormat format, FILE *out);
+
+/**
+    eventMilliseconds waits for an event, and gives the device time of its command (from START to END).
+    @param      event           event of a command enqueued on a queue with CL_QUEUE_PROFILING_ENABLE
+    @return     milliseconds    duration of the command, or -1 if the runtime could not profile it
+*/
+double eventMilliseconds(cl_event event);
+
+/**
+    sampleStatistics summarizes the measures of repeated runs.
+    @param      samples         measures (in any unit, milliseconds usually)
+    @return     statistics      count, min, median, p90, p99, mean and standard deviation (all 0 without samples)
+*/
+SampleStatistics sampleStatistics(std::vector<double> samples);
+
+/**
+    profilerRelease releases every event held by the profiler, and clears its measurements.
+    @param      profiler        profiler to be cleared
+*/
+void profilerRelease(Profiler *profiler);
+
+#endif
@@ -0,0 +1,223 @@
+/**
+    Persistent cache of compiled OpenCL programs. See 1-openClProgramCache.h for the description of each function.
+
+    Layout of one cache entry (<cacheDir>/<key>.clbin), a text header followed by the raw binary:
+        CLCACHE 1
+        <hash of the kernel source>
+        <build options>
+        <device name>
+        <driver version>
+        <milliseconds of the cold build>
+        <size of the binary> <checksum of the binary>
+        <binary bytes>
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "1-openClProgramCache.h"
+#include "1-openClProfiler.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+#define CACHE_MAGIC     "CLCACHE 1"
+#define FNV_OFFSET      14695981039346656037ULL
+#define FNV_PRIME       1099511628211ULL
+
+unsigned long long hashBytes(const void *data, size_t size, unsigned long long hash)
+{
+    const unsigned char *bytes = (const unsigned char*) data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+    Components of the cache key. The file name is the hash of all of them, and the header repeats them in full.
+*/
+struct CacheKey
+{
+    string      sourceHash;
+    string      options;
+    string      deviceName;
+    string      driverVersion;
+    string      fileName;
+};
+
+static CacheKey makeCacheKey(cl_device_id device, const char *source, size_t sourceSize, const char *options,
+                             const char *cacheDir)
+{
+    CacheKey key;
+    char hex[17];
+
+    snprintf(hex, sizeof hex, "%016llx", hashBytes(source, sourceSize, FNV_OFFSET));
+    key.sourceHash = hex;
+    key.options = options;
+    key.deviceName = deviceInfoString(device, CL_DEVICE_NAME);
+    key.driverVersion = deviceInfoString(device, CL_DRIVER_VERSION);
+
+    // '\0' separators, so that ("ab","c") and ("a","bc") don't hash the same
+    unsigned long long hash = FNV_OFFSET;
+    hash = hashBytes(key.sourceHash.c_str(), key.sourceHash.size() + 1, hash);
+    hash = hashBytes(key.options.c_str(), key.options.size() + 1, hash);
+    hash = hashBytes(key.deviceName.c_str(), key.deviceName.size() + 1, hash);
+    hash = hashBytes(key.driverVersion.c_str(), key.driverVersion.size() + 1, hash);
+    snprintf(hex, sizeof hex, "%016llx", hash);
+    key.fileName = string(cacheDir) + "/" + hex + ".clbin";
+    return key;
+}
+
+/**
+    Reads one line of the header (without the '\n'). Returns false at the end of the file.
+*/
+static bool readLine(FILE *file, string &line)
+{
+    line.clear();
+    int c;
+    while ((c = fgetc(file)) != EOF && c != '\n') line += (char) c;
+    return c == '\n';
+}
+
+/**
+    Loads the binary of a cache entry, checking every key component and the checksum.
+    Returns false (and leaves binary empty) on a miss.
+*/
+static bool loadCacheEntry(const CacheKey &key, vector<unsigned char> &binary, double *coldMilliseconds)
+{
+    FILE *file = fopen(key.fileName.c_str(), "rb");
+    if (file == NULL) return false;
+
+    string magic, sourceHash, options, deviceName, driverVersion, coldMs, sizes;
+    bool ok = readLine(file, magic) && readLine(file, sourceHash) && readLine(file, options) &&
+              readLine(file, deviceName) && readLine(file, driverVersion) && readLine(file, coldMs) &&
+              readLine(file, sizes);
+    ok = ok && magic == CACHE_MAGIC && sourceHash == key.sourceHash && options == key.options &&
+         deviceName == key.deviceName && driverVersion == key.driverVersion;
+
+    unsigned long long binarySize = 0, checksum = 0;
+    ok = ok && sscanf(sizes.c_str(), "%llu %llx", &binarySize, &checksum) == 2 && binarySize > 0;
+    if (ok)
+    {
+        binary.resize(binarySize);
+        ok = fread(&binary[0], 1, binarySize, file) == binarySize &&
+             hashBytes(&binary[0], binarySize, FNV_OFFSET) == checksum;
+    }
+    fclose(file);
+
+    if (!ok) { binary.clear(); return false;}
+    *coldMilliseconds = atof(coldMs.c_str());
+    return true;
+}
+
+/**
+    Stores the binary of a freshly built program. The entry is written to a temporary file of its own and renamed, so
+    that concurrent runs, or threads building for identical devices, never read or write a half written entry.
+    Returns false when the entry couldn't be stored (the program is still usable).
+*/
+static bool storeCacheEntry(const CacheKey &key, cl_program program, double coldMilliseconds, const char *cacheDir)
+{
+    cl_int clErr;
+    size_t binarySize;
+    clErr = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &binarySize, NULL);
+    if (clErr != CL_SUCCESS || binarySize == 0) { cout << "Program cache: no binary available, not caching." << endl; return false;}
+
+    vector<unsigned char> binary(binarySize);
+    unsigned char *binaries[] = {&binary[0]};
+    clErr = clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaries), binaries, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetProgramInfo Error: " << checkError(clErr) << endl; return false;}
+
+    mkdir(cacheDir, 0755);
+    string tmpName = temporaryFileName(key.fileName);
+    FILE *file = fopen(tmpName.c_str(), "wb");
+    if (file == NULL) { cout << "Program cache: couldn't write " << tmpName << endl; return false;}
+
+    fprintf(file, "%s\n%s\n%s\n%s\n%s\n%.3f\n%llu %016llx\n", CACHE_MAGIC, key.sourceHash.c_str(),
+            key.options.c_str(), key.deviceName.c_str(), key.driverVersion.c_str(), coldMilliseconds,
+            (unsigned long long) binarySize, hashBytes(&binary[0], binarySize, FNV_OFFSET));
+    bool ok = fwrite(&binary[0], 1, binarySize, file) == binarySize;
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok || rename(tmpName.c_str(), key.fileName.c_str()) != 0)
+    {
+        cout << "Program cache: couldn't write " << key.fileName << endl;
+        remove(tmpName.c_str());
+        return false;
+    }
+    return true;
+}
+
+cl_program buildProgramCached(cl_context context, cl_device_id device, const char *source, size_t sourceSize,
+                              const char *options, const char *cacheDir, ProgramCacheResult *result)
+{
+    cl_int clErr, binaryStatus;
+    cl_program program;
+    double start = wallClockMs();
+    double coldMilliseconds = 0;
+    CacheKey key;
+
+    // warm start: load the binary stored by a previous run
+    if (cacheDir != NULL)
+    {
+        key = makeCacheKey(device, source, sourceSize, options, cacheDir);
+        vector<unsigned char> binary;
+        if (loadCacheEntry(key, binary, &coldMilliseconds))
+        {
+            size_t binarySize = binary.size();
+            const unsigned char *binaries[] = {&binary[0]};
+            program = clCreateProgramWithBinary(context, 1, &device, &binarySize, binaries, &binaryStatus, &clErr);
+            if (clErr == CL_SUCCESS && binaryStatus == CL_SUCCESS)
+            {
+                clErr = clBuildProgram(program, 1, &device, options, NULL, NULL);
+                if (clErr == CL_SUCCESS)
+                {
+                    if (result != NULL)
+                    {
+                        result->warm = true;
+                        result->milliseconds = wallClockMs() - start;
+                        result->coldMilliseconds = coldMilliseconds;
+                        result->stored = false;
+                    }
+                    return program;
+                }
+                clReleaseProgram(program);
+            }
+            cout << "Program cache: stored binary rejected by the runtime, rebuilding from source." << endl;
+        }
+    }
+
+    // cold start: build from source
+    const char *sourceptr[] = {source};
+    program = clCreateProgramWithSource(context, 1, sourceptr, &sourceSize, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateProgramWithSource Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    clErr = clBuildProgram(program, 1, &device, options, NULL, NULL);
+    if (clErr != CL_SUCCESS)
+    {
+        cout << "clBuildProgram Error: " << checkError(clErr) << ". Log:" << endl;
+        printBuildLog(program, device);
+        exit(EXIT_FAILURE);
+    }
+    double milliseconds = wallClockMs() - start;
+
+    bool stored = cacheDir != NULL && storeCacheEntry(key, program, milliseconds, cacheDir);
+    if (result != NULL)
+    {
+        result->warm = false;
+        result->milliseconds = milliseconds;
+        result->coldMilliseconds = milliseconds;
+        result->stored = stored;
+    }
+    return program;
+}
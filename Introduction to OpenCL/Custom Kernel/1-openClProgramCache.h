@@ -0,0 +1,60 @@
+/**
+    Persistent cache of compiled OpenCL programs. The first build of a program (cold start) is done from source, and
+    its CL_PROGRAM_BINARIES are stored on disk. Later runs (warm start) load them back with clCreateProgramWithBinary.
+
+    Each cache entry is keyed by a hash of the kernel source, the build options, the device name and the driver
+    version. The file itself also stores every key component and a checksum of the binary, so a hash collision, a
+    truncated file or a binary rejected by the runtime just falls back to a build from source (which rewrites the entry).
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLPROGRAMCACHE_H
+#define OPENCLPROGRAMCACHE_H
+
+#include <cstddef>
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+/**
+    Outcome of buildProgramCached, for the startup report.
+*/
+struct ProgramCacheResult
+{
+    bool        warm;               // true when the program was loaded from the cache
+    double      milliseconds;       // time spent creating and building the program in this run
+    double      coldMilliseconds;   // time of the build from source that created the cache entry (0 if unknown)
+    bool        stored;             // true when the binary of a build from source was written to the cache
+};
+
+/**
+    hashBytes computes the 64 bit FNV-1a hash of a memory block, chained with a previous hash.
+    @param      data            memory block
+    @param      size            size of the block, in bytes
+    @param      hash            previous hash (use 14695981039346656037ULL to start a new one)
+    @return     hash            hash of the previous blocks and this one
+*/
+unsigned long long hashBytes(const void *data, size_t size, unsigned long long hash);
+
+/**
+    buildProgramCached creates a program for one device and builds it, using the on-disk cache when possible.
+    It exits the application (printing the build log) if the program fails to build from source.
+    @param      context         context of the device
+    @param      device          device that the program is built for
+    @param      source          kernel source
+    @param      sourceSize      length of the source, in bytes
+    @param      options         build options given to clBuildProgram
+    @param      cacheDir        directory of the cache (created if missing), or NULL to disable the cache
+    @param      result          filled with the cold/warm outcome and timings (may be NULL)
+    @return     program         built program, ready for clCreateKernel
+*/
+cl_program buildProgramCached(cl_context context, cl_device_id device, const char *source, size_t sourceSize,
+                              const char *options, const char *cacheDir, ProgramCacheResult *result);
+
+#endif
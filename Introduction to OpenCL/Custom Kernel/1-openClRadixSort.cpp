@@ -0,0 +1,177 @@
+/**
+    Radix sort engine. See 1-openClRadixSort.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include "1-openClRadixSort.h"
+#include "1-openClAutoTuner.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+#define RADIX_BUCKETS       16      // as in radixSortKernel.cl: 4 bits per pass
+
+bool radixSortFits(cl_device_id device, size_t numberOfElements, bool withValues)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(device);
+    size_t arrayBytes = numberOfElements * sizeof(cl_uint);
+    size_t copies = withValues ? 4 : 2;         // keys and payloads, and their temporary copies
+    return numberOfElements <= 0x7fffffff && arrayBytes <= caps.maxMemAllocSize &&
+           copies * arrayBytes <= caps.globalMemSize;
+}
+
+void radixSortCreate(RadixSortEngine *engine, KernelLibrary *library, cl_command_queue queue)
+{
+    engine->library = library;
+    engine->queue = queue;
+    scanCreate(&engine->scan, library, queue);
+    engine->tempKeys = NULL;
+    engine->tempValues = NULL;
+    engine->tempKeysCapacity = 0;
+    engine->tempValuesCapacity = 0;
+    engine->histograms = NULL;
+    engine->histogramCapacity = 0;
+
+    // the biggest power of two both kernels can run with
+    const char *names[] = {"radixHistogram", "radixScatter"};
+    size_t limit = RADIX_LOCAL_SIZE;
+    for (int k = 0; k < 2; k++)
+    {
+        size_t size;
+        cl_int clErr = clGetKernelWorkGroupInfo(kernelLibraryGet(library, names[k]), library->device,
+                                                CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &size, NULL);
+        if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        if (size < limit) limit = size;
+    }
+    engine->localSize = 1;
+    while (engine->localSize * 2 <= limit) engine->localSize *= 2;
+    engine->blockElements = engine->localSize * RADIX_BLOCK_CHUNKS;
+}
+
+// (re)creates a buffer that holds at least count uints
+static void reserve(cl_context context, cl_mem *buffer, size_t *capacity, size_t count)
+{
+    cl_int clErr;
+    if (*buffer != NULL && *capacity >= count) return;
+    if (*buffer != NULL) clReleaseMemObject(*buffer);
+    *buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, count * sizeof(cl_uint), NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    *capacity = count;
+}
+
+static void launch(RadixSortEngine *engine, cl_kernel kernel, size_t globalSize, size_t localSize,
+                   vector<cl_event> *events)
+{
+    cl_event event;
+    cl_int clErr = clEnqueueNDRangeKernel(engine->queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    events->push_back(event);
+}
+
+// radixEncodeKeys or radixDecodeKeys over the whole array
+static void convertKeys(RadixSortEngine *engine, const char *name, RadixKeyType keyType, cl_mem keys, cl_int n,
+                        vector<cl_event> *events)
+{
+    cl_int type = (cl_int) keyType;
+    cl_kernel kernel = kernelLibraryGet(engine->library, name);
+    cl_int clErr  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &keys);
+    clErr |= clSetKernelArg(kernel, 1, sizeof(cl_int), &n);
+    clErr |= clSetKernelArg(kernel, 2, sizeof(cl_int), &type);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    LaunchGeometry geometry = defaultGeometry(engine->library->device, kernel, (size_t) n);
+    launch(engine, kernel, geometry.globalSize, geometry.localSize, events);
+}
+
+RadixSortReport radixSort(RadixSortEngine *engine, RadixKeyType keyType, cl_mem keys, cl_mem values,
+                          size_t numberOfElements, Profiler *profiler)
+{
+    cl_int clErr;
+    RadixSortReport report = {0, 0, 0, 0};
+    if (numberOfElements < 2) return report;
+    double start = wallClockMs();
+    cl_context context = engine->library->context;
+    cl_int n = (cl_int) numberOfElements;
+    cl_int blockElements = (cl_int) engine->blockElements;
+    size_t blocks = (numberOfElements + engine->blockElements - 1) / engine->blockElements;
+    report.blocks = blocks;
+
+    reserve(context, &engine->tempKeys, &engine->tempKeysCapacity, numberOfElements);
+    if (values != NULL) reserve(context, &engine->tempValues, &engine->tempValuesCapacity, numberOfElements);
+    reserve(context, &engine->histograms, &engine->histogramCapacity, blocks * RADIX_BUCKETS);
+
+    vector<cl_event> events;
+    if (keyType != RADIX_UINT) convertKeys(engine, "radixEncodeKeys", keyType, keys, n, &events);
+
+    cl_kernel histogram = kernelLibraryGet(engine->library, "radixHistogram");
+    cl_kernel scatter = kernelLibraryGet(engine->library, "radixScatter");
+    size_t local = engine->localSize;
+    cl_mem noValues = NULL;
+    for (int pass = 0; pass < RADIX_PASSES; pass++)
+    {
+        // the passes go back and forth between the keys and the temporary copy, and end in the keys
+        cl_int shift = 4 * pass;
+        cl_mem keysIn = pass % 2 == 0 ? keys : engine->tempKeys;
+        cl_mem keysOut = pass % 2 == 0 ? engine->tempKeys : keys;
+        cl_mem valuesIn = values == NULL ? noValues : pass % 2 == 0 ? values : engine->tempValues;
+        cl_mem valuesOut = values == NULL ? noValues : pass % 2 == 0 ? engine->tempValues : values;
+
+        clErr  = clSetKernelArg(histogram, 0, sizeof(cl_mem), &keysIn);
+        clErr |= clSetKernelArg(histogram, 1, sizeof(cl_int), &n);
+        clErr |= clSetKernelArg(histogram, 2, sizeof(cl_int), &shift);
+        clErr |= clSetKernelArg(histogram, 3, sizeof(cl_int), &blockElements);
+        clErr |= clSetKernelArg(histogram, 4, sizeof(cl_mem), &engine->histograms);
+        clErr |= clSetKernelArg(histogram, 5, RADIX_BUCKETS * sizeof(cl_uint), NULL);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        launch(engine, histogram, blocks * local, local, &events);
+
+        // first output position of each digit of each block
+        ScanReport scanned = scanBuffer(&engine->scan, SCAN_EXCLUSIVE, SCAN_AUTO, engine->histograms,
+                                        engine->histograms, blocks * RADIX_BUCKETS, profiler);
+        report.kernels += scanned.kernels;
+        report.kernelMs += scanned.kernelMs;
+
+        clErr  = clSetKernelArg(scatter, 0, sizeof(cl_mem), &keysIn);
+        clErr |= clSetKernelArg(scatter, 1, sizeof(cl_mem), &valuesIn);
+        clErr |= clSetKernelArg(scatter, 2, sizeof(cl_mem), &keysOut);
+        clErr |= clSetKernelArg(scatter, 3, sizeof(cl_mem), &valuesOut);
+        clErr |= clSetKernelArg(scatter, 4, sizeof(cl_int), &n);
+        clErr |= clSetKernelArg(scatter, 5, sizeof(cl_int), &shift);
+        clErr |= clSetKernelArg(scatter, 6, sizeof(cl_int), &blockElements);
+        clErr |= clSetKernelArg(scatter, 7, sizeof(cl_mem), &engine->histograms);
+        clErr |= clSetKernelArg(scatter, 8, local * sizeof(cl_uint), NULL);
+        clErr |= clSetKernelArg(scatter, 9, local * sizeof(cl_uint), NULL);
+        clErr |= clSetKernelArg(scatter, 10, local * sizeof(cl_uint), NULL);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        launch(engine, scatter, blocks * local, local, &events);
+    }
+
+    if (keyType != RADIX_UINT) convertKeys(engine, "radixDecodeKeys", keyType, keys, n, &events);
+    clErr = clFinish(engine->queue);
+    if (clErr != CL_SUCCESS) { cout << "clFinish Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    report.wallMs = wallClockMs() - start;
+
+    for (size_t e = 0; e < events.size(); e++)
+    {
+        double ms = eventMilliseconds(events[e]);
+        if (ms > 0) report.kernelMs += ms;
+        if (profiler != NULL) profilerAddStage(profiler, "radix sort", events[e], 0, numberOfElements);
+        else clReleaseEvent(events[e]);
+    }
+    report.kernels += events.size();
+    return report;
+}
+
+void radixSortRelease(RadixSortEngine *engine)
+{
+    scanRelease(&engine->scan);
+    if (engine->tempKeys != NULL) clReleaseMemObject(engine->tempKeys);
+    if (engine->tempValues != NULL) clReleaseMemObject(engine->tempValues);
+    if (engine->histograms != NULL) clReleaseMemObject(engine->histograms);
+}
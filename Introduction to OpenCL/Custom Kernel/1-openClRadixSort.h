@@ -0,0 +1,108 @@
+/**
+    Radix sort engine (radixSortKernel.cl): stable LSD radix sort of 32-bit int, uint or float keys on the device,
+    4 bits per pass (8 passes), with an optional 32-bit payload per key. Each pass counts the digits of every block of
+    the array (one work-group per block), scans the counts with the scan engine (1-openClScan.h) into the output
+    position of each digit of each block, and scatters the keys, staged and sorted by digit in __local memory so the
+    writes of a work-group are coalesced.
+
+    The sort is done in place, through a temporary copy of the keys (and payloads) that the engine keeps between
+    sorts: the device needs room for two copies of everything (radixSortFits).
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLRADIXSORT_H
+#define OPENCLRADIXSORT_H
+
+#include <cstddef>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+#include "1-openClScan.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define RADIX_LOCAL_SIZE        256     // biggest work-group size (a power of two)
+#define RADIX_BLOCK_CHUNKS      16      // chunks of work-group size in each block
+#define RADIX_PASSES            8       // 32-bit keys, 4 bits per pass
+
+enum RadixKeyType
+{
+    RADIX_UINT,             // values match RADIX_KEY_* in radixSortKernel.cl
+    RADIX_INT,
+    RADIX_FLOAT             // NaNs are sorted by their bits, -0.0 before 0.0
+};
+
+/**
+    Kernels of one device, and the buffers reused between sorts.
+*/
+struct RadixSortEngine
+{
+    KernelLibrary       *library;
+    cl_command_queue    queue;
+    ScanEngine          scan;
+    size_t              localSize;
+    size_t              blockElements;      // elements of the block of one work-group
+    cl_mem              tempKeys;
+    cl_mem              tempValues;
+    size_t              tempKeysCapacity;   // keys tempKeys can hold
+    size_t              tempValuesCapacity; // payloads tempValues can hold
+    cl_mem              histograms;         // RADIX_BUCKETS counts per block
+    size_t              histogramCapacity;  // counts histograms can hold
+};
+
+/**
+    Cost of one sort.
+*/
+struct RadixSortReport
+{
+    size_t      blocks;         // work-groups of each pass
+    size_t      kernels;        // kernels launched, scans included
+    double      kernelMs;       // device time of the kernels
+    double      wallMs;         // wall time of the whole sort
+};
+
+/**
+    radixSortFits tells whether the device can sort an array: every buffer within CL_DEVICE_MAX_MEM_ALLOC_SIZE, and
+    the arrays with their temporary copies within CL_DEVICE_GLOBAL_MEM_SIZE.
+    @param      device          device running the sort
+    @param      numberOfElements    keys to sort (at most 0x7fffffff)
+    @param      withValues      true if the keys have payloads
+    @return     fits            true if the sort can run on the device
+*/
+bool radixSortFits(cl_device_id device, size_t numberOfElements, bool withValues);
+
+/**
+    radixSortCreate picks the work-group size and creates the scan engine.
+    @param      engine          engine to be created
+    @param      library         kernel library of the device, with radixSortKernel.cl and scanKernel.cl built in
+    @param      queue           command queue of the device, created with CL_QUEUE_PROFILING_ENABLE
+*/
+void radixSortCreate(RadixSortEngine *engine, KernelLibrary *library, cl_command_queue queue);
+
+/**
+    radixSort sorts keys (and moves their payloads along) in place, and waits for the result. Equal keys keep the
+    order they had.
+    @param      engine          engine created by radixSortCreate
+    @param      keyType         RADIX_UINT, RADIX_INT or RADIX_FLOAT
+    @param      keys            keys to sort
+    @param      values          one 32-bit payload per key, or NULL
+    @param      numberOfElements    keys to sort (see radixSortFits)
+    @param      profiler        profiler recording every kernel (may be NULL)
+    @return     report          blocks, kernels and timings
+*/
+RadixSortReport radixSort(RadixSortEngine *engine, RadixKeyType keyType, cl_mem keys, cl_mem values,
+                          size_t numberOfElements, Profiler *profiler);
+
+/**
+    radixSortRelease releases the buffers of the engine (the kernels belong to the library).
+    @param      engine          engine to be released
+*/
+void radixSortRelease(RadixSortEngine *engine);
+
+#endif
@@ -0,0 +1,208 @@
+/**
+    Reduction engine. See 1-openClReduction.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <climits>
+#include <string>
+#include "1-openClReduction.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+// kernels of reduceKernel.cl, per operation and element type
+static const char *firstPassKernels[4][2] = {
+    {"reduceSumInt",    "reduceSumFloat"},
+    {"reduceMinInt",    "reduceMinFloat"},
+    {"reduceMaxInt",    "reduceMaxFloat"},
+    {"reduceArgMaxInt", "reduceArgMaxFloat"}
+};
+
+const char *reduceOperationName(ReduceOperation operation)
+{
+    switch (operation) {
+        case REDUCE_SUM:    return "sum";
+        case REDUCE_MIN:    return "min";
+        case REDUCE_MAX:    return "max";
+        case REDUCE_ARGMAX: return "argmax";
+    }
+    return "unknown";
+}
+
+static cl_mem createBuffer(cl_context context, size_t bytes)
+{
+    cl_int clErr;
+    cl_mem buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, bytes, NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    return buffer;
+}
+
+void reductionCreate(ReductionEngine *engine, KernelLibrary *library, cl_command_queue queue)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(library->device);
+    engine->library = library;
+    engine->queue = queue;
+    engine->maxGroups = (caps.computeUnits > 0 ? caps.computeUnits : 1) * REDUCE_GROUPS_PER_CU;
+    engine->subGroups = hasExtension(caps, "cl_khr_subgroups");
+    engine->partials = createBuffer(library->context, engine->maxGroups * sizeof(cl_long));
+    engine->partialIndices = createBuffer(library->context, engine->maxGroups * sizeof(cl_int));
+    engine->result = createBuffer(library->context, sizeof(cl_long));
+    engine->resultIndex = createBuffer(library->context, sizeof(cl_int));
+}
+
+// biggest power of two work-group size the kernel can run with, up to REDUCE_LOCAL_SIZE
+static size_t reduceLocalSize(cl_kernel kernel, cl_device_id device)
+{
+    size_t kernelMax = REDUCE_LOCAL_SIZE;
+    cl_int clErr = clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &kernelMax, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    size_t local = 1;
+    while (local * 2 <= kernelMax && local * 2 <= REDUCE_LOCAL_SIZE) local *= 2;
+    return local;
+}
+
+// launches one pass, and records (or releases) its event
+static void launchPass(ReductionEngine *engine, cl_kernel kernel, size_t groups, size_t local, const string &stage,
+                       size_t elements, Profiler *profiler, ReduceResult *result)
+{
+    cl_event event;
+    size_t global = groups * local;
+    cl_int clErr = clEnqueueNDRangeKernel(engine->queue, kernel, 1, NULL, &global, &local, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    double ms = eventMilliseconds(event);
+    if (ms > 0) result->kernelMs += ms;
+    result->passes++;
+    if (profiler != NULL) profilerAddStage(profiler, stage.c_str(), event, 0, elements);
+    else clReleaseEvent(event);
+}
+
+// reads back a small result, and records (or releases) its event
+static void readResult(ReductionEngine *engine, cl_mem buffer, size_t bytes, void *value, const string &stage,
+                       Profiler *profiler, ReduceResult *result)
+{
+    cl_event event;
+    cl_int clErr = clEnqueueReadBuffer(engine->queue, buffer, CL_TRUE, 0, bytes, value, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueReadBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    result->bytesRead += bytes;
+    if (profiler != NULL) profilerAddStage(profiler, stage.c_str(), event, bytes, 0);
+    else clReleaseEvent(event);
+}
+
+ReduceResult reduceBuffer(ReductionEngine *engine, ReduceOperation operation, ReduceElement element, cl_mem values,
+                          size_t numberOfElements, Profiler *profiler)
+{
+    cl_int clErr;
+    ReduceResult result = {0, 0, -1, 0, 0, 0};
+    cl_device_id device = engine->library->device;
+    cl_kernel first = kernelLibraryGet(engine->library, firstPassKernels[operation][element]);
+    string prefix = string("reduce ") + reduceOperationName(operation) + (element == REDUCE_INT ? " int: " : " float: ");
+    cl_int n = (cl_int) numberOfElements;
+    size_t local = reduceLocalSize(first, device);
+    size_t groups = (numberOfElements + local - 1) / local;
+    if (groups > engine->maxGroups) groups = engine->maxGroups;
+    if (groups == 0) groups = 1;
+
+    // bytes of one accumulated value: int sums are accumulated in long
+    size_t valueSize = operation == REDUCE_SUM && element == REDUCE_INT ? sizeof(cl_long) : sizeof(cl_int);
+
+    // int min and max: a single pass, the work-groups combine into result with an atomic
+    if (element == REDUCE_INT && (operation == REDUCE_MIN || operation == REDUCE_MAX))
+    {
+        cl_int identity = operation == REDUCE_MIN ? INT_MAX : INT_MIN;
+        clErr = clEnqueueWriteBuffer(engine->queue, engine->result, CL_TRUE, 0, sizeof(cl_int), &identity, 0, NULL, NULL);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        clErr  = clSetKernelArg(first, 0, sizeof(cl_mem), &values);
+        clErr |= clSetKernelArg(first, 1, sizeof(cl_int), &n);
+        clErr |= clSetKernelArg(first, 2, sizeof(cl_mem), &engine->result);
+        clErr |= clSetKernelArg(first, 3, local * sizeof(cl_int), NULL);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        launchPass(engine, first, groups, local, prefix + "atomic pass", numberOfElements, profiler, &result);
+
+        cl_int value;
+        readResult(engine, engine->result, sizeof(cl_int), &value, prefix + "read result", profiler, &result);
+        result.integer = value;
+        return result;
+    }
+
+    // first pass: one partial per work-group
+    cl_mem noIndices = NULL;
+    clErr = clSetKernelArg(first, 0, sizeof(cl_mem), &values);
+    if (operation == REDUCE_ARGMAX)
+    {
+        clErr |= clSetKernelArg(first, 1, sizeof(cl_mem), &noIndices);
+        clErr |= clSetKernelArg(first, 2, sizeof(cl_int), &n);
+        clErr |= clSetKernelArg(first, 3, sizeof(cl_mem), &engine->partials);
+        clErr |= clSetKernelArg(first, 4, sizeof(cl_mem), &engine->partialIndices);
+        clErr |= clSetKernelArg(first, 5, local * valueSize, NULL);
+        clErr |= clSetKernelArg(first, 6, local * sizeof(cl_int), NULL);
+    }
+    else
+    {
+        clErr |= clSetKernelArg(first, 1, sizeof(cl_int), &n);
+        clErr |= clSetKernelArg(first, 2, sizeof(cl_mem), &engine->partials);
+        clErr |= clSetKernelArg(first, 3, local * valueSize, NULL);
+    }
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    launchPass(engine, first, groups, local, prefix + "first pass", numberOfElements, profiler, &result);
+
+    // second pass: one work-group reduces the partials (the int sum continues on longs)
+    cl_mem finalValue = engine->partials, finalIndex = engine->partialIndices;
+    if (groups > 1)
+    {
+        cl_kernel second = operation == REDUCE_SUM && element == REDUCE_INT ?
+                           kernelLibraryGet(engine->library, "reduceSumLong") : first;
+        size_t secondLocal = reduceLocalSize(second, device);
+        cl_int partialCount = (cl_int) groups;
+        clErr = clSetKernelArg(second, 0, sizeof(cl_mem), &engine->partials);
+        if (operation == REDUCE_ARGMAX)
+        {
+            clErr |= clSetKernelArg(second, 1, sizeof(cl_mem), &engine->partialIndices);
+            clErr |= clSetKernelArg(second, 2, sizeof(cl_int), &partialCount);
+            clErr |= clSetKernelArg(second, 3, sizeof(cl_mem), &engine->result);
+            clErr |= clSetKernelArg(second, 4, sizeof(cl_mem), &engine->resultIndex);
+            clErr |= clSetKernelArg(second, 5, secondLocal * valueSize, NULL);
+            clErr |= clSetKernelArg(second, 6, secondLocal * sizeof(cl_int), NULL);
+        }
+        else
+        {
+            clErr |= clSetKernelArg(second, 1, sizeof(cl_int), &partialCount);
+            clErr |= clSetKernelArg(second, 2, sizeof(cl_mem), &engine->result);
+            clErr |= clSetKernelArg(second, 3, secondLocal * valueSize, NULL);
+        }
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        launchPass(engine, second, 1, secondLocal, prefix + "second pass", groups, profiler, &result);
+        finalValue = engine->result;
+        finalIndex = engine->resultIndex;
+    }
+
+    if (element == REDUCE_FLOAT)
+        readResult(engine, finalValue, sizeof(float), &result.real, prefix + "read result", profiler, &result);
+    else if (valueSize == sizeof(cl_long))
+        readResult(engine, finalValue, sizeof(cl_long), &result.integer, prefix + "read result", profiler, &result);
+    else
+    {
+        cl_int value;
+        readResult(engine, finalValue, sizeof(cl_int), &value, prefix + "read result", profiler, &result);
+        result.integer = value;
+    }
+    if (operation == REDUCE_ARGMAX)
+    {
+        readResult(engine, finalIndex, sizeof(cl_int), &result.index, prefix + "read index", profiler, &result);
+        if (result.index == INT_MAX) result.index = -1;         // no element
+    }
+    return result;
+}
+
+void reductionRelease(ReductionEngine *engine)
+{
+    clReleaseMemObject(engine->partials);
+    clReleaseMemObject(engine->partialIndices);
+    clReleaseMemObject(engine->result);
+    clReleaseMemObject(engine->resultIndex);
+}
@@ -0,0 +1,108 @@
+/**
+    Reduction engine (reduceKernel.cl): sum, min, max and argmax of an int or float device buffer, so a job can
+    read back one scalar instead of its whole output.
+
+    The first pass runs a few work-groups per compute unit. Each work-item accumulates a grid-stride slice of the
+    buffer, and the work-group combines its work-items: with sub-group reductions when the device has
+    cl_khr_subgroups, through a tree in __local memory otherwise. The results of the work-groups are then combined
+    either by a 32-bit atomic within the same pass (int min and max), or by a second pass of one work-group over the
+    partials (sums, float min and max, and argmax). int sums are computed in 64 bits.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLREDUCTION_H
+#define OPENCLREDUCTION_H
+
+#include <cstddef>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define REDUCE_LOCAL_SIZE       256     // biggest work-group size (a power of two, as the local tree needs)
+#define REDUCE_GROUPS_PER_CU    8       // work-groups per compute unit in the first pass
+
+enum ReduceOperation
+{
+    REDUCE_SUM,
+    REDUCE_MIN,
+    REDUCE_MAX,
+    REDUCE_ARGMAX           // largest value, and the first index holding it
+};
+
+enum ReduceElement
+{
+    REDUCE_INT,
+    REDUCE_FLOAT
+};
+
+/**
+    Kernels of one device, and the small buffers of the partial results.
+*/
+struct ReductionEngine
+{
+    KernelLibrary       *library;
+    cl_command_queue    queue;
+    size_t              maxGroups;          // work-groups of the first pass, at most
+    bool                subGroups;          // the device has cl_khr_subgroups
+    cl_mem              partials;           // one value per work-group of the first pass (8 bytes each)
+    cl_mem              partialIndices;     // one index per work-group of the first pass (argmax)
+    cl_mem              result;             // final value (8 bytes)
+    cl_mem              resultIndex;        // final index (argmax)
+};
+
+/**
+    Result of one reduction. int sums are 64-bit.
+*/
+struct ReduceResult
+{
+    cl_long     integer;        // result of an int reduction
+    float       real;           // result of a float reduction
+    cl_int      index;          // argmax: index of the largest value (-1 for an empty buffer)
+    size_t      passes;         // kernels launched (1 or 2)
+    size_t      bytesRead;      // bytes read back from the device
+    double      kernelMs;       // device time of the kernels
+};
+
+/**
+    reductionCreate allocates the buffers of the partial results.
+    @param      engine          engine to be created
+    @param      library         kernel library of the device, with reduceKernel.cl built in
+    @param      queue           command queue of the device, created with CL_QUEUE_PROFILING_ENABLE
+*/
+void reductionCreate(ReductionEngine *engine, KernelLibrary *library, cl_command_queue queue);
+
+/**
+    reduceBuffer reduces a device buffer, and reads back the result (blocking).
+    @param      engine          engine created by reductionCreate
+    @param      operation       REDUCE_SUM, REDUCE_MIN, REDUCE_MAX or REDUCE_ARGMAX
+    @param      element         REDUCE_INT or REDUCE_FLOAT, the type of the elements in values
+    @param      values          buffer to reduce
+    @param      numberOfElements    elements of the buffer (at most 0x7fffffff)
+    @param      profiler        profiler recording the kernels and the read (may be NULL)
+    @return     result          value (and index for argmax), and the cost of the reduction
+*/
+ReduceResult reduceBuffer(ReductionEngine *engine, ReduceOperation operation, ReduceElement element, cl_mem values,
+                          size_t numberOfElements, Profiler *profiler);
+
+/**
+    reduceOperationName gives the name of an operation.
+    @param      operation       operation
+    @return     name            "sum", "min", "max" or "argmax"
+*/
+const char *reduceOperationName(ReduceOperation operation);
+
+/**
+    reductionRelease releases the buffers of the engine (the kernels belong to the library).
+    @param      engine          engine to be released
+*/
+void reductionRelease(ReductionEngine *engine);
+
+#endif
@@ -0,0 +1,207 @@
+/**
+    Scan engine. See 1-openClScan.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include "1-openClScan.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+#define SCAN_LOG_BANKS      5       // as in scanKernel.cl: one padding int every 32 ints of __local memory
+
+const char *scanAlgorithmName(ScanAlgorithm algorithm)
+{
+    switch (algorithm) {
+        case SCAN_AUTO:                 return "auto";
+        case SCAN_MULTI_LEVEL:          return "multi-level";
+        case SCAN_DECOUPLED_LOOKBACK:   return "decoupled lookback";
+    }
+    return "unknown";
+}
+
+// bytes of __local memory of one tile, padding included
+static size_t tileLocalBytes(size_t localSize)
+{
+    size_t tile = 2 * localSize;
+    return (tile + (tile >> SCAN_LOG_BANKS)) * sizeof(cl_int);
+}
+
+static size_t kernelWorkGroupSize(cl_kernel kernel, cl_device_id device)
+{
+    size_t size;
+    cl_int clErr = clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &size, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    return size;
+}
+
+void scanCreate(ScanEngine *engine, KernelLibrary *library, cl_command_queue queue)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(library->device);
+    engine->library = library;
+    engine->queue = queue;
+    engine->status = NULL;
+    engine->ticket = NULL;
+    engine->statusCapacity = 0;
+
+    // biggest power of two that the kernels, and the __local memory of the device, allow
+    size_t limit = kernelWorkGroupSize(kernelLibraryGet(library, "scanTiles"), library->device);
+    size_t addLimit = kernelWorkGroupSize(kernelLibraryGet(library, "scanAddOffsets"), library->device);
+    if (addLimit < limit) limit = addLimit;
+    engine->localSize = 1;
+    while (engine->localSize * 2 <= limit && engine->localSize * 2 <= SCAN_LOCAL_SIZE &&
+           tileLocalBytes(engine->localSize * 2) <= caps.localMemSize)
+        engine->localSize *= 2;
+
+    // the lookback spins on other work-groups: GPUs only, and it publishes its status with 64-bit atomics
+    engine->lookback = (caps.type & CL_DEVICE_TYPE_GPU) != 0 && hasExtension(caps, "cl_khr_int64_base_atomics");
+    if (engine->lookback &&
+        kernelWorkGroupSize(kernelLibraryGet(library, "scanDecoupled"), library->device) < engine->localSize)
+        engine->lookback = false;
+}
+
+// tile totals of one level, grown to hold count ints
+static cl_mem levelBuffer(ScanEngine *engine, size_t level, size_t count)
+{
+    cl_int clErr;
+    if (engine->levels.size() <= level)
+    {
+        engine->levels.push_back(NULL);
+        engine->levelCapacity.push_back(0);
+    }
+    if (engine->levelCapacity[level] < count)
+    {
+        if (engine->levels[level] != NULL) clReleaseMemObject(engine->levels[level]);
+        engine->levels[level] = clCreateBuffer(engine->library->context, CL_MEM_READ_WRITE, count * sizeof(cl_int),
+                                               NULL, &clErr);
+        if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        engine->levelCapacity[level] = count;
+    }
+    return engine->levels[level];
+}
+
+static void launch(ScanEngine *engine, cl_kernel kernel, size_t tiles, vector<cl_event> *events)
+{
+    cl_event event;
+    size_t local = engine->localSize;
+    size_t global = tiles * local;
+    cl_int clErr = clEnqueueNDRangeKernel(engine->queue, kernel, 1, NULL, &global, &local, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    events->push_back(event);
+}
+
+/**
+    One level of the multi-level scan: scans every tile, scans the tile totals (the next level), and adds them back.
+*/
+static void scanLevel(ScanEngine *engine, cl_int inclusive, cl_mem input, cl_mem output, size_t numberOfElements,
+                      size_t level, vector<cl_event> *events, ScanReport *report)
+{
+    cl_int clErr;
+    size_t tiles = (numberOfElements + 2 * engine->localSize - 1) / (2 * engine->localSize);
+    cl_mem tileSums = tiles > 1 ? levelBuffer(engine, level, tiles) : NULL;
+    cl_int n = (cl_int) numberOfElements;
+    if (level + 1 > report->levels) report->levels = level + 1;
+
+    cl_kernel scanTiles = kernelLibraryGet(engine->library, "scanTiles");
+    clErr  = clSetKernelArg(scanTiles, 0, sizeof(cl_mem), &input);
+    clErr |= clSetKernelArg(scanTiles, 1, sizeof(cl_mem), &output);
+    clErr |= clSetKernelArg(scanTiles, 2, sizeof(cl_int), &n);
+    clErr |= clSetKernelArg(scanTiles, 3, sizeof(cl_int), &inclusive);
+    clErr |= clSetKernelArg(scanTiles, 4, sizeof(cl_mem), &tileSums);
+    clErr |= clSetKernelArg(scanTiles, 5, tileLocalBytes(engine->localSize), NULL);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    launch(engine, scanTiles, tiles, events);
+    if (tiles == 1) return;
+
+    // the totals become the offsets of the tiles, scanned in place
+    scanLevel(engine, 0, tileSums, tileSums, tiles, level + 1, events, report);
+    cl_kernel addOffsets = kernelLibraryGet(engine->library, "scanAddOffsets");
+    clErr  = clSetKernelArg(addOffsets, 0, sizeof(cl_mem), &output);
+    clErr |= clSetKernelArg(addOffsets, 1, sizeof(cl_mem), &tileSums);
+    clErr |= clSetKernelArg(addOffsets, 2, sizeof(cl_int), &n);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    launch(engine, addOffsets, tiles, events);
+}
+
+/**
+    Single pass scan with decoupled lookback. The status of every tile and the ticket are cleared first.
+*/
+static void scanSinglePass(ScanEngine *engine, cl_int inclusive, cl_mem input, cl_mem output, size_t numberOfElements,
+                           vector<cl_event> *events)
+{
+    cl_int clErr;
+    size_t tiles = (numberOfElements + 2 * engine->localSize - 1) / (2 * engine->localSize);
+    if (engine->statusCapacity < tiles)
+    {
+        if (engine->status != NULL) clReleaseMemObject(engine->status);
+        engine->status = clCreateBuffer(engine->library->context, CL_MEM_READ_WRITE, tiles * sizeof(cl_long), NULL, &clErr);
+        if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        engine->statusCapacity = tiles;
+    }
+    if (engine->ticket == NULL)
+    {
+        engine->ticket = clCreateBuffer(engine->library->context, CL_MEM_READ_WRITE, sizeof(cl_int), NULL, &clErr);
+        if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    }
+    cl_long zero = 0;
+    clErr  = clEnqueueFillBuffer(engine->queue, engine->status, &zero, sizeof(cl_long), 0, tiles * sizeof(cl_long), 0,
+                                 NULL, NULL);
+    clErr |= clEnqueueFillBuffer(engine->queue, engine->ticket, &zero, sizeof(cl_int), 0, sizeof(cl_int), 0, NULL, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueFillBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    cl_int n = (cl_int) numberOfElements;
+    cl_kernel kernel = kernelLibraryGet(engine->library, "scanDecoupled");
+    clErr  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &input);
+    clErr |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &output);
+    clErr |= clSetKernelArg(kernel, 2, sizeof(cl_int), &n);
+    clErr |= clSetKernelArg(kernel, 3, sizeof(cl_int), &inclusive);
+    clErr |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &engine->status);
+    clErr |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &engine->ticket);
+    clErr |= clSetKernelArg(kernel, 6, tileLocalBytes(engine->localSize), NULL);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    launch(engine, kernel, tiles, events);
+}
+
+ScanReport scanBuffer(ScanEngine *engine, ScanKind kind, ScanAlgorithm algorithm, cl_mem input, cl_mem output,
+                      size_t numberOfElements, Profiler *profiler)
+{
+    ScanReport report = {SCAN_MULTI_LEVEL, 1, 0, 0, 0};
+    if (numberOfElements == 0) return report;
+    cl_int inclusive = kind == SCAN_INCLUSIVE ? 1 : 0;
+    if (algorithm != SCAN_MULTI_LEVEL && engine->lookback) report.algorithm = SCAN_DECOUPLED_LOOKBACK;
+
+    vector<cl_event> events;
+    if (report.algorithm == SCAN_DECOUPLED_LOOKBACK) scanSinglePass(engine, inclusive, input, output, numberOfElements, &events);
+    else scanLevel(engine, inclusive, input, output, numberOfElements, 0, &events, &report);
+    cl_int clErr = clFinish(engine->queue);
+    if (clErr != CL_SUCCESS) { cout << "clFinish Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    string stage = string("scan ") + (inclusive ? "inclusive" : "exclusive") + " (" + scanAlgorithmName(report.algorithm) + ")";
+    for (size_t e = 0; e < events.size(); e++)
+    {
+        double ms = eventMilliseconds(events[e]);
+        if (ms > 0) report.kernelMs += ms;
+        if (profiler != NULL) profilerAddStage(profiler, stage.c_str(), events[e], 0, numberOfElements);
+        else clReleaseEvent(events[e]);
+    }
+    report.kernels = events.size();
+    if (report.kernelMs > 0) report.gbPerSecond = 2.0 * numberOfElements * sizeof(cl_int) / (report.kernelMs * 1e6);
+    return report;
+}
+
+void scanRelease(ScanEngine *engine)
+{
+    for (size_t l = 0; l < engine->levels.size(); l++)
+        if (engine->levels[l] != NULL) clReleaseMemObject(engine->levels[l]);
+    engine->levels.clear();
+    engine->levelCapacity.clear();
+    if (engine->status != NULL) clReleaseMemObject(engine->status);
+    if (engine->ticket != NULL) clReleaseMemObject(engine->ticket);
+}
@@ -0,0 +1,112 @@
+/**
+    Scan engine (scanKernel.cl): exclusive and inclusive prefix sums of an int device buffer, of any size up to
+    0x7fffffff elements. Each work-group scans a tile of twice its size in __local memory (Blelloch up-sweep and
+    down-sweep, with padded indexing against bank conflicts), and the tiles are combined either:
+
+    - in a single pass with decoupled lookback: each tile publishes its total, and adds up the totals of the tiles
+      before it until it meets a published prefix. Only used on GPUs with cl_khr_int64_base_atomics, as a tile
+      waits on the work-groups that started before it.
+    - in several levels (the fallback, on every device): the totals of the tiles are scanned by the same kernels,
+      recursively, then added back to each tile.
+
+    The sums wrap around, like int additions on the host.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLSCAN_H
+#define OPENCLSCAN_H
+
+#include <cstddef>
+#include <vector>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define SCAN_LOCAL_SIZE         256     // biggest work-group size (a power of two), each scans 2 * size elements
+
+enum ScanKind
+{
+    SCAN_EXCLUSIVE,         // output[i] = input[0] + ... + input[i - 1]
+    SCAN_INCLUSIVE          // output[i] = input[0] + ... + input[i]
+};
+
+enum ScanAlgorithm
+{
+    SCAN_AUTO,              // decoupled lookback when the device supports it, multi-level otherwise
+    SCAN_MULTI_LEVEL,
+    SCAN_DECOUPLED_LOOKBACK
+};
+
+/**
+    Kernels of one device, and the buffers of the tile totals (grown on demand).
+*/
+struct ScanEngine
+{
+    KernelLibrary           *library;
+    cl_command_queue        queue;
+    size_t                  localSize;          // work-group size, a tile is 2 * localSize elements
+    bool                    lookback;           // the device can run the decoupled lookback
+    std::vector<cl_mem>     levels;             // tile totals of each level of the multi-level scan
+    std::vector<size_t>     levelCapacity;      // ints each level can hold
+    cl_mem                  status;             // status word of each tile (decoupled lookback)
+    cl_mem                  ticket;             // next tile to hand out (decoupled lookback)
+    size_t                  statusCapacity;     // tiles status can hold
+};
+
+/**
+    Cost of one scan.
+*/
+struct ScanReport
+{
+    ScanAlgorithm   algorithm;      // algorithm that ran (never SCAN_AUTO)
+    size_t          levels;         // levels of the multi-level scan (1 for a single pass)
+    size_t          kernels;        // kernels launched
+    double          kernelMs;       // device time of the kernels
+    double          gbPerSecond;    // input read and output written, over kernelMs
+};
+
+/**
+    scanCreate picks the work-group size and the algorithm the device supports.
+    @param      engine          engine to be created
+    @param      library         kernel library of the device, with scanKernel.cl built in
+    @param      queue           command queue of the device, created with CL_QUEUE_PROFILING_ENABLE
+*/
+void scanCreate(ScanEngine *engine, KernelLibrary *library, cl_command_queue queue);
+
+/**
+    scanBuffer scans a device buffer into another one (or into itself), and waits for the result.
+    @param      engine          engine created by scanCreate
+    @param      kind            SCAN_EXCLUSIVE or SCAN_INCLUSIVE
+    @param      algorithm       algorithm to use (SCAN_DECOUPLED_LOOKBACK falls back to multi-level when the
+                                device can't run it)
+    @param      input           ints to scan
+    @param      output          scanned ints (may be input)
+    @param      numberOfElements    elements of the buffers (at most 0x7fffffff)
+    @param      profiler        profiler recording every kernel (may be NULL)
+    @return     report          algorithm, kernels and device time
+*/
+ScanReport scanBuffer(ScanEngine *engine, ScanKind kind, ScanAlgorithm algorithm, cl_mem input, cl_mem output,
+                      size_t numberOfElements, Profiler *profiler);
+
+/**
+    scanAlgorithmName gives the name of an algorithm.
+    @param      algorithm       algorithm
+    @return     name            "auto", "multi-level" or "decoupled lookback"
+*/
+const char *scanAlgorithmName(ScanAlgorithm algorithm);
+
+/**
+    scanRelease releases the buffers of the engine (the kernels belong to the library).
+    @param      engine          engine to be released
+*/
+void scanRelease(ScanEngine *engine);
+
+#endif
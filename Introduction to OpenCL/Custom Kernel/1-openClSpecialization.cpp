@@ -0,0 +1,66 @@
+/**
+    Compile-time specialization of the zeroValues kernel. See 1-openClSpecialization.h for the description of each
+    function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <cstdio>
+#include "1-openClSpecialization.h"
+#include "1-openClProfiler.h"
+#include "1-openClProgramCache.h"
+
+using namespace std;
+
+string specializationOptions(const KernelSpecialization &spec)
+{
+    char options[256];
+    snprintf(options, sizeof options, "-DZV_SPECIALIZED -DZV_IMAX=%lluUL -DZV_STRIDE=%lluUL -DZV_LOCAL=%llu "
+             "-DZV_OPERAND=%d -DZV_TYPE=%s", (unsigned long long) spec.numberOfElements,
+             (unsigned long long) spec.globalSize, (unsigned long long) spec.localSize, spec.operand, spec.elementType);
+    return options;
+}
+
+void specializationCacheInit(SpecializationCache *cache)
+{
+    cache->programs.clear();
+    cache->hits = 0;
+    cache->misses = 0;
+}
+
+cl_program specializedProgram(SpecializationCache *cache, cl_context context, cl_device_id device, const char *source,
+                              size_t sourceSize, const KernelSpecialization &spec, const char *cacheDir,
+                              double *milliseconds)
+{
+    double start = wallClockMs();
+    string options = specializationOptions(spec);
+    for (size_t p = 0; p < cache->programs.size(); p++)
+    {
+        SpecializedProgram &entry = cache->programs[p];
+        if (entry.context == context && entry.device == device && entry.options == options)
+        {
+            cache->hits++;
+            if (milliseconds != NULL) *milliseconds = wallClockMs() - start;
+            return entry.program;
+        }
+    }
+
+    SpecializedProgram entry;
+    entry.context = context;
+    entry.device = device;
+    entry.options = options;
+    entry.program = buildProgramCached(context, device, source, sourceSize, options.c_str(), cacheDir, NULL);
+    cache->programs.push_back(entry);
+    cache->misses++;
+    if (milliseconds != NULL) *milliseconds = wallClockMs() - start;
+    return entry.program;
+}
+
+void specializationCacheRelease(SpecializationCache *cache)
+{
+    for (size_t p = 0; p < cache->programs.size(); p++)
+        clReleaseProgram(cache->programs[p].program);
+    specializationCacheInit(cache);
+}
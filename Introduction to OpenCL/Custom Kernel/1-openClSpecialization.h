@@ -0,0 +1,95 @@
+/**
+    Compile-time specialization of the zeroValues kernel. For fixed-shape jobs, the problem size, the stride of the
+    grid-stride loop, the work-group size, the operand and the element type are given to clBuildProgram as -D macros,
+    which compiles the zeroValuesSpecialized kernel of zeroValuesKernel.cl with all of them as constants.
+
+    Specialized programs are kept in an in-process cache keyed by (context, device, macro set), so repeated jobs with
+    the same shape never build again. Behind it, the on-disk program cache (see 1-openClProgramCache.h) keys the
+    binaries by their build options, so a new process only pays the build of a shape once as well.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLSPECIALIZATION_H
+#define OPENCLSPECIALIZATION_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+/**
+    Shape of one specialized job. Every field becomes a macro of the build options.
+*/
+struct KernelSpecialization
+{
+    size_t          numberOfElements;   // ZV_IMAX
+    size_t          localSize;          // ZV_LOCAL, the only work-group size the kernel can be launched with
+    size_t          globalSize;         // ZV_STRIDE, the only global size the kernel can be launched with
+    int             operand;            // ZV_OPERAND
+    const char      *elementType;       // ZV_TYPE, an OpenCL C scalar type matching the host arrays
+};
+
+/**
+    One program of the in-process cache.
+*/
+struct SpecializedProgram
+{
+    cl_context      context;
+    cl_device_id    device;
+    std::string     options;            // build options, with every macro of the shape
+    cl_program      program;
+};
+
+struct SpecializationCache
+{
+    std::vector<SpecializedProgram>     programs;
+    size_t                              hits;
+    size_t                              misses;
+};
+
+/**
+    specializationOptions gives the clBuildProgram options of a shape, e.g.
+    "-DZV_SPECIALIZED -DZV_IMAX=1024UL -DZV_STRIDE=256UL -DZV_LOCAL=64 -DZV_OPERAND=10 -DZV_TYPE=int"
+    @param      spec            shape of the job
+    @return     options         build options
+*/
+std::string specializationOptions(const KernelSpecialization &spec);
+
+/**
+    specializationCacheInit empties the cache.
+    @param      cache           cache to be initialized
+*/
+void specializationCacheInit(SpecializationCache *cache);
+
+/**
+    specializedProgram returns the program of a shape, building it (through the on-disk program cache) only the first
+    time the shape is asked for on this context and device. The program belongs to the cache.
+    @param      cache           in-process cache
+    @param      context         context of the device
+    @param      device          device that the program is built for
+    @param      source          kernel source, with the zeroValuesSpecialized kernel
+    @param      sourceSize      length of the source, in bytes
+    @param      spec            shape of the job
+    @param      cacheDir        directory of the on-disk program cache, or NULL
+    @param      milliseconds    filled with the time taken to get the program (may be NULL)
+    @return     program         built program, ready for clCreateKernel(program, "zeroValuesSpecialized", ...)
+*/
+cl_program specializedProgram(SpecializationCache *cache, cl_context context, cl_device_id device, const char *source,
+                              size_t sourceSize, const KernelSpecialization &spec, const char *cacheDir,
+                              double *milliseconds);
+
+/**
+    specializationCacheRelease releases every program of the cache.
+    @param      cache           cache to be released
+*/
+void specializationCacheRelease(SpecializationCache *cache);
+
+#endif
@@ -0,0 +1,278 @@
+/**
+    Stencil engine. See 1-openClStencil.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <sstream>
+#include "1-openClStencil.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+const char *stencilPathName(StencilPath path)
+{
+    switch (path) {
+        case STENCIL_AUTO:  return "auto";
+        case STENCIL_LOCAL: return "local";
+        case STENCIL_IMAGE: return "image";
+    }
+    return "unknown";
+}
+
+void stencilCreate(StencilEngine *engine, KernelLibrary *library, cl_command_queue queue)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(library->device);
+    engine->library = library;
+    engine->queue = queue;
+    engine->filter = NULL;
+    engine->filterCapacity = 0;
+    engine->temp = NULL;
+    engine->tempCapacity = 0;
+    engine->image = NULL;
+    engine->imageWidth = 0;
+    engine->imageHeight = 0;
+
+    // biggest square work-group the local kernel can run with
+    size_t limit;
+    cl_int clErr = clGetKernelWorkGroupInfo(kernelLibraryGet(library, "stencilLocal"), library->device,
+                                            CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &limit, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    engine->side = 1;
+    while (engine->side * 2 <= STENCIL_MAX_SIDE && engine->side * 2 * engine->side * 2 <= limit &&
+           (caps.maxWorkItemSizes.size() < 2 ||
+            (engine->side * 2 <= caps.maxWorkItemSizes[0] && engine->side * 2 <= caps.maxWorkItemSizes[1])))
+        engine->side *= 2;
+
+    // the image path needs single-channel float images (the kernel isn't even built without image support)
+    engine->images = false;
+    if (caps.imageSupport)
+    {
+        cl_uint count = 0;
+        clErr = clGetSupportedImageFormats(library->context, CL_MEM_READ_ONLY, CL_MEM_OBJECT_IMAGE2D, 0, NULL, &count);
+        vector<cl_image_format> formats(count);
+        if (clErr == CL_SUCCESS && count > 0)
+            clErr = clGetSupportedImageFormats(library->context, CL_MEM_READ_ONLY, CL_MEM_OBJECT_IMAGE2D, count,
+                                               &formats[0], NULL);
+        for (size_t f = 0; clErr == CL_SUCCESS && f < formats.size(); f++)
+            if (formats[f].image_channel_order == CL_R && formats[f].image_channel_data_type == CL_FLOAT)
+                engine->images = true;
+    }
+}
+
+// coefficients a filter must have
+static size_t filterCoefficients(const StencilFilter &filter)
+{
+    size_t columns = 2 * filter.radiusX + 1, rows = 2 * filter.radiusY + 1;
+    return filter.separable ? columns + rows : columns * rows;
+}
+
+bool stencilFilterFits(const StencilEngine *engine, const StencilFilter &filter)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(engine->library->device);
+    return filterCoefficients(filter) * sizeof(cl_float) <= caps.maxConstantBufferSize;
+}
+
+bool stencilPathSupported(const StencilEngine *engine, StencilPath path, size_t width, size_t height,
+                          const StencilFilter &filter)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(engine->library->device);
+    if (path == STENCIL_IMAGE)
+        return engine->images && width <= caps.image2dMaxWidth && height <= caps.image2dMaxHeight;
+
+    // the biggest tile and halo of any pass
+    size_t tileWidth = engine->side + 2 * filter.radiusX, tileHeight = engine->side + 2 * filter.radiusY;
+    size_t tile = filter.separable ? max(tileWidth * engine->side, engine->side * tileHeight) : tileWidth * tileHeight;
+    return tile * sizeof(cl_float) <= caps.localMemSize;
+}
+
+/**
+    One pass of a convolution: radii of its filter, and where its coefficients start.
+*/
+struct StencilPass
+{
+    cl_int      radiusX;
+    cl_int      radiusY;
+    cl_int      offset;
+    cl_mem      input;
+    cl_mem      output;
+};
+
+// runs every pass with one path, and gives the device time of its commands
+static double runPath(StencilEngine *engine, StencilPath path, const vector<StencilPass> &passes, size_t width,
+                      size_t height, size_t elements, Profiler *profiler)
+{
+    cl_int clErr;
+    cl_int w = (cl_int) width, h = (cl_int) height;
+    size_t side = engine->side;
+    size_t local[2] = {side, side};
+    size_t global[2] = {(width + side - 1) / side * side, (height + side - 1) / side * side};
+    vector<cl_event> events;
+
+    for (size_t p = 0; p < passes.size(); p++)
+    {
+        const StencilPass &pass = passes[p];
+        cl_kernel kernel;
+        cl_event event;
+        if (path == STENCIL_IMAGE)
+        {
+            size_t origin[3] = {0, 0, 0}, region[3] = {width, height, 1};
+            clErr = clEnqueueCopyBufferToImage(engine->queue, pass.input, engine->image, 0, origin, region, 0, NULL,
+                                               &event);
+            if (clErr != CL_SUCCESS) { cout << "clEnqueueCopyBufferToImage Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+            events.push_back(event);
+            kernel = kernelLibraryGet(engine->library, "stencilImage");
+            clErr = clSetKernelArg(kernel, 0, sizeof(cl_mem), &engine->image);
+        }
+        else
+        {
+            kernel = kernelLibraryGet(engine->library, "stencilLocal");
+            clErr  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &pass.input);
+            clErr |= clSetKernelArg(kernel, 8, (side + 2 * pass.radiusX) * (side + 2 * pass.radiusY) * sizeof(cl_float),
+                                    NULL);
+        }
+        clErr |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &pass.output);
+        clErr |= clSetKernelArg(kernel, 2, sizeof(cl_int), &w);
+        clErr |= clSetKernelArg(kernel, 3, sizeof(cl_int), &h);
+        clErr |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &engine->filter);
+        clErr |= clSetKernelArg(kernel, 5, sizeof(cl_int), &pass.offset);
+        clErr |= clSetKernelArg(kernel, 6, sizeof(cl_int), &pass.radiusX);
+        clErr |= clSetKernelArg(kernel, 7, sizeof(cl_int), &pass.radiusY);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        clErr = clEnqueueNDRangeKernel(engine->queue, kernel, 2, NULL, global, local, 0, NULL, &event);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        events.push_back(event);
+    }
+    clErr = clFinish(engine->queue);
+    if (clErr != CL_SUCCESS) { cout << "clFinish Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    double total = 0;
+    string stage = string("stencil ") + stencilPathName(path);
+    for (size_t e = 0; e < events.size(); e++)
+    {
+        double ms = eventMilliseconds(events[e]);
+        if (ms > 0) total += ms;
+        if (profiler != NULL) profilerAddStage(profiler, stage.c_str(), events[e], 0, elements);
+        else clReleaseEvent(events[e]);
+    }
+    return total;
+}
+
+// (re)creates a float buffer that holds at least count elements
+static void reserve(cl_context context, cl_mem *buffer, size_t *capacity, size_t count)
+{
+    cl_int clErr;
+    if (*buffer != NULL && *capacity >= count) return;
+    if (*buffer != NULL) clReleaseMemObject(*buffer);
+    *buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, count * sizeof(cl_float), NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    *capacity = count;
+}
+
+StencilReport stencilApply(StencilEngine *engine, StencilPath path, const StencilFilter &filter, cl_mem input,
+                           cl_mem output, size_t width, size_t height, Profiler *profiler)
+{
+    cl_int clErr;
+    StencilReport report = {STENCIL_LOCAL, false, filter.separable ? 2u : 1u, 0, -1, -1, 0};
+    cl_context context = engine->library->context;
+    size_t elements = width * height;
+    if (elements == 0) return report;
+    if (filter.coefficients.size() != filterCoefficients(filter))
+    {
+        cout << "Stencil Error: the filter needs " << filterCoefficients(filter) << " coefficients" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!stencilFilterFits(engine, filter))
+    {
+        cout << "Stencil Error: the filter doesn't fit CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // paths able to run the convolution
+    bool local = stencilPathSupported(engine, STENCIL_LOCAL, width, height, filter);
+    bool image = stencilPathSupported(engine, STENCIL_IMAGE, width, height, filter);
+    if (!local && !image)
+    {
+        cout << "Stencil Error: the halo of the filter doesn't fit the __local memory, and the device has no images" << endl;
+        exit(EXIT_FAILURE);
+    }
+    ostringstream shape;
+    shape << width << "x" << height << " " << filter.radiusX << "x" << filter.radiusY << (filter.separable ? " separable" : "");
+    bool measure = false;
+    if (path == STENCIL_AUTO)
+    {
+        map<string, StencilPath>::const_iterator known = engine->choices.find(shape.str());
+        if (known != engine->choices.end()) path = known->second;
+        else if (local && image) measure = true;
+        else path = local ? STENCIL_LOCAL : STENCIL_IMAGE;
+    }
+    if (path == STENCIL_IMAGE && !image) path = STENCIL_LOCAL;
+    if (path == STENCIL_LOCAL && !local) path = STENCIL_IMAGE;
+
+    // buffers: coefficients, first pass of a separable filter, image of the grid
+    size_t coefficients = filter.coefficients.size();
+    reserve(context, &engine->filter, &engine->filterCapacity, coefficients);
+    clErr = clEnqueueWriteBuffer(engine->queue, engine->filter, CL_TRUE, 0, coefficients * sizeof(cl_float),
+                                 &filter.coefficients[0], 0, NULL, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    if (filter.separable) reserve(context, &engine->temp, &engine->tempCapacity, elements);
+    if ((measure || path == STENCIL_IMAGE) && (engine->imageWidth != width || engine->imageHeight != height))
+    {
+        if (engine->image != NULL) clReleaseMemObject(engine->image);
+        cl_image_format format = {CL_R, CL_FLOAT};
+        cl_image_desc desc = {};
+        desc.image_type = CL_MEM_OBJECT_IMAGE2D;
+        desc.image_width = width;
+        desc.image_height = height;
+        engine->image = clCreateImage(context, CL_MEM_READ_ONLY, &format, &desc, NULL, &clErr);
+        if (clErr != CL_SUCCESS) { cout << "clCreateImage Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        engine->imageWidth = width;
+        engine->imageHeight = height;
+    }
+
+    vector<StencilPass> passes;
+    if (filter.separable)
+    {
+        StencilPass rows = {(cl_int) filter.radiusX, 0, 0, input, engine->temp};
+        StencilPass columns = {0, (cl_int) filter.radiusY, (cl_int) (2 * filter.radiusX + 1), engine->temp, output};
+        passes.push_back(rows);
+        passes.push_back(columns);
+    }
+    else
+    {
+        StencilPass whole = {(cl_int) filter.radiusX, (cl_int) filter.radiusY, 0, input, output};
+        passes.push_back(whole);
+    }
+
+    // both paths give the same output, so the measured runs leave the result in place
+    if (measure)
+    {
+        report.measured = true;
+        report.localMs = runPath(engine, STENCIL_LOCAL, passes, width, height, elements, profiler);
+        report.imageMs = runPath(engine, STENCIL_IMAGE, passes, width, height, elements, profiler);
+        report.path = report.imageMs < report.localMs ? STENCIL_IMAGE : STENCIL_LOCAL;
+        report.kernelMs = report.path == STENCIL_IMAGE ? report.imageMs : report.localMs;
+        engine->choices[shape.str()] = report.path;
+    }
+    else
+    {
+        report.path = path;
+        report.kernelMs = runPath(engine, path, passes, width, height, elements, profiler);
+    }
+    if (report.kernelMs > 0)
+        report.gbPerSecond = 2.0 * report.passes * elements * sizeof(cl_float) / (report.kernelMs * 1e6);
+    return report;
+}
+
+void stencilRelease(StencilEngine *engine)
+{
+    if (engine->filter != NULL) clReleaseMemObject(engine->filter);
+    if (engine->temp != NULL) clReleaseMemObject(engine->temp);
+    if (engine->image != NULL) clReleaseMemObject(engine->image);
+    engine->choices.clear();
+}
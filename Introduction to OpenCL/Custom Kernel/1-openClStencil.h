@@ -0,0 +1,148 @@
+/**
+    Stencil engine (stencilKernel.cl): 2D convolution of a float grid on the device, with a square or rectangular
+    filter (non-separable) or with a row filter and a column filter run one after the other (separable). The edges
+    of the grid are clamped. The coefficients are kept in __constant memory, so a filter has to fit
+    CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE.
+
+    There are two implementations behind the same call:
+
+    - local: the tile of each work-group and its halo are loaded into __local memory, then read from there.
+    - image: the grid is copied into an image2d (CL_R, CL_FLOAT) and read through a sampler, so the texture cache
+      serves the neighbourhoods. Needs CL_DEVICE_IMAGE_SUPPORT and a grid within CL_DEVICE_IMAGE2D_MAX_WIDTH/HEIGHT.
+
+    With STENCIL_AUTO, the first convolution of a shape (grid size and filter) runs every implementation the device
+    supports and keeps the fastest for that shape; the next ones only run the winner.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLSTENCIL_H
+#define OPENCLSTENCIL_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define STENCIL_MAX_SIDE        16      // biggest side of the work-groups (a power of two)
+
+enum StencilPath
+{
+    STENCIL_AUTO,           // the fastest supported path, measured on the first convolution of each shape
+    STENCIL_LOCAL,          // tiles and halos in __local memory
+    STENCIL_IMAGE           // image2d reads through a sampler
+};
+
+/**
+    Filter of a convolution. Non-separable: (2 * radiusY + 1) rows of (2 * radiusX + 1) coefficients, row-major.
+    Separable: the 2 * radiusX + 1 coefficients of the row filter, then the 2 * radiusY + 1 of the column filter.
+*/
+struct StencilFilter
+{
+    size_t                  radiusX;
+    size_t                  radiusY;
+    bool                    separable;
+    std::vector<float>      coefficients;
+};
+
+/**
+    Kernels of one device, the buffers reused between convolutions, and the path measured for each shape.
+*/
+struct StencilEngine
+{
+    KernelLibrary                       *library;
+    cl_command_queue                    queue;
+    size_t                              side;               // work-groups are side x side work-items
+    bool                                images;             // the device can run the image path at all
+    cl_mem                              filter;             // coefficients (__constant)
+    size_t                              filterCapacity;     // coefficients filter can hold
+    cl_mem                              temp;               // result of the first pass of a separable filter
+    size_t                              tempCapacity;       // floats temp can hold
+    cl_mem                              image;              // grid read by the image path
+    size_t                              imageWidth;
+    size_t                              imageHeight;
+    std::map<std::string, StencilPath>  choices;            // fastest path of each shape
+};
+
+/**
+    Cost of one convolution.
+*/
+struct StencilReport
+{
+    StencilPath     path;           // path of the result (never STENCIL_AUTO)
+    bool            measured;       // every supported path ran, to choose
+    size_t          passes;         // 1, or 2 for a separable filter
+    double          kernelMs;       // device time of the path, copies into the image included
+    double          localMs;        // device time of the local path, when measured (-1 otherwise)
+    double          imageMs;        // device time of the image path, when measured (-1 otherwise)
+    double          gbPerSecond;    // grid read and written by each pass, over kernelMs
+};
+
+/**
+    stencilCreate picks the work-group size and checks for the image format.
+    @param      engine          engine to be created
+    @param      library         kernel library of the device, with stencilKernel.cl built in
+    @param      queue           command queue of the device, created with CL_QUEUE_PROFILING_ENABLE
+*/
+void stencilCreate(StencilEngine *engine, KernelLibrary *library, cl_command_queue queue);
+
+/**
+    stencilFilterFits tells whether the coefficients of a filter fit CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE.
+    @param      engine          engine created by stencilCreate
+    @param      filter          filter to check
+    @return     fits            true if the filter can be used
+*/
+bool stencilFilterFits(const StencilEngine *engine, const StencilFilter &filter);
+
+/**
+    stencilPathSupported tells whether a path can run a convolution: the tile and halo have to fit the __local
+    memory (local path), the grid has to fit an image of the device (image path).
+    @param      engine          engine created by stencilCreate
+    @param      path            STENCIL_LOCAL or STENCIL_IMAGE
+    @param      width           columns of the grid
+    @param      height          rows of the grid
+    @param      filter          filter of the convolution
+    @return     supported       true if the path can run it
+*/
+bool stencilPathSupported(const StencilEngine *engine, StencilPath path, size_t width, size_t height,
+                          const StencilFilter &filter);
+
+/**
+    stencilApply convolves a grid into another one, and waits for the result.
+    @param      engine          engine created by stencilCreate
+    @param      path            path to use (STENCIL_AUTO measures the supported paths on the first use of a shape)
+    @param      filter          filter, within stencilFilterFits
+    @param      input           width x height floats, row-major
+    @param      output          width x height floats (not input)
+    @param      width           columns of the grid
+    @param      height          rows of the grid
+    @param      profiler        profiler recording every command (may be NULL)
+    @return     report          path, passes and device time
+*/
+StencilReport stencilApply(StencilEngine *engine, StencilPath path, const StencilFilter &filter, cl_mem input,
+                           cl_mem output, size_t width, size_t height, Profiler *profiler);
+
+/**
+    stencilPathName gives the name of a path.
+    @param      path            path
+    @return     name            "auto", "local" or "image"
+*/
+const char *stencilPathName(StencilPath path);
+
+/**
+    stencilRelease releases the buffers of the engine (the kernels belong to the library).
+    @param      engine          engine to be released
+*/
+void stencilRelease(StencilEngine *engine);
+
+#endif
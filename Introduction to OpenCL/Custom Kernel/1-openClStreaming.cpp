@@ -0,0 +1,173 @@
+/**
+    Chunked streaming pipeline for the zeroValues kernel. See 1-openClStreaming.h for the description of each function.
+
+    For chunk c, using buffer set s = c % numSets:
+        write(c)    waits for kernel(c - numSets)   (the kernel that last read inputs[s])
+        kernel(c)   waits for write(c) and read(c - numSets)   (the read that last used outputs[s])
+        read(c)     waits for kernel(c)
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include "1-openClStreaming.h"
+#include "1-openClCapabilities.h"
+#include "1-openClProfiler.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+#define STREAM_MIN_CHUNK        (1 << 20)       // below 4MB per copy, the enqueue overhead dominates
+#define STREAM_TARGET_CHUNKS    8               // chunks of an automatically sized dataset
+
+bool streamingRequired(cl_device_id device, size_t bufferSize)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(device);
+    cl_ulong maxAlloc = caps.maxMemAllocSize, globalMem = caps.globalMemSize;
+    return bufferSize > maxAlloc || 2 * (cl_ulong) bufferSize > globalMem;
+}
+
+size_t streamChunkElements(cl_device_id device, size_t numberOfElements, int numSets, size_t requested)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(device);
+    cl_ulong maxAlloc = caps.maxMemAllocSize, globalMem = caps.globalMemSize;
+
+    // numSets input and output buffers must fit in half of the global memory, and each one in one allocation
+    cl_ulong limit = globalMem / 2 / (2 * numSets);
+    if (maxAlloc < limit) limit = maxAlloc;
+    size_t maxChunk = (size_t) (limit / sizeof(int));
+    if (maxChunk > (size_t) 0x7fffffff) maxChunk = 0x7fffffff;     // the kernel counts elements with an int
+
+    size_t chunk = requested;
+    if (chunk == 0)
+    {
+        chunk = (numberOfElements + STREAM_TARGET_CHUNKS - 1) / STREAM_TARGET_CHUNKS;
+        if (chunk < STREAM_MIN_CHUNK) chunk = STREAM_MIN_CHUNK;
+    }
+    if (chunk > maxChunk) chunk = maxChunk;
+    if (chunk > numberOfElements) chunk = numberOfElements;
+    if (chunk == 0) chunk = 1;
+    return chunk;
+}
+
+void streamPipelineCreate(StreamPipeline *pipeline, cl_context context, cl_device_id device, size_t chunkElements,
+                          int numSets)
+{
+    cl_int clErr;
+    pipeline->numSets = numSets;
+    pipeline->chunkElements = chunkElements;
+    for (int q = 0; q < 3; q++)
+    {
+        pipeline->queues[q] = clCreateCommandQueue(context,device,CL_QUEUE_PROFILING_ENABLE,&clErr);
+        if (clErr != CL_SUCCESS) { cout << "clCreateCommandQueue Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    }
+    for (int s = 0; s < numSets; s++)
+    {
+        cl_mem input = clCreateBuffer(context, CL_MEM_READ_ONLY, chunkElements * sizeof(int), NULL, &clErr);
+        if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        cl_mem output = clCreateBuffer(context, CL_MEM_WRITE_ONLY, chunkElements * sizeof(int), NULL, &clErr);
+        if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        pipeline->inputs.push_back(input);
+        pipeline->outputs.push_back(output);
+    }
+}
+
+/**
+    Sum of the execution times (start -> end) of a list of events, in milliseconds.
+*/
+static double busyMs(const vector<cl_event> &events)
+{
+    double ns = 0;
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        cl_ulong start, end;
+        if (clGetEventProfilingInfo(events[i], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL) == CL_SUCCESS &&
+            clGetEventProfilingInfo(events[i], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL) == CL_SUCCESS)
+            ns += (double) (end - start);
+    }
+    return ns * 1e-6;
+}
+
+StreamReport streamPipelineRun(StreamPipeline *pipeline, cl_kernel kernel, const int *input, int *output,
+                               size_t numberOfElements, LaunchGeometry geometry, vector<cl_event> *events)
+{
+    cl_int clErr;
+    size_t chunks = (numberOfElements + pipeline->chunkElements - 1) / pipeline->chunkElements;
+    vector<cl_event> writeEvents(chunks), kernelEvents(chunks), readEvents(chunks);
+    double start = wallClockMs();
+
+    for (size_t c = 0; c < chunks; c++)
+    {
+        int s = (int) (c % pipeline->numSets);
+        size_t first = c * pipeline->chunkElements;
+        size_t count = numberOfElements - first < pipeline->chunkElements ? numberOfElements - first : pipeline->chunkElements;
+        size_t bytes = count * sizeof(int);
+        bool reused = c >= (size_t) pipeline->numSets;       // the buffer set was used by chunk c - numSets
+
+        // host to device copy, once the previous kernel on this set has read its input
+        clErr = clEnqueueWriteBuffer(pipeline->queues[STREAM_WRITE_QUEUE], pipeline->inputs[s], CL_FALSE, 0, bytes,
+                                     input + first, reused ? 1 : 0, reused ? &kernelEvents[c - pipeline->numSets] : NULL,
+                                     &writeEvents[c]);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+        // kernel, once the input is there and the previous read of this set's output is done
+        cl_int imax = (cl_int) count;
+        clErr  = clSetKernelArg(kernel,0,sizeof(cl_mem),&pipeline->inputs[s]);
+        clErr |= clSetKernelArg(kernel,1,sizeof(cl_mem),&pipeline->outputs[s]);
+        clErr |= clSetKernelArg(kernel,2,sizeof(cl_int),&imax);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+        cl_event kernelWait[2] = {writeEvents[c], reused ? readEvents[c - pipeline->numSets] : NULL};
+        clErr = clEnqueueNDRangeKernel(pipeline->queues[STREAM_KERNEL_QUEUE], kernel, 1, NULL, &geometry.globalSize,
+                                       &geometry.localSize, reused ? 2 : 1, kernelWait, &kernelEvents[c]);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+        // device to host copy
+        clErr = clEnqueueReadBuffer(pipeline->queues[STREAM_READ_QUEUE], pipeline->outputs[s], CL_FALSE, 0, bytes,
+                                    output + first, 1, &kernelEvents[c], &readEvents[c]);
+        if (clErr != CL_SUCCESS) { cout << "clEnqueueReadBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+        // submit now, so the three queues progress while the next chunks are enqueued
+        for (int q = 0; q < 3; q++) clFlush(pipeline->queues[q]);
+    }
+    for (int q = 0; q < 3; q++)
+    {
+        clErr = clFinish(pipeline->queues[q]);
+        if (clErr != CL_SUCCESS) { cout << "clFinish Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    }
+
+    StreamReport report;
+    report.chunks = chunks;
+    report.wallMs = wallClockMs() - start;
+    report.writeMs = busyMs(writeEvents);
+    report.kernelMs = busyMs(kernelEvents);
+    report.readMs = busyMs(readEvents);
+    for (size_t c = 0; c < chunks; c++)
+    {
+        if (events != NULL)
+        {
+            events->push_back(writeEvents[c]);
+            events->push_back(kernelEvents[c]);
+            events->push_back(readEvents[c]);
+            continue;
+        }
+        clReleaseEvent(writeEvents[c]);
+        clReleaseEvent(kernelEvents[c]);
+        clReleaseEvent(readEvents[c]);
+    }
+    return report;
+}
+
+void streamPipelineRelease(StreamPipeline *pipeline)
+{
+    for (size_t s = 0; s < pipeline->inputs.size(); s++)
+    {
+        clReleaseMemObject(pipeline->inputs[s]);
+        clReleaseMemObject(pipeline->outputs[s]);
+    }
+    pipeline->inputs.clear();
+    pipeline->outputs.clear();
+    for (int q = 0; q < 3; q++) clReleaseCommandQueue(pipeline->queues[q]);
+}
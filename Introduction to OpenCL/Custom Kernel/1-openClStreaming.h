@@ -0,0 +1,110 @@
+/**
+    Chunked streaming pipeline for the zeroValues kernel. The input is split in chunks that cycle through two or three
+    device buffer sets, and each stage has its own in-order command queue (host to device copies, kernels, device to
+    host copies). Events chain the stages of each chunk, and protect a buffer set from being overwritten before the
+    chunk that used it is done, so the copy of chunk N+1, the kernel on chunk N and the read of chunk N-1 overlap.
+
+    Since only the buffer sets live in the device, datasets larger than CL_DEVICE_MAX_MEM_ALLOC_SIZE or
+    CL_DEVICE_GLOBAL_MEM_SIZE run through the same code.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLSTREAMING_H
+#define OPENCLSTREAMING_H
+
+#include <cstddef>
+#include <vector>
+#include "1-openClAutoTuner.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define STREAM_WRITE_QUEUE      0
+#define STREAM_KERNEL_QUEUE     1
+#define STREAM_READ_QUEUE       2
+
+/**
+    Queues and buffer sets of the pipeline. inputs[s] / outputs[s] hold chunkElements ints each.
+*/
+struct StreamPipeline
+{
+    int                     numSets;
+    size_t                  chunkElements;
+    cl_command_queue        queues[3];
+    std::vector<cl_mem>     inputs;
+    std::vector<cl_mem>     outputs;
+};
+
+/**
+    Device time spent in each stage, and the wall time of the whole pipeline. When the stages overlap, the sum of the
+    stage times is bigger than the wall time.
+*/
+struct StreamReport
+{
+    size_t      chunks;
+    double      wallMs;
+    double      writeMs;
+    double      kernelMs;
+    double      readMs;
+};
+
+/**
+    streamingRequired tells if a problem doesn't fit the device as whole buffers (one input and one output).
+    @param      device          device running the kernel
+    @param      bufferSize      size of each of the two buffers, in bytes
+    @return     required        true if bufferSize exceeds CL_DEVICE_MAX_MEM_ALLOC_SIZE, or both buffers exceed
+                                CL_DEVICE_GLOBAL_MEM_SIZE
+*/
+bool streamingRequired(cl_device_id device, size_t bufferSize);
+
+/**
+    streamChunkElements chooses the chunk size: the requested one if given, or a size that gives the pipeline
+    some chunks to overlap, bounded by what numSets buffer sets can allocate in the device.
+    @param      device          device running the kernel
+    @param      numberOfElements    elements of the whole dataset
+    @param      numSets         number of buffer sets (2 or 3)
+    @param      requested       chunk size asked for on the command line, or 0 to choose automatically
+    @return     chunkElements   elements per chunk
+*/
+size_t streamChunkElements(cl_device_id device, size_t numberOfElements, int numSets, size_t requested);
+
+/**
+    streamPipelineCreate creates the three queues (with CL_QUEUE_PROFILING_ENABLE) and numSets buffer sets.
+    @param      pipeline        pipeline to be created
+    @param      context         context of the device
+    @param      device          device running the kernel
+    @param      chunkElements   elements per chunk
+    @param      numSets         number of buffer sets (2 or 3)
+*/
+void streamPipelineCreate(StreamPipeline *pipeline, cl_context context, cl_device_id device, size_t chunkElements,
+                          int numSets);
+
+/**
+    streamPipelineRun runs kernel (with the zeroValues arguments: input, output, number of elements) over the whole
+    dataset, chunk by chunk, and waits for the last read.
+    @param      pipeline        pipeline created by streamPipelineCreate
+    @param      kernel          kernel to run on each chunk
+    @param      input           host input, numberOfElements ints
+    @param      output          host output, numberOfElements ints
+    @param      numberOfElements    elements of the whole dataset
+    @param      geometry        launch geometry of each chunk
+    @param      events          if not NULL, receives the write, kernel and read events of each chunk, in that order,
+                                for the caller to profile and release (otherwise they are released here)
+    @return     report          stage and wall times
+*/
+StreamReport streamPipelineRun(StreamPipeline *pipeline, cl_kernel kernel, const int *input, int *output,
+                               size_t numberOfElements, LaunchGeometry geometry, std::vector<cl_event> *events);
+
+/**
+    streamPipelineRelease releases the queues and buffer sets of the pipeline.
+    @param      pipeline        pipeline to be released
+*/
+void streamPipelineRelease(StreamPipeline *pipeline);
+
+#endif
@@ -0,0 +1,152 @@
+/**
+    Transpose engine. See 1-openClTranspose.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include "1-openClTranspose.h"
+#include "1-openClCapabilities.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+#define LAYOUT_LOG_BANKS    5       // as in transposeKernel.cl: one padding element every 32 staged elements
+
+static size_t kernelWorkGroupSize(cl_kernel kernel, cl_device_id device)
+{
+    size_t size;
+    cl_int clErr = clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &size, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetKernelWorkGroupInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    return size;
+}
+
+void transposeCreate(TransposeEngine *engine, KernelLibrary *library, cl_command_queue queue)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(library->device);
+    engine->library = library;
+    engine->queue = queue;
+    engine->localMemSize = caps.localMemSize;
+
+    // the widest tile first (coalescing wants long runs), then as many rows of work-items as allowed
+    size_t limit = kernelWorkGroupSize(kernelLibraryGet(library, "transposeTiles"), library->device);
+    engine->side = TRANSPOSE_MAX_SIDE;
+    while (engine->side > 1 &&
+           (engine->side > limit || engine->side * (engine->side + 1) * sizeof(cl_uint) > caps.localMemSize))
+        engine->side /= 2;
+    engine->rows = 1;
+    while (engine->rows * 2 <= TRANSPOSE_ROWS && engine->rows * 2 <= engine->side &&
+           engine->side * engine->rows * 2 <= limit)
+        engine->rows *= 2;
+
+    size_t deinterleave = kernelWorkGroupSize(kernelLibraryGet(library, "layoutDeinterleave"), library->device);
+    size_t interleave = kernelWorkGroupSize(kernelLibraryGet(library, "layoutInterleave"), library->device);
+    engine->layoutLimit = min(deinterleave, interleave);
+}
+
+// launches one kernel, waits for it, and fills the report from its event
+static void launch(TransposeEngine *engine, cl_kernel kernel, cl_uint dimensions, const size_t *global,
+                   const size_t *local, size_t bytes, const char *stage, Profiler *profiler, TransposeReport *report)
+{
+    cl_event event;
+    cl_int clErr = clEnqueueNDRangeKernel(engine->queue, kernel, dimensions, NULL, global, local, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    clErr = clFinish(engine->queue);
+    if (clErr != CL_SUCCESS) { cout << "clFinish Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    double ms = eventMilliseconds(event);
+    if (ms > 0) report->kernelMs = ms;
+    if (report->kernelMs > 0) report->gbPerSecond = 2.0 * bytes / (report->kernelMs * 1e6);
+    if (profiler != NULL) profilerAddStage(profiler, stage, event, bytes, bytes / sizeof(cl_uint));
+    else clReleaseEvent(event);
+}
+
+TransposeReport transposeMatrix(TransposeEngine *engine, cl_mem input, cl_mem output, size_t rows, size_t columns,
+                                Profiler *profiler)
+{
+    TransposeReport report = {"transposeTiles", engine->side * engine->rows, 0, 0};
+    if (rows == 0 || columns == 0) return report;
+    cl_int r = (cl_int) rows, c = (cl_int) columns;
+    cl_kernel kernel = kernelLibraryGet(engine->library, "transposeTiles");
+    cl_int clErr  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &input);
+    clErr |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &output);
+    clErr |= clSetKernelArg(kernel, 2, sizeof(cl_int), &r);
+    clErr |= clSetKernelArg(kernel, 3, sizeof(cl_int), &c);
+    clErr |= clSetKernelArg(kernel, 4, engine->side * (engine->side + 1) * sizeof(cl_uint), NULL);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    // dimension 0 along the columns of input, dimension 1 along its rows
+    size_t side = engine->side;
+    size_t local[2] = {side, engine->rows};
+    size_t global[2] = {(columns + side - 1) / side * side, (rows + side - 1) / side * engine->rows};
+    launch(engine, kernel, 2, global, local, rows * columns * sizeof(cl_uint), "transpose", profiler, &report);
+    return report;
+}
+
+// biggest power of two work-group whose records fit the __local memory (0 if under LAYOUT_MIN_LOCAL_SIZE)
+static size_t layoutLocalSize(const TransposeEngine *engine, size_t components)
+{
+    size_t local = 1;
+    while (local * 2 <= LAYOUT_LOCAL_SIZE && local * 2 <= engine->layoutLimit) local *= 2;
+    while (local >= LAYOUT_MIN_LOCAL_SIZE)
+    {
+        size_t staged = local * components;
+        if ((staged + (staged >> LAYOUT_LOG_BANKS) + 1) * sizeof(cl_uint) <= engine->localMemSize) return local;
+        local /= 2;
+    }
+    return 0;
+}
+
+static TransposeReport layoutRun(TransposeEngine *engine, const char *name, cl_mem input, cl_mem output, size_t count,
+                                 size_t components, Profiler *profiler)
+{
+    size_t local = layoutLocalSize(engine, components);
+    TransposeReport report = {name, local, 0, 0};
+    cl_int n = (cl_int) count, c = (cl_int) components;
+    size_t staged = local * components;
+    cl_kernel kernel = kernelLibraryGet(engine->library, name);
+    cl_int clErr  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &input);
+    clErr |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &output);
+    clErr |= clSetKernelArg(kernel, 2, sizeof(cl_int), &n);
+    clErr |= clSetKernelArg(kernel, 3, sizeof(cl_int), &c);
+    clErr |= clSetKernelArg(kernel, 4, (staged + (staged >> LAYOUT_LOG_BANKS) + 1) * sizeof(cl_uint), NULL);
+    if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    size_t global = (count + local - 1) / local * local;
+    launch(engine, kernel, 1, &global, &local, count * components * sizeof(cl_uint), name, profiler, &report);
+    return report;
+}
+
+TransposeReport layoutDeinterleave(TransposeEngine *engine, cl_mem input, cl_mem output, size_t count,
+                                   size_t components, Profiler *profiler)
+{
+    if (count == 0 || components == 0) { TransposeReport none = {"layoutDeinterleave", 0, 0, 0}; return none; }
+    if (layoutLocalSize(engine, components) == 0) return transposeMatrix(engine, input, output, count, components, profiler);
+    return layoutRun(engine, "layoutDeinterleave", input, output, count, components, profiler);
+}
+
+TransposeReport layoutInterleave(TransposeEngine *engine, cl_mem input, cl_mem output, size_t count,
+                                 size_t components, Profiler *profiler)
+{
+    if (count == 0 || components == 0) { TransposeReport none = {"layoutInterleave", 0, 0, 0}; return none; }
+    if (layoutLocalSize(engine, components) == 0) return transposeMatrix(engine, input, output, components, count, profiler);
+    return layoutRun(engine, "layoutInterleave", input, output, count, components, profiler);
+}
+
+TransposeReport transposeCopyBaseline(TransposeEngine *engine, cl_mem input, cl_mem output, size_t bytes,
+                                      Profiler *profiler)
+{
+    TransposeReport report = {"clEnqueueCopyBuffer", 0, 0, 0};
+    cl_event event;
+    cl_int clErr = clEnqueueCopyBuffer(engine->queue, input, output, 0, 0, bytes, 0, NULL, &event);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueCopyBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    clErr = clFinish(engine->queue);
+    if (clErr != CL_SUCCESS) { cout << "clFinish Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    double ms = eventMilliseconds(event);
+    if (ms > 0) report.kernelMs = ms;
+    if (report.kernelMs > 0) report.gbPerSecond = 2.0 * bytes / (report.kernelMs * 1e6);
+    if (profiler != NULL) profilerAddStage(profiler, "copy baseline", event, bytes, 0);
+    else clReleaseEvent(event);
+    return report;
+}
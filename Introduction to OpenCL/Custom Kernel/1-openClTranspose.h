@@ -0,0 +1,119 @@
+/**
+    Transpose engine (transposeKernel.cl): out-of-place layout changes of 32-bit elements on the device, with every
+    read and write of global memory coalesced:
+
+    - transposeMatrix: a row-major matrix of any shape (no multiple of the tile needed) to its transpose, through
+      padded square tiles in __local memory. It is also the row-major / column-major conversion.
+    - layoutDeinterleave and layoutInterleave: records of N components (AoS) to N arrays (SoA), and back. Each
+      work-group stages the records of its work-items in __local memory. When the records of a work-group don't fit
+      the __local memory (big N), they fall back to transposeMatrix, as a count x N matrix is the same data.
+
+    transposeCopyBaseline times a clEnqueueCopyBuffer of the same size, the bandwidth a layout change could reach.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLTRANSPOSE_H
+#define OPENCLTRANSPOSE_H
+
+#include <cstddef>
+#include "1-openClKernelLibrary.h"
+#include "1-openClProfiler.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+#define TRANSPOSE_MAX_SIDE      32      // biggest side of the tiles of transposeMatrix (a power of two)
+#define TRANSPOSE_ROWS          8       // rows of work-items moving a tile, at most (each moves side / rows elements)
+#define LAYOUT_LOCAL_SIZE       256     // biggest work-group (records staged at once) of the (de)interleave
+#define LAYOUT_MIN_LOCAL_SIZE   32      // smaller work-groups fall back to transposeMatrix
+
+/**
+    Kernels of one device, and the geometry of each kernel.
+*/
+struct TransposeEngine
+{
+    KernelLibrary       *library;
+    cl_command_queue    queue;
+    size_t              side;               // tiles are side x side elements
+    size_t              rows;               // work-groups are side x rows work-items
+    size_t              layoutLimit;        // biggest work-group of the (de)interleave kernels
+    cl_ulong            localMemSize;       // CL_DEVICE_LOCAL_MEM_SIZE
+};
+
+/**
+    Cost of one layout change.
+*/
+struct TransposeReport
+{
+    const char  *kernel;        // kernel that ran
+    size_t      localSize;      // work-items of each work-group
+    double      kernelMs;       // device time of the kernel
+    double      gbPerSecond;    // bytes read and written, over kernelMs
+};
+
+/**
+    transposeCreate picks the tile of transposeMatrix and the work-group limit of the (de)interleave.
+    @param      engine          engine to be created
+    @param      library         kernel library of the device, with transposeKernel.cl built in
+    @param      queue           command queue of the device, created with CL_QUEUE_PROFILING_ENABLE
+*/
+void transposeCreate(TransposeEngine *engine, KernelLibrary *library, cl_command_queue queue);
+
+/**
+    transposeMatrix writes the transpose of a matrix into another buffer, and waits for the result.
+    @param      engine          engine created by transposeCreate
+    @param      input           rows x columns elements, row-major
+    @param      output          columns x rows elements (not input)
+    @param      rows            rows of input
+    @param      columns         columns of input
+    @param      profiler        profiler recording the kernel (may be NULL)
+    @return     report          kernel, device time and bandwidth
+*/
+TransposeReport transposeMatrix(TransposeEngine *engine, cl_mem input, cl_mem output, size_t rows, size_t columns,
+                                Profiler *profiler);
+
+/**
+    layoutDeinterleave splits records into one array per component, and waits for the result.
+    @param      engine          engine created by transposeCreate
+    @param      input           count records of components elements
+    @param      output          components arrays of count elements, one after the other (not input)
+    @param      count           records
+    @param      components      elements of each record
+    @param      profiler        profiler recording the kernel (may be NULL)
+    @return     report          kernel, device time and bandwidth
+*/
+TransposeReport layoutDeinterleave(TransposeEngine *engine, cl_mem input, cl_mem output, size_t count,
+                                   size_t components, Profiler *profiler);
+
+/**
+    layoutInterleave gathers one array per component into records, and waits for the result.
+    @param      engine          engine created by transposeCreate
+    @param      input           components arrays of count elements, one after the other
+    @param      output          count records of components elements (not input)
+    @param      count           records
+    @param      components      elements of each record
+    @param      profiler        profiler recording the kernel (may be NULL)
+    @return     report          kernel, device time and bandwidth
+*/
+TransposeReport layoutInterleave(TransposeEngine *engine, cl_mem input, cl_mem output, size_t count,
+                                 size_t components, Profiler *profiler);
+
+/**
+    transposeCopyBaseline copies a buffer into another one with clEnqueueCopyBuffer, and waits for the copy.
+    @param      engine          engine created by transposeCreate
+    @param      input           source
+    @param      output          destination
+    @param      bytes           bytes copied
+    @param      profiler        profiler recording the copy (may be NULL)
+    @return     report          device time and bandwidth of the copy
+*/
+TransposeReport transposeCopyBaseline(TransposeEngine *engine, cl_mem input, cl_mem output, size_t bytes,
+                                      Profiler *profiler);
+
+#endif
@@ -7,12 +7,21 @@
     @email  xavier@informatik.uni-bremen.de
 */
 
+#include <iostream>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include "1-openClUtilities.h"
+
 #ifdef __APPLE__
     #include <OpenCL/opencl.h>
 #else
     #include <CL/cl.h>
 #endif
 
+using namespace std;
+
 /**
     checkError converts an openGL related error code into a c string, for a readable print out of the problem.
     @param      errorCode       error code, as cl_uint
@@ -20,7 +29,7 @@
 */
 char* checkError(cl_uint errorCode)
 {
-    switch (errorCode) {
+    switch ((cl_int) errorCode) {		// error codes are negative cl_int values
         case CL_SUCCESS:                            return (char*) "SUCCESS";
         case CL_DEVICE_NOT_FOUND:                   return (char*) "DEVICE NOT FOUND";
         case CL_DEVICE_NOT_AVAILABLE:               return (char*) "DEVICE NOT AVAILABLE";
@@ -69,4 +78,47 @@ char* checkError(cl_uint errorCode)
         case CL_INVALID_MIP_LEVEL:                  return (char*) "INVALID MIP-MAP LEVEL";
     }
     return (char*) "UNKNOWN";
-}
\ No newline at end of file
+}
+
+
+/**
+    deviceInfoString queries a string property of a device (CL_DEVICE_NAME, CL_DRIVER_VERSION, ...).
+    @param      device          device to query
+    @param      param           string property, as cl_device_info
+    @return     value           value of the property (empty if the query fails)
+*/
+string deviceInfoString(cl_device_id device, cl_device_info param)
+{
+    size_t size;
+    cl_int clErr = clGetDeviceInfo(device, param, 0, NULL, &size);
+    if (clErr != CL_SUCCESS || size == 0) return "";
+    string value(size, '\0');
+    clErr = clGetDeviceInfo(device, param, size, &value[0], NULL);
+    if (clErr != CL_SUCCESS) return "";
+    value.resize(size - 1);     // drop the terminating '\0'
+    return value;
+}
+
+/**
+    printBuildLog prints the build log of a program for one device, after a failed clBuildProgram.
+    @param      program         program that failed to build
+    @param      device          device that the program was built for
+*/
+void printBuildLog(cl_program program, cl_device_id device)
+{
+    size_t errorsize;
+    cl_int clErr = clGetProgramBuildInfo(program,device,CL_PROGRAM_BUILD_LOG,0,NULL,&errorsize);
+    if (clErr != CL_SUCCESS) { cout << "clGetProgramBuildInfo Error: " << checkError(clErr) << endl; return;}
+    string buildLog(errorsize, '\0');
+    clErr = clGetProgramBuildInfo(program,device,CL_PROGRAM_BUILD_LOG,errorsize,&buildLog[0],NULL);
+    if (clErr != CL_SUCCESS) { cout << "clGetProgramBuildInfo Error: " << checkError(clErr) << endl; return;}
+    cout << endl << buildLog.c_str() << endl;
+}
+
+string temporaryFileName(const string &path)
+{
+    static atomic<unsigned long> counter(0);
+    char suffix[64];
+    snprintf(suffix, sizeof suffix, ".%ld.%lu.tmp", (long) getpid(), counter++);
+    return path + suffix;
+}
@@ -10,6 +10,8 @@
 #ifndef OPENCLUTILITIES_H
 #define OPENCLUTILITIES_H
 
+#include <string>
+
 #ifdef __APPLE__
     #include <OpenCL/opencl.h>
 #else
@@ -23,6 +25,29 @@
 */
 char* checkError(cl_uint errorCode);
 
+/**
+    deviceInfoString queries a string property of a device (CL_DEVICE_NAME, CL_DRIVER_VERSION, ...).
+    @param      device          device to query
+    @param      param           string property, as cl_device_info
+    @return     value           value of the property (empty if the query fails)
+*/
+std::string deviceInfoString(cl_device_id device, cl_device_info param);
+
+/**
+    printBuildLog prints the build log of a program for one device, after a failed clBuildProgram.
+    @param      program         program that failed to build
+    @param      device          device that the program was built for
+*/
+void printBuildLog(cl_program program, cl_device_id device);
+
+/**
+    temporaryFileName gives a name, next to a file, for writing it before renaming it into place. The name is unique
+    within the machine: it holds the process id and a counter, so threads of the same process never share it.
+    @param      path            file to be written
+    @return     name            path of the temporary file
+*/
+std::string temporaryFileName(const std::string &path);
+
 
 /**
 	Parameter codes are:
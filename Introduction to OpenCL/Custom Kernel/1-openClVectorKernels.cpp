@@ -0,0 +1,99 @@
+/**
+    Vector width variants of the zeroValues kernel. See 1-openClVectorKernels.h for the description of each function.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include "1-openClVectorKernels.h"
+#include "1-openClCapabilities.h"
+#include "1-openClAutoTuner.h"
+#include "1-openClUtilities.h"
+
+using namespace std;
+
+#define COMPARE_REPETITIONS     3
+
+cl_uint selectVectorWidth(cl_device_id device)
+{
+    const DeviceCapabilities &caps = deviceCapabilities(device);
+    cl_uint preferred = caps.preferredVectorWidthInt, native = caps.nativeVectorWidthInt;     // native: OpenCL 1.1
+    cl_uint widest = preferred > native ? preferred : native;
+    if (widest >= 16) return 16;
+    if (widest >= 8) return 8;
+    if (widest >= 4) return 4;
+    return 1;
+}
+
+const char *zeroValuesKernelName(cl_uint width)
+{
+    switch (width) {
+        case 4:     return "zeroValues4";
+        case 8:     return "zeroValues8";
+        case 16:    return "zeroValues16";
+    }
+    return "zeroValues";
+}
+
+size_t vectorWorkItems(size_t numberOfElements, cl_uint width)
+{
+    return (numberOfElements + width - 1) / width;
+}
+
+void compareVectorWidths(cl_context context, cl_device_id device, cl_command_queue queue, KernelLibrary *library,
+                         const int *input, size_t numberOfElements, const char *tuningFile, int tuneMode)
+{
+    cl_int clErr;
+    size_t bufferSize = numberOfElements * sizeof(int);
+    cl_mem inputBuffer = clCreateBuffer(context, CL_MEM_READ_ONLY, bufferSize, NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    cl_mem outputBuffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY, bufferSize, NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    clErr = clEnqueueWriteBuffer(queue, inputBuffer, CL_TRUE, 0, bufferSize, input, 0, NULL, NULL);
+    if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+    cl_uint widths[] = {1, 4, 8, 16};
+    double scalarMs = 0;
+    cout << endl << "Vector widths on " << deviceInfoString(device, CL_DEVICE_NAME) << " (selected: "
+         << zeroValuesKernelName(selectVectorWidth(device)) << "):" << endl;
+    for (int w = 0; w < 4; w++)
+    {
+        const char *name = zeroValuesKernelName(widths[w]);
+        cl_kernel kernel = kernelLibraryGet(library, name);
+        cl_int imax = (cl_int) numberOfElements;
+        clErr  = clSetKernelArg(kernel,0,sizeof(cl_mem),&inputBuffer);
+        clErr |= clSetKernelArg(kernel,1,sizeof(cl_mem),&outputBuffer);
+        clErr |= clSetKernelArg(kernel,2,sizeof(cl_int),&imax);
+        if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+        size_t workItems = vectorWorkItems(numberOfElements, widths[w]);
+        LaunchGeometry geometry = tuneMode == 0 ? defaultGeometry(device, kernel, workItems) :
+                                  autoTuneGeometry(queue, device, kernel, name, workItems, tuningFile, tuneMode == 2);
+
+        double best = -1;
+        for (int rep = 0; rep < COMPARE_REPETITIONS; rep++)
+        {
+            cl_event event;
+            cl_ulong start, end;
+            clErr = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &geometry.globalSize, &geometry.localSize, 0, NULL, &event);
+            if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+            clWaitForEvents(1, &event);
+            clErr  = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL);
+            clErr |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL);
+            clReleaseEvent(event);
+            if (clErr != CL_SUCCESS) { cout << "clGetEventProfilingInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+            double ms = (end - start) * 1e-6;
+            if (best < 0 || ms < best) best = ms;
+        }
+        if (widths[w] == 1) scalarMs = best;
+
+        cout << "\t" << name << ":\t" << best << " ms, " << 2.0 * bufferSize / (best * 1e6) << " GB/s, x"
+             << (best > 0 ? scalarMs / best : 0) << " over scalar" << endl;
+    }
+
+    clReleaseMemObject(inputBuffer);
+    clReleaseMemObject(outputBuffer);
+}
@@ -0,0 +1,62 @@
+/**
+    Selection of the vector width variant of the zeroValues kernel (zeroValues, zeroValues4, zeroValues8 or
+    zeroValues16, in zeroValuesKernel.cl) from the device's CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT and
+    CL_DEVICE_NATIVE_VECTOR_WIDTH_INT, and a benchmark of every variant against the scalar kernel.
+
+    @author Francisco Xavier
+    @date   17 Oct 2026
+    @email  xavier@informatik.uni-bremen.de
+*/
+
+#ifndef OPENCLVECTORKERNELS_H
+#define OPENCLVECTORKERNELS_H
+
+#include <cstddef>
+#include "1-openClKernelLibrary.h"
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+/**
+    selectVectorWidth picks the widest variant (1, 4, 8 or 16) that doesn't exceed the widest of the preferred and
+    native int vector widths of the device.
+    @param      device          device running the kernel
+    @return     width           1, 4, 8 or 16
+*/
+cl_uint selectVectorWidth(cl_device_id device);
+
+/**
+    zeroValuesKernelName gives the kernel name of one variant.
+    @param      width           1, 4, 8 or 16
+    @return     name            "zeroValues", "zeroValues4", "zeroValues8" or "zeroValues16"
+*/
+const char *zeroValuesKernelName(cl_uint width);
+
+/**
+    vectorWorkItems gives how many work-items a variant needs to cover a problem in one pass (the geometry of the
+    launch is tuned on this count).
+    @param      numberOfElements    elements to process
+    @param      width           1, 4, 8 or 16
+    @return     workItems       numberOfElements / width, rounded up
+*/
+size_t vectorWorkItems(size_t numberOfElements, cl_uint width);
+
+/**
+    compareVectorWidths times every variant on the same device buffers (the fastest of a few runs of each, after
+    tuning its geometry), and prints their throughput and their gain over the scalar kernel.
+    @param      context         context of the device
+    @param      device          device running the kernels
+    @param      queue           command queue, created with CL_QUEUE_PROFILING_ENABLE
+    @param      library         kernel library of the device, with every variant
+    @param      input           host input, numberOfElements ints
+    @param      numberOfElements    elements to process
+    @param      tuningFile      tuning file of the auto-tuner, or NULL
+    @param      tuneMode        0: default geometry, 1: stored or tuned once, 2: always tune again
+*/
+void compareVectorWidths(cl_context context, cl_device_id device, cl_command_queue queue, KernelLibrary *library,
+                         const int *input, size_t numberOfElements, const char *tuningFile, int tuneMode);
+
+#endif
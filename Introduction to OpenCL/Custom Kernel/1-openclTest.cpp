@@ -12,8 +12,25 @@
 #include <iostream>
 #include <cmath>
 #include <cstring>
-#include <cassert>
+#include <string>
+#include <thread>
+#include <getopt.h>
 #include "1-openClUtilities.h"
+#include "1-openClProfiler.h"
+#include "1-openClProgramCache.h"
+#include "1-openClAutoTuner.h"
+#include "1-openClStreaming.h"
+#include "1-openClHostMemory.h"
+#include "1-openClMultiDevice.h"
+#include "1-openClVectorKernels.h"
+#include "1-openClSpecialization.h"
+#include "1-openClHostEngine.h"
+#include "1-openClCoExecution.h"
+#include "1-openClOutput.h"
+#include "1-openClMappedFile.h"
+#include "1-openClKernelLibrary.h"
+#include "1-openClCapabilities.h"
+#include "1-openClEngineDemos.h"
 
 #ifdef __APPLE__
 	#include <OpenCL/opencl.h>
@@ -23,6 +40,8 @@
 
 using namespace std;
 
+#define ZERO_VALUES_OPERAND		10		// value added by the kernels (ZV_OPERAND in zeroValuesKernel.cl)
+
 /**
 	This method queries the different devices of a Platform (Host), and get the specific hardware attributes of GPUs
 	that are OpenCL enabled. In the following web page, it is found the datatypes and specific keywords that can be 
@@ -50,62 +69,22 @@ void deviceInfo(cl_device_type typeOfDevice, cl_platform_id platform)
 	clErr = clGetDeviceIDs(platform,typeOfDevice,numDevices,devices,NULL);
 	if (clErr != CL_SUCCESS) { cout << "clGetDeviceIDs Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
 
-	// get device info
+	// get device info (from the capability snapshot, see 1-openClCapabilities.h: only the name and the driver version
+	// are asked to the runtime, when the device is already in the snapshot)
 	for (i = 0; i < (signed) numDevices; i++)
 	{
-	    size_t size;
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_NAME,0,NULL,&size);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	    char name[size];
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_NAME,size,name,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_VENDOR,0,NULL,&size);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	    char vendor[size];
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_VENDOR,size,vendor,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    clErr = clGetDeviceInfo(devices[i],CL_DRIVER_VERSION,0,NULL,&size);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	    char driverVersion[size];
-	    clErr = clGetDeviceInfo(devices[i],CL_DRIVER_VERSION,size,driverVersion,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    cl_ulong localMemSize;
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_LOCAL_MEM_SIZE,sizeof(cl_ulong),&localMemSize,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    cl_uint maxComputeUnits;
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_MAX_COMPUTE_UNITS,sizeof(cl_uint),&maxComputeUnits,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    cl_uint maxWorkItemDimentions;
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS,sizeof(cl_uint),&maxWorkItemDimentions,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    size_t maxWorkItemSizes[maxWorkItemDimentions];
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_MAX_WORK_ITEM_SIZES,sizeof(size_t) * CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS,
-	    						&maxWorkItemSizes,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    size_t threadBlockSize;
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_MAX_WORK_GROUP_SIZE,sizeof(size_t),&threadBlockSize,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    cl_ulong globalMemSize;
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_GLOBAL_MEM_SIZE,sizeof(cl_ulong),&globalMemSize,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    cl_ulong constantBufferSize;
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE,sizeof(cl_ulong),&constantBufferSize,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_PROFILE,0,NULL,&size);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	    char deviceProfile[size];
-	    clErr = clGetDeviceInfo(devices[i],CL_DEVICE_PROFILE,size,deviceProfile,NULL);
-	    if (clErr != CL_SUCCESS) { cout << "clGetDeviceInfo Error : " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	    const DeviceCapabilities &caps = deviceCapabilities(devices[i]);
+	    const char *name = caps.name.c_str();
+	    const char *vendor = caps.vendor.c_str();
+	    const char *driverVersion = caps.driverVersion.c_str();
+	    cl_ulong localMemSize = caps.localMemSize;
+	    cl_uint maxComputeUnits = caps.computeUnits;
+	    cl_uint maxWorkItemDimentions = (cl_uint) caps.maxWorkItemSizes.size();
+	    const size_t *maxWorkItemSizes = maxWorkItemDimentions > 0 ? &caps.maxWorkItemSizes[0] : NULL;
+	    size_t threadBlockSize = caps.maxWorkGroupSize;
+	    cl_ulong globalMemSize = caps.globalMemSize;
+	    cl_ulong constantBufferSize = caps.maxConstantBufferSize;
+	    const char *deviceProfile = caps.profile.c_str();
 
 	    if (typeOfDevice == CL_DEVICE_TYPE_GPU)
 	    {
@@ -114,16 +93,16 @@ void deviceInfo(cl_device_type typeOfDevice, cl_platform_id platform)
 		    cout << "\tLocal Memory Size:\t\t" << localMemSize << endl;
 		    cout << "\tMax Compute Units:\t\t" << maxComputeUnits << endl;
 		    cout << "\tMAX Work Item Dimentions:\t" << maxWorkItemDimentions << "  [ ";
-	    	for (int j = 0; j < (signed) maxWorkItemDimentions - 1; j++)
-		    	cout << maxWorkItemSizes[j] << " | ";
-		    cout << maxWorkItemSizes[maxWorkItemDimentions - 1] << " ]" << endl;
+	    	for (int j = 0; j < (signed) maxWorkItemDimentions; j++)
+		    	cout << maxWorkItemSizes[j] << (j + 1 < (signed) maxWorkItemDimentions ? " | " : "");
+		    cout << " ]" << endl;
 			cout << "\tWork Group Size:\t\t" << threadBlockSize << endl;
 			if (globalMemSize > 1073741824)
 				cout << "\tGlobal Memory Size:\t\t" << globalMemSize / 1073741824 << " GigaBytes" << endl;
 			else if (globalMemSize > 1048576)
 				cout << "\tGlobal Memory Size:\t\t" << globalMemSize / 1048576 << " MegaBytes" << endl;
 			else if (globalMemSize > 1024)
-				cout << "\tGlobal Memory Size:\t\t" << globalMemSize / 1048576 << " KBytes" << endl;
+				cout << "\tGlobal Memory Size:\t\t" << globalMemSize / 1024 << " KBytes" << endl;
 			else cout << "\tGlobal Memory Size:\t\t" << globalMemSize << " Bytes" << endl;
 			cout << "\tConstant Buffer Size:\t\t" << constantBufferSize << " Bytes" << endl;
 			if (strcmp(deviceProfile, "FULL_PROFILE") == 0)
@@ -177,6 +156,608 @@ void platformInfo(cl_uint numPlatforms, cl_platform_id *platforms)
 	}
 }
 
+/**
+	Options of the driver, set from the command line (see main).
+*/
+struct DriverOptions
+{
+	size_t			numberOfElements;
+	ProfileFormat	profileFormat;
+	const char		*profileOut;
+	const char		*cacheDir;
+	int				tuneMode;			// 0: default geometry, 1: stored or tuned once, 2: always tune again
+	int				streamMode;			// 1: stream only if the data doesn't fit the device, 2: always stream
+	size_t			streamChunk;		// elements per chunk (0: chosen from the device memory)
+	int				streamBuffers;		// buffer sets of the streaming pipeline (2 or 3)
+	MemoryMode		memoryMode;			// copy, zero-copy or auto (whole buffers only)
+	bool			compareMemory;		// run both copy and zero-copy, and compare them
+	cl_uint			vectorWidth;		// vector width of the kernel variant (0: chosen from the device)
+	bool			compareVector;		// benchmark every vector width against the scalar kernel
+	int				specializeJobs;		// jobs run with the specialized kernel (0: use the generic kernels)
+	bool			multiDevice;		// split the job between every device of every platform
+	cl_uint			subDevices;			// sub-devices each CPU device is split into, in multi-device mode
+	bool			hostOnly;			// run on the native host engine only, without OpenCL
+	bool			baseline;			// also run the host engine after the OpenCL job, for comparison
+	unsigned		hostThreads;		// threads of the host engine (0: one per hardware thread)
+	bool			coExecute;			// share the job between the host engine and the device
+	size_t			coExecuteBatch;		// most elements per device batch (0: chosen from the device memory)
+	OutputMode		outputMode;			// how the results are written (summary, binary or text)
+	const char		*outputFile;		// destination of the results (standard output if NULL, except binary)
+	size_t			summaryEdge;		// first and last elements shown by the summary
+	const char		*inputFile;			// binary file of ints used as input (NULL: input synthesized in memory)
+	MappedFile		*inputMapping;		// mapping of inputFile, set up by main
+	MappedFile		*outputMapping;		// mapping of the binary output file, set up by main (NULL: heap output)
+	bool			syncBuild;			// build the program before preparing the host data, instead of meanwhile
+	int				reduceOps;			// reductions run on the output (bit 1 << ReduceOperation), 0 for none
+	bool			scan;				// also scan vectorA on the device
+	ScanKind		scanKind;			// exclusive or inclusive scan
+	bool			sort;				// also radix sort keys derived from vectorA on the device
+	RadixKeyType	sortKeyType;		// int, uint or float keys
+	size_t			histogramBins;		// bins of the histogram of values derived from vectorA (0: no histogram)
+	size_t			gemmSize;			// rows and columns of the square matrices multiplied (0: no GEMM)
+	bool			stencil;			// also convolve a grid made of vectorA on the device
+	size_t			stencilRadius;		// radius of the filters of the convolution
+	size_t			layoutComponents;	// components of the records (de)interleaved on the device (0: no layout changes)
+	size_t			compactPercent;		// share of the values kept by the compaction on the device (0: no compaction)
+};
+
+/**
+	Device of the single-device run. It is opened before the host data is prepared, and the program of the kernel
+	library is built on a worker thread meanwhile (joined by runSingleDevice, before the first kernel is created).
+*/
+struct DeviceSession
+{
+	cl_device_id		device;
+	cl_context			context;
+	cl_command_queue	queue;
+	KernelLibrary		library;
+	KernelLibraryBuild	build;
+	ProgramCacheResult	cacheResult;
+};
+
+/**
+	Launch geometry of the zeroValues kernel variant of a given vector width, which must already have its arguments
+	set: stored or auto-tuned per (device, kernel, problem size bucket), unless tuning is disabled.
+*/
+static LaunchGeometry zeroValuesGeometry(const DriverOptions &options, cl_command_queue queue, cl_device_id device,
+										 cl_kernel kernel, cl_uint width, size_t numberOfElements)
+{
+	size_t workItems = vectorWorkItems(numberOfElements, width);
+	if (options.tuneMode == 0)
+		return defaultGeometry(device, kernel, workItems);
+	string tuningFile = options.cacheDir != NULL ? string(options.cacheDir) + "/launchTuning.txt" : "";
+	return autoTuneGeometry(queue, device, kernel, zeroValuesKernelName(width), workItems,
+							options.cacheDir != NULL ? tuningFile.c_str() : NULL, options.tuneMode == 2);
+}
+
+/**
+	Runs zeroValues with one device buffer for the whole input and one for the whole output, each stage recorded in
+	the profiler (with the name of the memory mode in front of it). With MEMORY_COPY the input is written to the
+	device and the output read back; with MEMORY_ZERO_COPY the buffers are created over the (page aligned) host arrays
+	with CL_MEM_USE_HOST_PTR, and mapping the output is all it takes to see the results in vectorB.
+
+	@return		milliseconds	wall time from the buffer creation until the results are in vectorB
+*/
+static double runWholeBuffers(const DriverOptions &options, MemoryMode mode, cl_context context, cl_device_id device,
+							  cl_command_queue queue, cl_kernel kernel, cl_uint width, int *vectorA, int *vectorB,
+							  Profiler *profiler)
+{
+	cl_int clErr;
+	size_t numberOfElements = options.numberOfElements;
+	string prefix = string(memoryModeName(mode)) + ": ";
+	double runStart = wallClockMs();
+	double phaseStart = runStart;
+    size_t bufferSize = numberOfElements * sizeof(int);		// creating space for numberOfElements integers
+    cl_mem_flags hostFlag = mode == MEMORY_ZERO_COPY ? CL_MEM_USE_HOST_PTR : 0;
+    cl_mem memoryBuffer = clCreateBuffer(context, CL_MEM_READ_ONLY | hostFlag, bufferSize,
+    									 mode == MEMORY_ZERO_COPY ? vectorA : NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    cl_mem memoryBuffer2 = clCreateBuffer(context, CL_MEM_WRITE_ONLY | hostFlag, bufferSize,
+    									  mode == MEMORY_ZERO_COPY ? vectorB : NULL, &clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+    profilerAddPhase(profiler, (prefix + "buffer creation").c_str(), wallClockMs() - phaseStart);
+
+	// set kernel arguments
+	cl_int imax = (cl_int) numberOfElements;
+	clErr = clSetKernelArg(kernel,0,sizeof(cl_mem),&memoryBuffer);
+	if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	clErr = clSetKernelArg(kernel,1,sizeof(cl_mem),&memoryBuffer2);
+	if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	clErr = clSetKernelArg(kernel,2,sizeof(cl_int),&imax);
+	if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+	// write vectorA to device buffer (a zero-copy buffer already holds it)
+	cl_event event;
+	if (mode == MEMORY_COPY)
+	{
+		clErr = clEnqueueWriteBuffer(queue, memoryBuffer, CL_TRUE, 0, bufferSize, (void*) vectorA, 0, NULL, &event);
+		if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+		profilerAddStage(profiler, (prefix + "write vectorA").c_str(), event, bufferSize, 0);
+	}
+
+	// the geometry is tuned outside of the measured run
+	double tuneStart = wallClockMs();
+	LaunchGeometry geometry = zeroValuesGeometry(options, queue, device, kernel, width, numberOfElements);
+	double tuneMs = wallClockMs() - tuneStart;
+	profilerAddPhase(profiler, (prefix + "launch geometry").c_str(), tuneMs);
+
+	// enqueue kernel
+	cl_uint dim = 1;
+	size_t offset = 0;
+	size_t local_size = geometry.localSize;
+	size_t global_size = geometry.globalSize;
+	clErr = clEnqueueNDRangeKernel(queue, kernel, dim, &offset, &global_size, &local_size, 0, NULL, &event);
+	if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	profilerAddStage(profiler, (prefix + "kernel " + zeroValuesKernelName(width)).c_str(), event, 0, numberOfElements);
+
+	// reading back the computation of the device
+	if (mode == MEMORY_COPY)
+	{
+		clErr = clEnqueueReadBuffer(queue, memoryBuffer2, CL_TRUE, 0, bufferSize, (void*) vectorB, 0, NULL, &event);
+		if (clErr != CL_SUCCESS) { cout << "clEnqueueReadBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+		profilerAddStage(profiler, (prefix + "read vectorB").c_str(), event, bufferSize, 0);
+	}
+	else
+	{
+		// mapping a CL_MEM_USE_HOST_PTR buffer makes its content visible in the host array it was created with
+		void *mapped = clEnqueueMapBuffer(queue, memoryBuffer2, CL_TRUE, CL_MAP_READ, 0, bufferSize, 0, NULL, &event, &clErr);
+		if (clErr != CL_SUCCESS) { cout << "clEnqueueMapBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+		profilerAddStage(profiler, (prefix + "map vectorB").c_str(), event, bufferSize, 0);
+		if (mapped != vectorB) memcpy(vectorB, mapped, bufferSize);		// runtimes are allowed to map a copy
+		clErr = clEnqueueUnmapMemObject(queue, memoryBuffer2, mapped, 0, NULL, NULL);
+		if (clErr != CL_SUCCESS) { cout << "clEnqueueUnmapMemObject Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+		clErr = clFinish(queue);
+		if (clErr != CL_SUCCESS) { cout << "clFinish Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	}
+	double runMs = wallClockMs() - runStart - tuneMs;
+
+	clErr = clReleaseMemObject(memoryBuffer);	// release device buffer
+	clErr = clReleaseMemObject(memoryBuffer2);	// release device buffer
+	return runMs;
+}
+
+/**
+	Runs zeroValues through the chunked streaming pipeline (see 1-openClStreaming.h), so that copies and kernels of
+	different chunks overlap, and the dataset can be bigger than the device memory.
+
+	@return		milliseconds	wall time of the pipeline
+*/
+static double runStreaming(const DriverOptions &options, cl_context context, cl_device_id device, cl_kernel kernel,
+						 cl_uint width, int *vectorA, int *vectorB, Profiler *profiler)
+{
+	cl_int clErr;
+	size_t numberOfElements = options.numberOfElements;
+	double phaseStart = wallClockMs();
+	StreamPipeline pipeline;
+	size_t chunkElements = streamChunkElements(device, numberOfElements, options.streamBuffers, options.streamChunk);
+	streamPipelineCreate(&pipeline, context, device, chunkElements, options.streamBuffers);
+	profilerAddPhase(profiler, "buffer creation", wallClockMs() - phaseStart);
+
+	// the geometry is tuned for one chunk, on the first buffer set
+	phaseStart = wallClockMs();
+	cl_int imax = (cl_int) chunkElements;
+	clErr  = clSetKernelArg(kernel,0,sizeof(cl_mem),&pipeline.inputs[0]);
+	clErr |= clSetKernelArg(kernel,1,sizeof(cl_mem),&pipeline.outputs[0]);
+	clErr |= clSetKernelArg(kernel,2,sizeof(cl_int),&imax);
+	if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	LaunchGeometry geometry = zeroValuesGeometry(options, pipeline.queues[STREAM_KERNEL_QUEUE], device, kernel, width,
+												 chunkElements);
+	profilerAddPhase(profiler, "launch geometry", wallClockMs() - phaseStart);
+
+	// a mapped input bigger than a share of the RAM goes through the pipeline one window at a time: the next window
+	// is prefetched, and the pages of the finished one dropped (see 1-openClMappedFile.h)
+	size_t windowElements = numberOfElements;
+	if (options.inputMapping != NULL) windowElements = mappedWindowBytes(options.inputMapping) / sizeof(int);
+	StreamReport report;
+	report.chunks = 0;
+	report.wallMs = report.writeMs = report.kernelMs = report.readMs = 0;
+	size_t windows = 0;
+	for (size_t first = 0; first < numberOfElements; first += windowElements, windows++)
+	{
+		size_t count = numberOfElements - first < windowElements ? numberOfElements - first : windowElements;
+		if (options.inputMapping != NULL)
+			adviseWillNeed(options.inputMapping, (first + count) * sizeof(int), windowElements * sizeof(int));
+		StreamReport window = streamPipelineRun(&pipeline, kernel, vectorA + first, vectorB + first, count, geometry, NULL);
+		if (options.inputMapping != NULL) adviseDone(options.inputMapping, first * sizeof(int), count * sizeof(int));
+		if (options.outputMapping != NULL) adviseDone(options.outputMapping, first * sizeof(int), count * sizeof(int));
+		report.chunks += window.chunks;
+		report.wallMs += window.wallMs;
+		report.writeMs += window.writeMs;
+		report.kernelMs += window.kernelMs;
+		report.readMs += window.readMs;
+	}
+	profilerAddPhase(profiler, "streaming pipeline", report.wallMs);
+	streamPipelineRelease(&pipeline);
+	if (windows > 1) cout << endl << "Mapped input streamed in " << windows << " windows of " << windowElements << " elements";
+
+	double busy = report.writeMs + report.kernelMs + report.readMs;
+	cout << endl << "Streaming: " << report.chunks << " chunks of " << chunkElements << " elements, "
+		 << options.streamBuffers << " buffer sets" << endl;
+	cout << "\twrite " << report.writeMs << " ms, kernel " << report.kernelMs << " ms, read " << report.readMs
+		 << " ms, wall " << report.wallMs << " ms (overlap x" << (report.wallMs > 0 ? busy / report.wallMs : 0) << ", "
+		 << 2.0 * numberOfElements * sizeof(int) / (report.wallMs * 1e6) << " GB/s end to end)" << endl;
+	return report.wallMs;
+}
+
+/**
+	Runs the job with the zeroValuesSpecialized kernel (see 1-openClSpecialization.h), options.specializeJobs times.
+	The launch geometry is the one of the generic scalar kernel, and becomes part of the shape: only the first job
+	builds the specialized program, the next ones find it in the in-process cache.
+
+	@return		milliseconds	wall time of the copies and every job, without the tuning and the program builds
+*/
+static double runSpecialized(const DriverOptions &options, cl_context context, cl_device_id device,
+						   cl_command_queue queue, KernelLibrary *library, const char *src, size_t srcsize,
+						   int *vectorA, int *vectorB, Profiler *profiler)
+{
+	cl_int clErr;
+	size_t numberOfElements = options.numberOfElements;
+	size_t bufferSize = numberOfElements * sizeof(int);
+	double phaseStart = wallClockMs();
+	cl_mem memoryBuffer = clCreateBuffer(context, CL_MEM_READ_ONLY, bufferSize, NULL, &clErr);
+	if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	cl_mem memoryBuffer2 = clCreateBuffer(context, CL_MEM_WRITE_ONLY, bufferSize, NULL, &clErr);
+	if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	profilerAddPhase(profiler, "specialized: buffer creation", wallClockMs() - phaseStart);
+
+	double runStart = wallClockMs();
+	double excludedMs = 0;
+	cl_event event;
+	clErr = clEnqueueWriteBuffer(queue, memoryBuffer, CL_TRUE, 0, bufferSize, (void*) vectorA, 0, NULL, &event);
+	if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	profilerAddStage(profiler, "specialized: write vectorA", event, bufferSize, 0);
+
+	// the shape takes the geometry of the generic kernel, tuned on the same buffers
+	phaseStart = wallClockMs();
+	cl_int imax = (cl_int) numberOfElements;
+	cl_kernel generic = kernelLibraryGet(library, "zeroValues");
+	clErr  = clSetKernelArg(generic,0,sizeof(cl_mem),&memoryBuffer);
+	clErr |= clSetKernelArg(generic,1,sizeof(cl_mem),&memoryBuffer2);
+	clErr |= clSetKernelArg(generic,2,sizeof(cl_int),&imax);
+	if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	LaunchGeometry geometry = zeroValuesGeometry(options, queue, device, generic, 1, numberOfElements);
+	excludedMs += wallClockMs() - phaseStart;
+	profilerAddPhase(profiler, "specialized: launch geometry", wallClockMs() - phaseStart);
+
+	KernelSpecialization spec;
+	spec.numberOfElements = numberOfElements;
+	spec.localSize = geometry.localSize;
+	spec.globalSize = geometry.globalSize;
+	spec.operand = ZERO_VALUES_OPERAND;
+	spec.elementType = "int";			// vectorA and vectorB are int arrays
+	cout << endl << "Specialized kernel: " << specializationOptions(spec) << endl;
+
+	SpecializationCache cache;
+	specializationCacheInit(&cache);
+	for (int job = 0; job < options.specializeJobs; job++)
+	{
+		double buildMs;
+		size_t misses = cache.misses;
+		cl_program specialized = specializedProgram(&cache, context, device, src, srcsize, spec, options.cacheDir, &buildMs);
+		bool built = cache.misses != misses;
+		if (built) profilerAddPhase(profiler, "specialized: program build", buildMs);
+		excludedMs += buildMs;
+
+		cl_kernel kernel = clCreateKernel(specialized,"zeroValuesSpecialized",&clErr);
+		if (clErr != CL_SUCCESS) { cout << "clCreateKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+		clErr  = clSetKernelArg(kernel,0,sizeof(cl_mem),&memoryBuffer);
+		clErr |= clSetKernelArg(kernel,1,sizeof(cl_mem),&memoryBuffer2);
+		if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+		clErr = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &geometry.globalSize, &geometry.localSize, 0, NULL, &event);
+		if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+		clWaitForEvents(1, &event);
+		clReleaseKernel(kernel);
+
+		cl_ulong start, end;
+		clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL);
+		clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL);
+		profilerAddStage(profiler, "specialized: kernel zeroValuesSpecialized", event, 0, numberOfElements);
+		cout << "\tjob " << job + 1 << ": program " << (built ? "built" : "reused") << " in " << buildMs << " ms, kernel "
+			 << (end - start) * 1e-6 << " ms" << endl;
+	}
+
+	clErr = clEnqueueReadBuffer(queue, memoryBuffer2, CL_TRUE, 0, bufferSize, (void*) vectorB, 0, NULL, &event);
+	if (clErr != CL_SUCCESS) { cout << "clEnqueueReadBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	profilerAddStage(profiler, "specialized: read vectorB", event, bufferSize, 0);
+	double runMs = wallClockMs() - runStart - excludedMs;
+	cout << "\t" << cache.misses << " build(s), " << cache.hits << " in-process cache hit(s)" << endl;
+
+	specializationCacheRelease(&cache);
+	clReleaseMemObject(memoryBuffer);
+	clReleaseMemObject(memoryBuffer2);
+	return runMs;
+}
+
+/**
+	Runs the job on the host engine and the device at the same time (see 1-openClCoExecution.h), after running it on
+	each of them alone through the same work queue, so the three can be compared.
+
+	@return		milliseconds	wall time of the co-executed job
+*/
+static double runCoExecution(const DriverOptions &options, cl_context context, cl_device_id device,
+							 cl_command_queue queue, cl_kernel kernel, cl_uint width, int *vectorA, int *vectorB,
+							 Profiler *profiler)
+{
+	cl_int clErr;
+	size_t numberOfElements = options.numberOfElements;
+	double phaseStart = wallClockMs();
+	size_t deviceBatch = streamChunkElements(device, numberOfElements, 2, options.coExecuteBatch);
+	CoExecution co;
+	coExecutionCreate(&co, context, device, queue, COEXEC_HOST_CHUNK, deviceBatch);
+
+	// one host thread is left for the device feeder
+	unsigned hostThreads = options.hostThreads;
+	if (hostThreads == 0) hostThreads = thread::hardware_concurrency() > 1 ? thread::hardware_concurrency() - 1 : 1;
+	HostEngine engine;
+	hostEngineCreate(&engine, hostThreads, SIMD_AVX512);
+	profilerAddPhase(profiler, "co-execution setup", wallClockMs() - phaseStart);
+
+	// the geometry is tuned for one full batch
+	phaseStart = wallClockMs();
+	cl_int imax = (cl_int) deviceBatch;
+	clErr  = clSetKernelArg(kernel,0,sizeof(cl_mem),&co.input);
+	clErr |= clSetKernelArg(kernel,1,sizeof(cl_mem),&co.output);
+	clErr |= clSetKernelArg(kernel,2,sizeof(cl_int),&imax);
+	if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	LaunchGeometry geometry = zeroValuesGeometry(options, queue, device, kernel, width, deviceBatch);
+	profilerAddPhase(profiler, "launch geometry", wallClockMs() - phaseStart);
+
+	const char *names[] = {"device only", "host only", "co-execution"};
+	bool useHost[] = {false, true, true};
+	bool useDevice[] = {true, false, true};
+	double bytes = 2.0 * numberOfElements * sizeof(int);
+	CoExecutionReport report;
+	cout << endl << "Co-execution (" << engine.threads.size() << " " << simdLevelName(engine.simd) << " host threads, "
+		 << "host chunks of " << COEXEC_HOST_CHUNK << ", device batches up to " << deviceBatch << " elements):" << endl;
+	for (int run = 0; run < 3; run++)
+	{
+		report = coExecutionRun(&co, kernel, geometry, &engine, vectorA, vectorB, numberOfElements, ZERO_VALUES_OPERAND,
+								useHost[run], useDevice[run]);
+		profilerAddPhase(profiler, names[run], report.wallMs);
+		cout << "\t" << names[run] << ": " << report.wallMs << " ms, " << bytes / (report.wallMs * 1e6) << " GB/s  (host "
+			 << report.hostElements << " elements in " << report.hostChunks << " chunks, device " << report.deviceElements
+			 << " elements in " << report.deviceBatches << " batches)" << endl;
+	}
+
+	hostEngineRelease(&engine);
+	coExecutionRelease(&co);
+	return report.wallMs;
+}
+
+/**
+	Prints the startup latency (everything until the device is ready to take commands), whether the program was
+	built from source (cold) or loaded from the program cache (warm), and how much of the build the host preparation
+	hid (waitMs: time blocked joining the build).
+*/
+static void reportStartup(const DriverOptions &options, const ProgramCacheResult &cacheResult, double waitMs,
+						  double startupStart, Profiler *profiler)
+{
+    double startupMs = wallClockMs() - startupStart;
+    profilerAddPhase(profiler, "startup total", startupMs);
+    if (cacheResult.warm)
+    	cout << endl << "Startup: " << startupMs << " ms (warm: program loaded from cache in " << cacheResult.milliseconds
+    		 << " ms, the cold build took " << cacheResult.coldMilliseconds << " ms)" << endl;
+    else
+    	cout << endl << "Startup: " << startupMs << " ms (cold: program built from source in " << cacheResult.milliseconds
+    		 << " ms" << (cacheResult.stored ? ", binary stored in the cache" : options.cacheDir != NULL ?
+    		 ", binary not stored in the cache" : "") << ")" << endl;
+    if (options.syncBuild)
+    	cout << "\tbuilt before the host data was prepared (--sync-build)" << endl;
+    else
+    	cout << "\tbuilt while the host data was prepared: " << waitMs << " ms waited at the join, "
+    		 << (cacheResult.milliseconds > waitMs ? cacheResult.milliseconds - waitMs : 0) << " ms hidden" << endl;
+}
+
+/**
+	Opens the device of the single-device run: the first GPU of any platform or, if there is none, the first device
+	found. Its context and queue are created, and the build of the kernel library is started on a worker thread
+	(with --sync-build, the build is joined before returning).
+
+	@return		found			false if no platform has a device
+*/
+static bool openDevice(const DriverOptions &options, const char *src, size_t srcsize, cl_uint numPlatforms,
+					   cl_platform_id *platforms, DeviceSession *session, Profiler *profiler)
+{
+	cl_int clErr;
+	cl_uint numDevices;
+	double phaseStart = wallClockMs();
+
+	// finding the device (and the platform it belongs to)
+	cl_platform_id platform = NULL;
+	cl_device_id device = NULL;
+	cl_device_type wanted[] = {CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_ALL};
+	for (int t = 0; t < 2 && device == NULL; t++)
+		for (cl_uint p = 0; p < numPlatforms && device == NULL; p++)
+			if (clGetDeviceIDs(platforms[p],wanted[t],1,&device,&numDevices) == CL_SUCCESS && numDevices > 0)
+				platform = platforms[p];
+			else device = NULL;
+	if (device == NULL) { cout << "No OpenCL device found." << endl; return false;}
+	session->device = device;
+
+	// create context
+	cl_context_properties properties[] = {CL_CONTEXT_PLATFORM,	(cl_context_properties) platform, 0};
+	session->context = clCreateContext(properties,1,&device,NULL,NULL,&clErr);
+	if (clErr != CL_SUCCESS) { cout << "clCreateContext Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+
+	// create command queue
+    session->queue = clCreateCommandQueue(session->context,device,CL_QUEUE_PROFILING_ENABLE,&clErr);
+    if (clErr != CL_SUCCESS) { cout << "clCreateCommandQueue Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	profilerAddPhase(profiler, "context creation", wallClockMs() - phaseStart);
+
+	// start compiling the program of the whole kernel library (loaded from the program cache, when a previous run
+	// already built it), while the host goes on with its own setup
+	kernelLibraryCreateAsync(&session->library, session->context, device, src, srcsize, "", options.cacheDir,
+							 &session->cacheResult, &session->build);
+	if (options.syncBuild) kernelLibraryWait(&session->build);
+	return true;
+}
+
+/**
+	Whether a demo of the engines (see 1-openClEngineDemos.h) can run after the job: they need the whole input on
+	the device, so they are skipped, with a note, for a streamed job.
+*/
+static bool wholeBuffers(const char *demo, bool stream)
+{
+	if (stream) cout << endl << demo << ": skipped for a streamed job (needs whole buffers)" << endl;
+	return !stream;
+}
+
+/**
+	Runs the job on the device opened by openDevice, once its build is joined.
+
+	@return		milliseconds	wall time of the job (the fastest memory mode with --compare-mem)
+*/
+static double runSingleDevice(const DriverOptions &options, DeviceSession *session, const char *src, size_t srcsize,
+							  int *vectorA, int *vectorB, Profiler *profiler, double startupStart)
+{
+	size_t numberOfElements = options.numberOfElements;
+	cl_device_id device = session->device;
+	cl_context context = session->context;
+	cl_command_queue queue = session->queue;
+
+	// join the build of the program, started when the device was opened
+	double waitMs = kernelLibraryWait(&session->build);
+	ProgramCacheResult &cacheResult = session->cacheResult;
+	KernelLibrary &library = session->library;
+	profilerAddPhase(profiler, cacheResult.warm ? "program load (warm cache)" : "program build (cold)",
+					 cacheResult.milliseconds);
+	profilerAddPhase(profiler, "program build join", waitMs);
+
+	// get the kernel (the vector width variant that suits the device, unless one is asked for)
+	cl_uint width = options.vectorWidth != 0 ? options.vectorWidth : selectVectorWidth(device);
+	cl_kernel kernel = kernelLibraryGet(&library, zeroValuesKernelName(width));
+	cout << endl << "Kernel: " << zeroValuesKernelName(width) << " on " << deviceInfoString(device, CL_DEVICE_NAME) << endl;
+
+    reportStartup(options, cacheResult, waitMs, startupStart, profiler);
+
+
+    // *********************************************************************************************************************
+	// ********************************** ALLOCATE SPACE AND SET UP ARGS IN GPU. RUN KERNEL ********************************
+	// *********************************************************************************************************************
+
+	// whole buffers when they fit the device (and the kernel's int counter), the streaming pipeline otherwise
+	bool stream = options.streamMode == 2 || numberOfElements > 0x7fffffff ||
+				  (options.streamMode == 1 && streamingRequired(device, numberOfElements * sizeof(int))) ||
+				  (options.inputMapping != NULL && mappedWindowBytes(options.inputMapping) < options.inputMapping->bytes);
+	if (options.compareVector && !stream)
+	{
+		string tuningFile = options.cacheDir != NULL ? string(options.cacheDir) + "/launchTuning.txt" : "";
+		compareVectorWidths(context, device, queue, &library, vectorA, numberOfElements,
+							options.cacheDir != NULL ? tuningFile.c_str() : NULL, options.tuneMode);
+	}
+	double runMs;
+	if (stream)
+		runMs = runStreaming(options, context, device, kernel, width, vectorA, vectorB, profiler);
+	else if (options.coExecute)
+		runMs = runCoExecution(options, context, device, queue, kernel, width, vectorA, vectorB, profiler);
+	else if (options.specializeJobs > 0)
+		runMs = runSpecialized(options, context, device, queue, &library, src, srcsize, vectorA, vectorB, profiler);
+	else if (options.compareMemory)
+	{
+		double copyMs = runWholeBuffers(options, MEMORY_COPY, context, device, queue, kernel, width, vectorA, vectorB, profiler);
+		memset(vectorB, 0, numberOfElements * sizeof(int));
+		double zeroCopyMs = runWholeBuffers(options, MEMORY_ZERO_COPY, context, device, queue, kernel, width, vectorA, vectorB, profiler);
+		double bytes = 2.0 * numberOfElements * sizeof(int);
+		cout << endl << "Memory modes (device " << (deviceHasUnifiedMemory(device) ? "shares" : "doesn't share")
+			 << " the host memory, auto picks " << memoryModeName(resolveMemoryMode(MEMORY_AUTO, device)) << "):" << endl;
+		cout << "\t" << "copy:      " << copyMs << " ms, " << bytes / (copyMs * 1e6) << " GB/s" << endl;
+		cout << "\t" << "zero-copy: " << zeroCopyMs << " ms, " << bytes / (zeroCopyMs * 1e6) << " GB/s" << endl;
+		runMs = copyMs < zeroCopyMs ? copyMs : zeroCopyMs;
+	}
+	else
+	{
+		MemoryMode mode = resolveMemoryMode(options.memoryMode, device);
+		runMs = runWholeBuffers(options, mode, context, device, queue, kernel, width, vectorA, vectorB, profiler);
+		cout << endl << "Memory mode " << memoryModeName(mode) << ": " << runMs << " ms, "
+			 << 2.0 * numberOfElements * sizeof(int) / (runMs * 1e6) << " GB/s" << endl;
+	}
+
+	DemoDevice demo = {context, device, queue, &library, profiler};
+	if (options.reduceOps != 0 && wholeBuffers("Reductions", stream))
+	{
+		string tuningFile = options.cacheDir != NULL ? string(options.cacheDir) + "/launchTuning.txt" : "";
+		demoReductions(demo, kernel, width, options.cacheDir != NULL ? tuningFile.c_str() : NULL, options.tuneMode,
+					   vectorA, vectorB, numberOfElements, options.reduceOps);
+	}
+	if (options.scan && wholeBuffers("Scan", stream))
+		demoScan(demo, vectorA, numberOfElements, options.scanKind);
+	if (options.sort && wholeBuffers("Radix sort", stream))
+		demoRadixSort(demo, vectorA, numberOfElements, options.sortKeyType);
+	if (options.histogramBins > 0 && wholeBuffers("Histogram", stream))
+		demoHistogram(demo, vectorA, numberOfElements, options.histogramBins);
+	if (options.gemmSize > 0) demoGemm(demo, options.gemmSize, options.hostThreads);
+	if (options.stencil && wholeBuffers("Stencil", stream))
+		demoStencil(demo, vectorA, numberOfElements, options.stencilRadius);
+	if (options.layoutComponents > 0 && wholeBuffers("Layout changes", stream))
+		demoTranspose(demo, vectorA, numberOfElements, options.layoutComponents);
+	if (options.compactPercent > 0 && wholeBuffers("Compaction", stream))
+		demoCompact(demo, vectorA, numberOfElements, options.compactPercent, ZERO_VALUES_OPERAND);
+
+	kernelLibraryRelease(&library);				// release kernels and program
+    clReleaseCommandQueue(queue);				// release command queue
+    clReleaseContext(context);					// release context
+    return runMs;
+}
+
+/**
+	Splits the job between every usable device of every platform (see 1-openClMultiDevice.h), in shares sized by
+	the throughput each device shows on a calibration sample. The results are merged in place into vectorB.
+
+	@param		multi			workers set up by multiDeviceCreate
+	@return		milliseconds	wall time of the job, once every device is calibrated
+*/
+static double runMultiDevice(const DriverOptions &options, MultiDevice &multi, int *vectorA, int *vectorB,
+						   Profiler *profiler, double startupStart)
+{
+	double phaseStart = wallClockMs();
+	size_t sampleElements = options.numberOfElements < (1 << 20) ? options.numberOfElements : (1 << 20);
+	string tuningFile = options.cacheDir != NULL ? string(options.cacheDir) + "/launchTuning.txt" : "";
+	multiDeviceCalibrate(&multi, vectorA, vectorB, sampleElements,
+						 options.cacheDir != NULL ? tuningFile.c_str() : NULL, options.tuneMode, options.compareVector);
+	profilerAddPhase(profiler, "multi-device calibration", wallClockMs() - phaseStart);
+	profilerAddPhase(profiler, "startup total", wallClockMs() - startupStart);
+
+	double runMs = multiDeviceRun(&multi, vectorA, vectorB, options.numberOfElements, profiler);
+	cout << "\ttotal: " << runMs << " ms, " << 2.0 * options.numberOfElements * sizeof(int) / (runMs * 1e6)
+		 << " GB/s" << endl;
+	multiDeviceRelease(&multi);
+	return runMs;
+}
+
+/**
+	Runs the job on the native host engine (see 1-openClHostEngine.h): in place of OpenCL when there is no device,
+	or into a separate array as the baseline of the OpenCL job, whose results are then checked against it.
+
+	@param		deviceMs		wall time of the OpenCL job, or -1 if the host engine is the only one running
+*/
+static void runHostEngine(const DriverOptions &options, int *vectorA, int *vectorB, double deviceMs, Profiler *profiler)
+{
+	size_t numberOfElements = options.numberOfElements;
+	double phaseStart = wallClockMs();
+	HostEngine engine;
+	hostEngineCreate(&engine, options.hostThreads, SIMD_AVX512);
+	int *output = deviceMs < 0 ? vectorB : (int*) allocateHostBuffer(numberOfElements * sizeof(int));
+	profilerAddPhase(profiler, "host engine setup", wallClockMs() - phaseStart);
+
+	// the first run also pays the page faults of the output, the second one is the measure
+	double firstMs = hostEngineRun(&engine, vectorA, output, numberOfElements, ZERO_VALUES_OPERAND);
+	double hostMs = hostEngineRun(&engine, vectorA, output, numberOfElements, ZERO_VALUES_OPERAND);
+	profilerAddPhase(profiler, "host engine (first run)", firstMs);
+	profilerAddPhase(profiler, "host engine", hostMs);
+
+	cout << endl << "Host engine (" << simdLevelName(engine.simd) << ", " << engine.threads.size() << " threads): "
+		 << hostMs << " ms, " << 2.0 * numberOfElements * sizeof(int) / (hostMs * 1e6) << " GB/s" << endl;
+	if (deviceMs >= 0)
+	{
+		size_t mismatches = 0;
+		for (size_t i = 0; i < numberOfElements; i++) if (output[i] != vectorB[i]) mismatches++;
+		cout << "\tOpenCL job: " << deviceMs << " ms, offload " << (deviceMs < hostMs ? "pays off" : "doesn't pay off")
+			 << " at this size (x" << hostMs / deviceMs << "), " << mismatches << " mismatching elements" << endl;
+		freeHostBuffer(output);
+	}
+	hostEngineRelease(&engine);
+}
+
 /**
 	To use the GPU/CPU through OpenCL, I need:
 	-> A context 		(linked to a device)
@@ -188,20 +769,363 @@ void platformInfo(cl_uint numPlatforms, cl_platform_id *platforms)
 	-> Execute Kernel 	(enqueueing the parallel execution in the GPU/CPU)
 	-> Read from buffer (reading the result of the computation of the device back into the HOST program)
 	
-	This example works with one GPU at least (I don't have hardware to test differently, but should work for every GPU)
+	The kernels (every .cl file of KERNELS in 1-Makefile) are embedded in the binary and built as one program, so
+	the application needs no kernel file at runtime (see 1-openClKernelLibrary.h).
+
+	This example works with one GPU at least (I don't have hardware to test differently, but should work for every GPU).
+	Without a GPU, the first OpenCL device found is used.
+
+	Every enqueue is timed through its event (see 1-openClProfiler.h), and the report is printed at the end:
+		--profile-format text|csv|json		format of the report (text by default)
+		--profile-out <file>				write the report to a file instead of the standard output
+
+	The compiled program is kept in an on-disk cache (see 1-openClProgramCache.h), so only the first run pays the build:
+		--cache-dir <dir>					directory of the program cache (.clcache by default)
+		--no-cache							always build the program from source
+		--sync-build						build (or load) the program before preparing the host data, instead of
+											on a worker thread meanwhile, to compare the startup latency
+
+	The device properties are kept in <cache dir>/deviceCapabilities.json (see 1-openClCapabilities.h), and only
+	queried again for new devices or driver versions (clInfo --json dumps every property, in the same format).
+
+	The NDRange of the kernel is auto-tuned (see 1-openClAutoTuner.h) and stored in <cache dir>/launchTuning.txt:
+		--tune								tune again, even if a geometry is stored for this device and size
+		--no-tune							use a geometry derived from the device limits, without tuning
+
+	Datasets that don't fit the device are streamed in chunks (see 1-openClStreaming.h):
+		--elements <n>						number of elements of the dataset (8192*4096 by default)
+		--stream[=<elements per chunk>]		always stream, optionally with a given chunk size
+		--stream-buffers 2|3				buffer sets of the pipeline (3 by default)
+
+	Whole buffers either copy the data, or use the host arrays in place (see 1-openClHostMemory.h):
+		--mem copy|zerocopy|auto			memory mode (auto: zero-copy if the device shares the host memory)
+		--compare-mem						run with both modes, and show their throughput side by side
+
+	One job can also be split between every device of every platform (see 1-openClMultiDevice.h):
+		--multi-device						use every device, with shares sized by their measured throughput
+		--sub-devices <n>					split each CPU device in n sub-devices (with --multi-device, needs OpenCL 1.2)
+
+	The kernel comes in int, int4, int8 and int16 variants (see 1-openClVectorKernels.h):
+		--vector auto|1|4|8|16				vector width (auto: from the device's preferred and native int widths)
+		--compare-vector					benchmark every width against the scalar kernel, on each device used
+
+	Fixed-shape jobs can use a kernel specialized at build time (see 1-openClSpecialization.h):
+		--specialize[=<jobs>]				run the job (1 time by default) with size, stride, operand and type
+											given as -D macros, reusing the program of the shape between jobs
+
+	A native multithreaded SIMD engine (see 1-openClHostEngine.h) runs the job when there is no OpenCL device, and
+	after every OpenCL job as a baseline:
+		--host								run on the host engine only
+		--host-threads <n>					threads of the host engine (one per hardware thread by default)
+		--no-baseline						don't run the host baseline after the OpenCL job
+		--coexec[=<batch>]					share the job between the host engine and the device through a
+											work-stealing queue (see 1-openClCoExecution.h), with device batches of
+											at most <batch> elements
+
+	The results are written by a parallel output stage (see 1-openClOutput.h), instead of one cout per element:
+		--output summary|binary|text		checksum, min/max and first/last elements (default), raw ints, or text
+		--output-file <file>				destination of the results (results.bin by default for binary output)
+		--summary-edge <n>					first and last elements shown by the summary (10 by default)
+
+	The input can be a binary file of ints, memory-mapped instead of copied (see 1-openClMappedFile.h). Its pages go
+	straight to the device (or back a zero-copy buffer), and with binary output the results are mapped as well:
+		--input <file>						input file (--elements is then the size of the file)
+
+	The output can be reduced on the device, reading back one scalar instead of the whole array (see
+	1-openClReduction.h), for the int output and a float copy of it, checked against the host:
+		--reduce sum|min|max|argmax|all		reduction to run (can be given several times)
+
+	The input can be prefix summed on the device as well (see 1-openClScan.h), with the multi-level scan and, where
+	the device supports it, the single pass decoupled lookback:
+		--scan[=exclusive|inclusive]		scan vectorA (exclusive by default), and report the GB/s of each algorithm
+
+	Keys derived from the input can be radix sorted on the device (see 1-openClRadixSort.h), with their indices as
+	payloads, checked for a stable order and timed against std::sort:
+		--sort int|uint|float				type of the keys
+
+	A histogram of values derived from the input can be counted on the device (see 1-openClHistogram.h), with
+	__local sub-histograms merged by a second kernel, and with atomics in global memory:
+		--histogram[=<bins>]				bins of the histogram (256 by default)
+
+	Square matrices can be multiplied on the device (see 1-openClGemm.h), in float and, where the device supports
+	cl_khr_fp64, in double, with a naive kernel and a tiled one, against a blocked multithreaded host version:
+		--gemm[=<n>]						rows and columns of the matrices (1024 by default)
+
+	The input can be convolved as a square grid on the device (see 1-openClStencil.h), through tiles and halos in
+	__local memory or through an image and its texture cache, whichever is measured faster:
+		--stencil[=<radius>]				radius of the filters (2 by default)
+
+	The input can go through layout changes on the device (see 1-openClTranspose.h): a transpose, and records split
+	into one array per component and gathered back, against the bandwidth of clEnqueueCopyBuffer:
+		--transpose[=<components>]			components of the records (4 by default)
+
+	The output of zeroValues can be filtered on the device (see 1-openClCompact.h), so only the kept values and
+	their count are read back, in any order (one atomic per work-group) or in the order of the input:
+		--compact[=<percent>]				share of the values kept (10 by default)
 */
 int main(int argc, char *argv[])
 {
+	double startupStart = wallClockMs();
 	cl_int clErr;
-	cl_uint numPlatforms, numDevices;
-	int MAX_SOURCE_SIZE = 8192;
-	int numberOfElements = 8192*4096;	// maximum of elements that I can allocate (8192 * 8192 is already 512MB in the GPU)
-	int sizeOfEachElement = sizeof(int);
+	cl_uint numPlatforms;
 
-	// creating the data to send to the GPU
-	int *vectorA = new int[numberOfElements]; memset(vectorA, 0, numberOfElements * sizeof(int)); 
-	int *vectorB = new int[numberOfElements]; memset(vectorB, 0, numberOfElements * sizeof(int));
-	for (int i=0; i < numberOfElements; i++) vectorA[i] = i;
+	// command line options
+	DriverOptions options;
+	options.numberOfElements = 8192*4096;	// what fits whole in my GPU (8192 * 8192 is already 512MB), bigger sizes are streamed
+	options.profileFormat = PROFILE_TEXT;
+	options.profileOut = NULL;
+	options.cacheDir = ".clcache";
+	options.tuneMode = 1;
+	options.streamMode = 1;
+	options.streamChunk = 0;
+	options.streamBuffers = 3;
+	options.memoryMode = MEMORY_AUTO;
+	options.compareMemory = false;
+	options.vectorWidth = 0;
+	options.compareVector = false;
+	options.specializeJobs = 0;
+	options.multiDevice = false;
+	options.subDevices = 0;
+	options.hostOnly = false;
+	options.baseline = true;
+	options.hostThreads = 0;
+	options.coExecute = false;
+	options.coExecuteBatch = 0;
+	options.outputMode = OUTPUT_SUMMARY;
+	options.outputFile = NULL;
+	options.summaryEdge = 10;
+	options.inputFile = NULL;
+	options.inputMapping = NULL;
+	options.outputMapping = NULL;
+	options.syncBuild = false;
+	options.reduceOps = 0;
+	options.scan = false;
+	options.scanKind = SCAN_EXCLUSIVE;
+	options.sort = false;
+	options.sortKeyType = RADIX_INT;
+	options.histogramBins = 0;
+	options.gemmSize = 0;
+	options.stencil = false;
+	options.stencilRadius = 2;
+	options.layoutComponents = 0;
+	options.compactPercent = 0;
+	static struct option longOptions[] = {
+		{"profile-format",	1, 0, 'f'},
+		{"profile-out",		1, 0, 'o'},
+		{"cache-dir",		1, 0, 'c'},
+		{"no-cache",		0, 0, 'n'},
+		{"tune",			0, 0, 't'},
+		{"no-tune",			0, 0, 'T'},
+		{"elements",		1, 0, 'e'},
+		{"stream",			2, 0, 's'},
+		{"stream-buffers",	1, 0, 'b'},
+		{"mem",				1, 0, 'm'},
+		{"compare-mem",		0, 0, 'M'},
+		{"vector",			1, 0, 'v'},
+		{"compare-vector",	0, 0, 'V'},
+		{"specialize",		2, 0, 'S'},
+		{"multi-device",	0, 0, 'd'},
+		{"sub-devices",		1, 0, 'D'},
+		{"host",			0, 0, 'H'},
+		{"host-threads",	1, 0, 'j'},
+		{"no-baseline",		0, 0, 'B'},
+		{"coexec",			2, 0, 'x'},
+		{"output",			1, 0, 'r'},
+		{"output-file",		1, 0, 'R'},
+		{"summary-edge",	1, 0, 'N'},
+		{"input",			1, 0, 'i'},
+		{"sync-build",		0, 0, 'Y'},
+		{"reduce",			1, 0, 'g'},
+		{"scan",			2, 0, 'q'},
+		{"sort",			1, 0, 'k'},
+		{"histogram",		2, 0, 'u'},
+		{"gemm",			2, 0, 'G'},
+		{"stencil",			2, 0, 'l'},
+		{"transpose",		2, 0, 'p'},
+		{"compact",			2, 0, 'C'},
+		{"help",			0, 0, 'h'},
+		{0, 0, 0, 0}
+	};
+	int opt;
+	while ((opt = getopt_long(argc, argv, "f:o:c:ntTe:s::b:m:Mv:VS::dD:Hj:Bx::r:R:N:i:Yg:q::k:u::G::l::p::C::h", longOptions, NULL)) != EOF)
+	{
+		switch (opt)
+		{
+		case 'f':
+			if (strcmp(optarg, "text") == 0) options.profileFormat = PROFILE_TEXT;
+			else if (strcmp(optarg, "csv") == 0) options.profileFormat = PROFILE_CSV;
+			else if (strcmp(optarg, "json") == 0) options.profileFormat = PROFILE_JSON;
+			else { cout << "Unknown profile format: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'o':
+			options.profileOut = optarg;
+			break;
+		case 'c':
+			options.cacheDir = optarg;
+			break;
+		case 'n':
+			options.cacheDir = NULL;
+			break;
+		case 't':
+			options.tuneMode = 2;
+			break;
+		case 'T':
+			options.tuneMode = 0;
+			break;
+		case 'e':
+			options.numberOfElements = strtoull(optarg, NULL, 10);
+			if (options.numberOfElements == 0) { cout << "Invalid number of elements: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 's':
+			options.streamMode = 2;
+			if (optarg != NULL) options.streamChunk = strtoull(optarg, NULL, 10);
+			break;
+		case 'b':
+			options.streamBuffers = atoi(optarg);
+			if (options.streamBuffers < 2 || options.streamBuffers > 3) { cout << "--stream-buffers must be 2 or 3" << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'm':
+			if (strcmp(optarg, "copy") == 0) options.memoryMode = MEMORY_COPY;
+			else if (strcmp(optarg, "zerocopy") == 0) options.memoryMode = MEMORY_ZERO_COPY;
+			else if (strcmp(optarg, "auto") == 0) options.memoryMode = MEMORY_AUTO;
+			else { cout << "Unknown memory mode: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'M':
+			options.compareMemory = true;
+			break;
+		case 'v':
+			options.vectorWidth = strcmp(optarg, "auto") == 0 ? 0 : (cl_uint) atoi(optarg);
+			if (options.vectorWidth != 0 && options.vectorWidth != 1 && options.vectorWidth != 4 &&
+				options.vectorWidth != 8 && options.vectorWidth != 16)
+				{ cout << "--vector must be auto, 1, 4, 8 or 16" << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'V':
+			options.compareVector = true;
+			break;
+		case 'S':
+			options.specializeJobs = optarg != NULL ? atoi(optarg) : 1;
+			if (options.specializeJobs < 1) { cout << "--specialize needs at least 1 job" << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'd':
+			options.multiDevice = true;
+			break;
+		case 'D':
+			options.subDevices = (cl_uint) atoi(optarg);
+			break;
+		case 'H':
+			options.hostOnly = true;
+			break;
+		case 'j':
+			options.hostThreads = (unsigned) atoi(optarg);
+			break;
+		case 'B':
+			options.baseline = false;
+			break;
+		case 'x':
+			options.coExecute = true;
+			if (optarg != NULL) options.coExecuteBatch = strtoull(optarg, NULL, 10);
+			break;
+		case 'r':
+			if (strcmp(optarg, "summary") == 0) options.outputMode = OUTPUT_SUMMARY;
+			else if (strcmp(optarg, "binary") == 0) options.outputMode = OUTPUT_BINARY;
+			else if (strcmp(optarg, "text") == 0) options.outputMode = OUTPUT_TEXT;
+			else { cout << "Unknown output mode: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'R':
+			options.outputFile = optarg;
+			break;
+		case 'N':
+			options.summaryEdge = strtoull(optarg, NULL, 10);
+			break;
+		case 'i':
+			options.inputFile = optarg;
+			break;
+		case 'Y':
+			options.syncBuild = true;
+			break;
+		case 'g':
+			if (strcmp(optarg, "sum") == 0) options.reduceOps |= 1 << REDUCE_SUM;
+			else if (strcmp(optarg, "min") == 0) options.reduceOps |= 1 << REDUCE_MIN;
+			else if (strcmp(optarg, "max") == 0) options.reduceOps |= 1 << REDUCE_MAX;
+			else if (strcmp(optarg, "argmax") == 0) options.reduceOps |= 1 << REDUCE_ARGMAX;
+			else if (strcmp(optarg, "all") == 0) options.reduceOps = (1 << REDUCE_SUM) | (1 << REDUCE_MIN) |
+																	(1 << REDUCE_MAX) | (1 << REDUCE_ARGMAX);
+			else { cout << "Unknown reduction: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'q':
+			options.scan = true;
+			if (optarg == NULL || strcmp(optarg, "exclusive") == 0) options.scanKind = SCAN_EXCLUSIVE;
+			else if (strcmp(optarg, "inclusive") == 0) options.scanKind = SCAN_INCLUSIVE;
+			else { cout << "Unknown scan: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'k':
+			options.sort = true;
+			if (strcmp(optarg, "int") == 0) options.sortKeyType = RADIX_INT;
+			else if (strcmp(optarg, "uint") == 0) options.sortKeyType = RADIX_UINT;
+			else if (strcmp(optarg, "float") == 0) options.sortKeyType = RADIX_FLOAT;
+			else { cout << "Unknown key type: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'u':
+			options.histogramBins = optarg != NULL ? strtoull(optarg, NULL, 10) : 256;
+			if (options.histogramBins == 0 || options.histogramBins > 0x7fffffff) { cout << "Invalid number of bins: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'G':
+			options.gemmSize = optarg != NULL ? strtoull(optarg, NULL, 10) : 1024;
+			if (options.gemmSize == 0 || options.gemmSize > 0x7fff) { cout << "Invalid matrix size: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'l':
+			options.stencil = true;
+			if (optarg != NULL) options.stencilRadius = strtoull(optarg, NULL, 10);
+			if (options.stencilRadius > 64) { cout << "Invalid stencil radius: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'p':
+			options.layoutComponents = optarg != NULL ? strtoull(optarg, NULL, 10) : 4;
+			if (options.layoutComponents == 0) { cout << "Invalid number of components: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'C':
+			options.compactPercent = optarg != NULL ? strtoull(optarg, NULL, 10) : 10;
+			if (options.compactPercent == 0 || options.compactPercent > 100) { cout << "Invalid compaction percent: " << optarg << endl; exit(EXIT_FAILURE);}
+			break;
+		case 'h':
+		default:
+			cout << "Usage: " << argv[0] << " [--profile-format text|csv|json] [--profile-out <file>]"
+				 << " [--cache-dir <dir> | --no-cache] [--tune | --no-tune]"
+				 << " [--elements <n>] [--stream[=<chunk>]] [--stream-buffers 2|3]"
+				 << " [--mem copy|zerocopy|auto] [--compare-mem] [--multi-device [--sub-devices <n>]]"
+				 << " [--vector auto|1|4|8|16] [--compare-vector] [--specialize[=<jobs>]]"
+				 << " [--host] [--host-threads <n>] [--no-baseline] [--coexec[=<batch>]]"
+				 << " [--output summary|binary|text] [--output-file <file>] [--summary-edge <n>] [--input <file>]"
+				 << " [--sync-build] [--reduce sum|min|max|argmax|all]"
+				 << " [--scan[=exclusive|inclusive]] [--sort int|uint|float]"
+				 << " [--histogram[=<bins>]] [--gemm[=<n>]]"
+				 << " [--stencil[=<radius>]] [--transpose[=<components>]]"
+				 << " [--compact[=<percent>]]" << endl;
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (options.subDevices > 0 && !options.multiDevice) { cout << "--sub-devices needs --multi-device" << endl; exit(EXIT_FAILURE);}
+	Profiler profiler;
+	double phaseStart = wallClockMs();
+
+	// the input file is mapped (read-only, never copied into the heap), and sets the number of elements
+	MappedFile inputMapping, outputMapping;
+	if (options.inputFile != NULL)
+	{
+		if (!mapFileRead(&inputMapping, options.inputFile)) exit(EXIT_FAILURE);
+		options.inputMapping = &inputMapping;
+		options.numberOfElements = inputMapping.bytes / sizeof(int);
+		if (inputMapping.bytes % sizeof(int) != 0)
+			cout << "Ignoring the last " << inputMapping.bytes % sizeof(int) << " bytes of " << options.inputFile << endl;
+		if (options.numberOfElements == 0) { cout << options.inputFile << " holds no int. Quitting..." << endl; exit(EXIT_FAILURE);}
+	}
+	size_t numberOfElements = options.numberOfElements;
+
+	// binary results go straight into a mapped output file, when it can be created
+	if (options.outputMode == OUTPUT_BINARY &&
+		mapFileWrite(&outputMapping, options.outputFile != NULL ? options.outputFile : "results.bin", numberOfElements * sizeof(int)))
+		options.outputMapping = &outputMapping;
+	if (options.inputMapping != NULL || options.outputMapping != NULL)
+		profilerAddPhase(&profiler, "dataset mapping", wallClockMs() - phaseStart);
 
 	
 
@@ -209,96 +1133,92 @@ int main(int argc, char *argv[])
 	// *********************** SETTING UP PLATFORM, DEVICES, CONTEXT, KERNEL COMPILATION, COMMAND QUEUE ********************
 	// *********************************************************************************************************************
 
-	// Read the Kernel with the parallel function
-	char src[MAX_SOURCE_SIZE];			// buffer to read the file
-    FILE *ficheiro;
-    if ((ficheiro = fopen("zeroValuesKernel.cl","r")) == NULL)	
-    	{cout << "Didn't find the Kernel File. Quitting..." << endl; exit(EXIT_FAILURE);}
-    size_t srcsize  = fread(src, 1, MAX_SOURCE_SIZE, ficheiro);    fclose(ficheiro);
-    const char *sourceptr[]={src};	
-
-	// Getting the platforms, to create a context
-	clErr = clGetPlatformIDs( 0, NULL, &numPlatforms);
-	if (clErr != CL_SUCCESS) { cout << "clGetPlatformIDs Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	assert (numPlatforms <= 1);	// if numPlatforms is higher than 1, code needs an extra loop cycle for each platform
-	
-	cl_platform_id platforms[numPlatforms];
-	clErr = clGetPlatformIDs(numPlatforms,platforms,NULL);	// get platform IDs
-	if (clErr != CL_SUCCESS) { cout << "clGetPlatformIDs Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	// The Kernels with the parallel functions are embedded in the binary (see 1-openClKernelLibrary.h)
+	const char *src = kernelLibrarySource().c_str();
+	size_t srcsize = kernelLibrarySource().size();
 
-	platformInfo(numPlatforms, platforms);
+	// Getting the platforms. Without an OpenCL runtime (no platform, CL_PLATFORM_NOT_FOUND_KHR from the ICD loader),
+	// the job falls back to the host engine
+	phaseStart = wallClockMs();
+	numPlatforms = 0;
+	if (!options.hostOnly)
+	{
+		clErr = clGetPlatformIDs( 0, NULL, &numPlatforms);
+		if (clErr != CL_SUCCESS) { cout << "clGetPlatformIDs Error: " << checkError(clErr) << endl; numPlatforms = 0;}
+	}
 	
-	// finding the number of GPUs
-	clErr = clGetDeviceIDs(platforms[0],CL_DEVICE_TYPE_GPU,0,NULL,&numDevices);
-	if (clErr != CL_SUCCESS) { cout << "clGetDeviceIDs Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	cl_device_id devices[numDevices];
-
-	// create context (getting the devices IDs, to create the properties for the context)
-	clErr = clGetDeviceIDs(platforms[0],CL_DEVICE_TYPE_GPU,numDevices,&devices[0],NULL);
-	if (clErr != CL_SUCCESS) { cout << "clGetDeviceIDs Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	cl_context_properties properties[] = {CL_CONTEXT_PLATFORM,	(cl_context_properties) platforms[0], 0};
-	cl_context context = clCreateContext(properties,1,&devices[0],NULL,NULL,&clErr); 
-	if (clErr != CL_SUCCESS) { cout << "clCreateContext Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-
-    // create program from source
-	cl_program program = clCreateProgramWithSource(context,1,sourceptr,&srcsize,&clErr);
-	if (clErr != CL_SUCCESS) { cout << "clCreateProgramWithSource Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}		
-
-	// compile program Kernel
-	clErr = clBuildProgram(program, 1, &devices[0],"",NULL,NULL);
-	if (clErr != CL_SUCCESS) 
-	{ 
-		cout << "clBuildProgram Error: " << checkError(clErr) << ". Log:" << endl; 
-		// print build log
-		size_t errorsize; 
-		clErr = clGetProgramBuildInfo(program,devices[0],CL_PROGRAM_BUILD_LOG,0,NULL,&errorsize);
-		if (clErr != CL_SUCCESS) { cout << "clGetProgramBuildInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}		
-		char build_log[errorsize];
-		clErr = clGetProgramBuildInfo(program,devices[0],CL_PROGRAM_BUILD_LOG,errorsize,build_log,NULL);
-		if (clErr != CL_SUCCESS) { cout << "clGetProgramBuildInfo Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}			
-
-		cout << endl << build_log << endl;
-		exit(EXIT_FAILURE);	
+	cl_platform_id platforms[numPlatforms > 0 ? numPlatforms : 1];
+	if (numPlatforms > 0)
+	{
+		clErr = clGetPlatformIDs(numPlatforms,platforms,NULL);	// get platform IDs
+		if (clErr != CL_SUCCESS) { cout << "clGetPlatformIDs Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
 	}
-	// create kernel
-	cl_kernel kernel = clCreateKernel(program,"zeroValues",&clErr);
-	if (clErr != CL_SUCCESS) { cout << "clCreateKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}	
-
-	// create command queue
-    cl_command_queue queue = clCreateCommandQueue(context,devices[0],CL_QUEUE_PROFILING_ENABLE,&clErr);
-    if (clErr != CL_SUCCESS) { cout << "clCreateCommandQueue Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	profilerAddPhase(&profiler, "platform discovery", wallClockMs() - phaseStart);
 
+	// The device properties used by the tuning decisions come from the capability snapshot of the cache directory
+	// (see 1-openClCapabilities.h), instead of dozens of clGetDeviceInfo calls on every start
+	if (numPlatforms > 0)
+	{
+		phaseStart = wallClockMs();
+		string snapshotPath = options.cacheDir != NULL ? string(options.cacheDir) + "/" + CAPABILITY_SNAPSHOT : "";
+		capabilitiesOpen(options.cacheDir != NULL ? snapshotPath.c_str() : NULL);
+		profilerAddPhase(&profiler, "capability snapshot", wallClockMs() - phaseStart);
+	}
 
+	// The device setup starts before the host data: the programs are built on worker threads while the host fills
+	// its arrays and lists the platforms, and the build is only joined when the first kernel is needed (with
+	// --sync-build, everything runs one step after the other, as the startup used to)
+	MultiDevice multi;
+	thread multiSetup;
+	Profiler multiProfiler;
+	DeviceSession session;
+	bool deviceOpen = false;
+	if (numPlatforms > 0 && options.multiDevice)
+	{
+		multiSetup = thread(multiDeviceCreate, &multi, src, srcsize, options.cacheDir, options.subDevices,
+							options.vectorWidth, &multiProfiler);
+		if (options.syncBuild) multiSetup.join();
+	}
+	else if (numPlatforms > 0)
+		deviceOpen = openDevice(options, src, srcsize, numPlatforms, platforms, &session, &profiler);
 
-    // *********************************************************************************************************************
-	// ********************************** ALLOCATE SPACE AND SET UP ARGS IN GPU. RUN KERNEL ********************************
-	// *********************************************************************************************************************
-    
-    size_t bufferSize = numberOfElements * sizeOfEachElement;		// creating space for numberOfElements integers (CL_MEM_READ_WRITE)
-    cl_mem memoryBuffer = clCreateBuffer(context, CL_MEM_READ_ONLY, bufferSize, NULL, &clErr);
-    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-    cl_mem memoryBuffer2 = clCreateBuffer(context, CL_MEM_WRITE_ONLY, bufferSize, NULL, &clErr);
-    if (clErr != CL_SUCCESS) { cout << "clCreateBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	// creating the data to send to the GPU (page aligned, so zero-copy buffers can use it in place)
+	phaseStart = wallClockMs();
+	int *vectorA, *vectorB;
+	if (options.inputMapping != NULL) vectorA = (int*) inputMapping.data;
+	else
+	{
+		vectorA = (int*) allocateHostBuffer(numberOfElements * sizeof(int));
+		for (size_t i=0; i < numberOfElements; i++) vectorA[i] = (int) i;
+	}
+	if (options.outputMapping != NULL) vectorB = (int*) outputMapping.data;
+	else { vectorB = (int*) allocateHostBuffer(numberOfElements * sizeof(int)); memset(vectorB, 0, numberOfElements * sizeof(int));}
+	profilerAddPhase(&profiler, "host data initialization", wallClockMs() - phaseStart);
 
-	// set kernel arguments
-	clErr = clSetKernelArg(kernel,0,sizeof(cl_mem),&memoryBuffer);
-	if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	clErr = clSetKernelArg(kernel,1,sizeof(cl_mem),&memoryBuffer2);
-	if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	clErr = clSetKernelArg(kernel,2,sizeof(int),&numberOfElements);
-	if (clErr != CL_SUCCESS) { cout << "clSetKernelArg Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	// every platform is listed, whatever device ends up being used
+	if (numPlatforms > 0) platformInfo(numPlatforms, platforms);
 
-	// write vectorA to device buffer
-	clErr = clEnqueueWriteBuffer(queue, memoryBuffer, CL_TRUE, 0, bufferSize, (void*) vectorA, 0, NULL, NULL);
-	if (clErr != CL_SUCCESS) { cout << "clEnqueueWriteBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	double deviceMs = -1;
+	if (numPlatforms > 0 && options.multiDevice)
+	{
+		phaseStart = wallClockMs();
+		if (multiSetup.joinable()) multiSetup.join();
+		profilerAddPhase(&profiler, "multi-device setup join", wallClockMs() - phaseStart);
+		for (size_t p = 0; p < multiProfiler.phases.size(); p++)
+			profilerAddPhase(&profiler, multiProfiler.phases[p].name.c_str(), multiProfiler.phases[p].milliseconds);
+		profilerRelease(&multiProfiler);
+		deviceMs = runMultiDevice(options, multi, vectorA, vectorB, &profiler, startupStart);
+	}
+	else if (deviceOpen)
+		deviceMs = runSingleDevice(options, &session, src, srcsize, vectorA, vectorB, &profiler, startupStart);
 
-	// enqueue kernel
-	cl_uint dim = 1;
-	size_t offset = 0;
-	size_t local_size = 256;
-	size_t global_size = 4*7*local_size;
-	clErr = clEnqueueNDRangeKernel(queue, kernel, dim, &offset, &global_size, &local_size, 0, NULL, NULL);
-	if (clErr != CL_SUCCESS) { cout << "clEnqueueNDRangeKernel Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
+	if (deviceMs < 0)
+	{
+		if (!options.hostOnly) cout << "Running on the host engine instead." << endl;
+		runHostEngine(options, vectorA, vectorB, -1, &profiler);
+	}
+	else if (options.baseline)
+		runHostEngine(options, vectorA, vectorB, deviceMs, &profiler);
 
 
 
@@ -306,23 +1226,48 @@ int main(int argc, char *argv[])
 	// ************************************** COLLECT RESULTS AND DEALLOCATE MEMORY ****************************************
 	// *********************************************************************************************************************
 
-	// reading back the computation of the device
-	clErr = clEnqueueReadBuffer(queue, memoryBuffer2, CL_TRUE, 0, bufferSize, (void*) vectorB, 0, NULL, NULL);
-	if (clErr != CL_SUCCESS) { cout << "clEnqueueReadBuffer Error: " << checkError(clErr) << endl; exit(EXIT_FAILURE);}
-	cout << endl << "Result:  ";
-	//for (int i = 0; i < 10; i++) cout << vectorB[i] << "   ";
-	 for (int i = 0; i < numberOfElements; i++) cout << vectorB[i] << "   ";	 // in case you want to print everything
-	cout << endl;
-
-    
-	clErr = clReleaseKernel(kernel);			// release kernel
-	clErr = clReleaseProgram(program);			// release program
-	clErr = clReleaseMemObject(memoryBuffer);	// release device buffer
-    clErr = clReleaseCommandQueue(queue);		// release command queue
-    clErr = clReleaseContext(context);			// release context
-    
-	
+	phaseStart = wallClockMs();
+	cout << flush;
+	int status = EXIT_SUCCESS;			// a failed write of the results fails the run, once everything is released
+	HostEngine outputEngine;
+	hostEngineCreate(&outputEngine, options.hostThreads, SIMD_AVX512);
+	if (options.outputMode == OUTPUT_BINARY)
+	{
+		const char *path = options.outputFile != NULL ? options.outputFile : "results.bin";
+		bool written = options.outputMapping != NULL ? unmapFile(&outputMapping) :
+					   writeBinary(&outputEngine, vectorB, numberOfElements, path);
+		if (written) cout << endl << "Result:  " << numberOfElements << " ints written to " << path << endl;
+		else status = EXIT_FAILURE;
+	}
+	else
+	{
+		FILE *resultFile = stdout;
+		if (options.outputFile != NULL && (resultFile = fopen(options.outputFile, "w")) == NULL)
+			{ cout << "Couldn't open " << options.outputFile << " for the results. Using the standard output." << endl; resultFile = stdout;}
+		if (options.outputMode == OUTPUT_TEXT)
+		{
+			if (resultFile == stdout) fprintf(resultFile, "\nResult:  ");
+			if (!writeText(&outputEngine, vectorB, numberOfElements, resultFile))
+				{ cout << "Couldn't write the results." << endl; status = EXIT_FAILURE;}
+		}
+		else writeSummary(&outputEngine, vectorB, numberOfElements, options.summaryEdge, resultFile);
+		if (resultFile != stdout) fclose(resultFile);
+		else fflush(stdout);
+	}
+	hostEngineRelease(&outputEngine);
+	profilerAddPhase(&profiler, "result output", wallClockMs() - phaseStart);
+
+	// profiling report (the events are released with the profiler)
+	FILE *profileFile = stdout;
+	if (options.profileOut != NULL && (profileFile = fopen(options.profileOut, "w")) == NULL)
+		{ cout << "Couldn't open " << options.profileOut << " for the profiling report. Using the standard output." << endl; profileFile = stdout;}
+	profilerReport(&profiler, options.profileFormat, profileFile);
+	if (profileFile != stdout) fclose(profileFile);
+	profilerRelease(&profiler);
 
+	if (options.inputMapping != NULL) unmapFile(&inputMapping);
+	else freeHostBuffer(vectorA);
+	if (options.outputMapping == NULL) freeHostBuffer(vectorB);
 
-	return 0;
+	return status;
 }
\ No newline at end of file
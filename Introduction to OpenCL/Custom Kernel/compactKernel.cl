@@ -0,0 +1,118 @@
+/**
+	Compact engine (see 1-openClCompact.h): the zeroValues transform (values[i] + operand) followed by a filter that
+	keeps the results within [low, high], written densely to the output. Each work-group takes a block of
+	blockElements elements, one chunk of work-group size at a time:
+
+	- the work-items of a chunk vote in a ballot, one bit each in __local words, and the rank of a kept element is
+	  the count of bits before its own (popcount), so the kept elements stay in order within a block.
+	- the kept elements of the block are staged in __local memory, then written out in one coalesced run.
+
+	The runs of the blocks are placed either by one global atomic per block on the output counter (compactFilter,
+	one pass, the blocks in any order), or by the exclusive scan of the counts of every block (compactCount, the scan
+	engine, then compactScatter, the blocks in order: the compaction is stable).
+*/
+
+#define COMPACT_KEEP(v, low, high)	((v) >= (low) && (v) <= (high))
+
+/**
+	Ballot of the work-group: bit lid % 32 of ballot[lid / 32] is set when the work-item keeps its element.
+	@return		rank		kept elements of the work-items before this one (total gets those of the whole work-group)
+*/
+int compactBallot(__local uint* ballot, int keep, int* total)
+{
+	int lid = get_local_id(0);
+	int words = (get_local_size(0) + 31) >> 5;
+	int w, rank, sum = 0;
+
+	if (lid < words) ballot[lid] = 0;
+	barrier(CLK_LOCAL_MEM_FENCE);
+	if (keep) atomic_or(&ballot[lid >> 5], 1u << (lid & 31));
+	barrier(CLK_LOCAL_MEM_FENCE);
+	rank = popcount(ballot[lid >> 5] & ((1u << (lid & 31)) - 1));
+	for( w = 0; w < words; w++)
+	{
+		if (w == lid >> 5) rank += sum;
+		sum += popcount(ballot[w]);
+	}
+	*total = sum;
+	// every work-item has read the words before the next ballot clears them
+	barrier(CLK_LOCAL_MEM_FENCE);
+	return rank;
+}
+
+/**
+	Transforms the block of this work-group, and stages its kept elements in order (staged holds blockElements ints).
+	@return		count		elements staged
+*/
+int compactStage(__global const int* values, int n, int operand, int low, int high, int blockElements,
+				 __local uint* ballot, __local int* staged)
+{
+	size_t begin = (size_t) get_group_id(0) * blockElements;
+	size_t end = min(begin + blockElements, (size_t) n);
+	size_t chunk, i;
+	int count = 0, total, rank, keep, v;
+
+	for( chunk = begin; chunk < end; chunk += get_local_size(0))
+	{
+		i = chunk + get_local_id(0);
+		v = i < end ? values[i] + operand : 0;
+		keep = i < end && COMPACT_KEEP(v, low, high);
+		rank = compactBallot(ballot, keep, &total);
+		if (keep) staged[count + rank] = v;
+		count += total;
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	return count;
+}
+
+/**
+	One pass: each block reserves the room of its kept elements with one atomic_add on counter (zeroed before).
+*/
+__kernel void compactFilter(__global const int* values, int n, int operand, int low, int high, int blockElements,
+							__global int* output, __global int* counter, __local uint* ballot, __local int* staged)
+{
+	__local int base;
+	int lid = get_local_id(0);
+	int count = compactStage(values, n, operand, low, high, blockElements, ballot, staged);
+	int i;
+
+	if (lid == 0) base = count > 0 ? atomic_add(counter, count) : 0;
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for( i = lid; i < count; i += get_local_size(0)) output[base + i] = staged[i];
+}
+
+// elements each block keeps, scanned afterwards into the first output position of each block
+__kernel void compactCount(__global const int* values, int n, int operand, int low, int high, int blockElements,
+						   __global int* counts, __local uint* ballot)
+{
+	size_t begin = (size_t) get_group_id(0) * blockElements;
+	size_t end = min(begin + blockElements, (size_t) n);
+	size_t chunk, i;
+	int count = 0, total, keep, v;
+
+	for( chunk = begin; chunk < end; chunk += get_local_size(0))
+	{
+		i = chunk + get_local_id(0);
+		v = i < end ? values[i] + operand : 0;
+		keep = i < end && COMPACT_KEEP(v, low, high);
+		compactBallot(ballot, keep, &total);
+		count += total;
+	}
+	if (get_local_id(0) == 0) counts[get_group_id(0)] = count;
+}
+
+/**
+	Stable pass: each block writes its kept elements from offsets[block], and the last block writes the count.
+*/
+__kernel void compactScatter(__global const int* values, int n, int operand, int low, int high, int blockElements,
+							 __global const int* offsets, __global int* output, __global int* counter,
+							 __local uint* ballot, __local int* staged)
+{
+	int lid = get_local_id(0);
+	int count = compactStage(values, n, operand, low, high, blockElements, ballot, staged);
+	int base = offsets[get_group_id(0)];
+	int i;
+
+	if (lid == 0 && get_group_id(0) == get_num_groups(0) - 1) *counter = base + count;
+	for( i = lid; i < count; i += get_local_size(0)) output[base + i] = staged[i];
+}
@@ -0,0 +1,122 @@
+/**
+	GEMM engine (see 1-openClGemm.h): C = alpha * A * B + beta * C, with A (M x K), B (K x N) and C (M x N) dense and
+	row-major, in float (gemmNaiveFloat, gemmTiledFloat) and, on devices with cl_khr_fp64, in double (gemmNaiveDouble,
+	gemmTiledDouble). C isn't read when beta is 0.
+
+	- gemmNaive: one work-item per element of C (dimension 0 along the columns), reading A and B from global memory.
+	- gemmTiled: each work-item computes a GEMM_BLOCK x GEMM_BLOCK block of C in private registers, and a work-group
+	  of (lx, ly) work-items a tile of (ly * GEMM_BLOCK) x (lx * GEMM_BLOCK) elements. The tiles of A and B are staged
+	  tileK columns (rows of B) at a time in __local memory, loaded with vload4 when the tile lies inside the
+	  matrices (A transposed, so the GEMM_BLOCK rows of a work-item are consecutive). The work-group size and tileK
+	  are given by the host, from the __local memory and the work-group limits of the device.
+*/
+
+#define GEMM_BLOCK	4		// rows and columns of C per work-item in gemmTiled (the width of the vector types)
+
+#define GEMM_KERNELS(T, T4, NAME)															\
+__kernel void gemmNaive##NAME(int M, int N, int K, T alpha, __global const T* A,			\
+							  __global const T* B, T beta, __global T* C)					\
+{																							\
+	int col = get_global_id(0);																\
+	int row = get_global_id(1);																\
+	T sum = 0;																				\
+	int k;																					\
+	if (row >= M || col >= N) return;														\
+	for( k = 0; k < K; k++) sum += A[(size_t) row * K + k] * B[(size_t) k * N + col];		\
+	C[(size_t) row * N + col] = alpha * sum + (beta != 0 ? beta * C[(size_t) row * N + col] : 0);	\
+}																							\
+																							\
+__kernel void gemmTiled##NAME(int M, int N, int K, T alpha, __global const T* A,			\
+							  __global const T* B, T beta, __global T* C, int tileK,		\
+							  __local T* tileA, __local T* tileB)							\
+{																							\
+	int tx = get_local_id(0), ty = get_local_id(1);											\
+	int lx = get_local_size(0), items = lx * get_local_size(1);								\
+	int lid = ty * lx + tx;																	\
+	int tileM = get_local_size(1) * GEMM_BLOCK, tileN = lx * GEMM_BLOCK;					\
+	int row0 = get_group_id(1) * tileM, col0 = get_group_id(0) * tileN;						\
+	bool inside = row0 + tileM <= M && col0 + tileN <= N;									\
+	T4 acc[GEMM_BLOCK];																		\
+	T out[GEMM_BLOCK];																		\
+	int i, j, k, k0, r, c;																	\
+																							\
+	for( i = 0; i < GEMM_BLOCK; i++) acc[i] = (T4) 0;										\
+	for( k0 = 0; k0 < K; k0 += tileK)														\
+	{																						\
+		if (inside && k0 + tileK <= K)														\
+		{																					\
+			/* whole tiles: 4 consecutive elements per load */								\
+			for( i = lid; i < tileM * tileK / 4; i += items)								\
+			{																				\
+				r = i / (tileK / 4);														\
+				k = (i % (tileK / 4)) * 4;													\
+				T4 a = vload4(0, A + (size_t) (row0 + r) * K + k0 + k);						\
+				tileA[k * tileM + r] = a.x;													\
+				tileA[(k + 1) * tileM + r] = a.y;											\
+				tileA[(k + 2) * tileM + r] = a.z;											\
+				tileA[(k + 3) * tileM + r] = a.w;											\
+			}																				\
+			for( i = lid; i < tileK * tileN / 4; i += items)								\
+			{																				\
+				k = i / (tileN / 4);														\
+				c = (i % (tileN / 4)) * 4;													\
+				vstore4(vload4(0, B + (size_t) (k0 + k) * N + col0 + c), 0, tileB + k * tileN + c);	\
+			}																				\
+		}																					\
+		else																				\
+		{																					\
+			/* edge tiles: one element per load, zeros outside the matrices */				\
+			for( i = lid; i < tileM * tileK; i += items)									\
+			{																				\
+				r = i / tileK;																\
+				k = i % tileK;																\
+				tileA[k * tileM + r] = row0 + r < M && k0 + k < K ? A[(size_t) (row0 + r) * K + k0 + k] : 0;	\
+			}																				\
+			for( i = lid; i < tileK * tileN; i += items)									\
+			{																				\
+				k = i / tileN;																\
+				c = i % tileN;																\
+				tileB[i] = k0 + k < K && col0 + c < N ? B[(size_t) (k0 + k) * N + col0 + c] : 0;	\
+			}																				\
+		}																					\
+		barrier(CLK_LOCAL_MEM_FENCE);														\
+																							\
+		for( k = 0; k < tileK; k++)															\
+		{																					\
+			T4 a = vload4(0, tileA + k * tileM + ty * GEMM_BLOCK);							\
+			T4 b = vload4(0, tileB + k * tileN + tx * GEMM_BLOCK);							\
+			acc[0] += a.x * b;																\
+			acc[1] += a.y * b;																\
+			acc[2] += a.z * b;																\
+			acc[3] += a.w * b;																\
+		}																					\
+		barrier(CLK_LOCAL_MEM_FENCE);														\
+	}																						\
+																							\
+	for( i = 0; i < GEMM_BLOCK; i++)														\
+	{																						\
+		r = row0 + ty * GEMM_BLOCK + i;														\
+		c = col0 + tx * GEMM_BLOCK;															\
+		if (r >= M) break;																	\
+		if (inside)																			\
+		{																					\
+			T4 value = alpha * acc[i];														\
+			if (beta != 0) value += beta * vload4(0, C + (size_t) r * N + c);				\
+			vstore4(value, 0, C + (size_t) r * N + c);										\
+		}																					\
+		else																				\
+		{																					\
+			vstore4(acc[i], 0, out);														\
+			for( j = 0; j < GEMM_BLOCK && c + j < N; j++)									\
+				C[(size_t) r * N + c + j] = alpha * out[j] +								\
+											(beta != 0 ? beta * C[(size_t) r * N + c + j] : 0);	\
+		}																					\
+	}																						\
+}
+
+GEMM_KERNELS(float, float4, Float)
+
+#ifdef cl_khr_fp64
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+GEMM_KERNELS(double, double4, Double)
+#endif
@@ -0,0 +1,70 @@
+/**
+	Histogram engine (see 1-openClHistogram.h): count of the int values of an array in bins of equal width over
+	[low, low + span). Values out of the range aren't counted.
+
+	- histogramLocal: each work-group counts its share of the array in __local memory, with one copy of the bins
+	  (a replica) per wavefront, so that the atomics of different wavefronts never collide. The replicas of a bin
+	  are next to each other (counts[bin * replicas + replica]), in different banks. At the end the replicas are
+	  added up into the partial histogram of the work-group (partials[group * bins + bin]).
+	- histogramMerge: one work-item per bin adds up the partial histograms of every work-group.
+	- histogramGlobal: the fallback when the bins don't fit the __local memory, atomics straight on the histogram
+	  in global memory (cleared by the host).
+*/
+
+// bin of a value, or -1 if it is out of the range
+int histogramBin(int value, long low, long span, int bins)
+{
+	long offset = (long) value - low;
+	if (offset < 0 || offset >= span) return -1;
+	return (int) (offset * bins / span);
+}
+
+__kernel void histogramLocal(__global const int* values, int n, long low, long span, int bins, int replicas,
+							 int wavefront, __global uint* partials, __local uint* counts)
+{
+	uint lid = get_local_id(0);
+	uint replica = (lid / wavefront) % replicas;
+	size_t i;
+	int b, r;
+
+	for( i = lid; i < (size_t) bins * replicas; i += get_local_size(0)) counts[i] = 0;
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	for( i = get_global_id(0); i < (size_t) n; i += get_global_size(0))
+	{
+		b = histogramBin(values[i], low, span, bins);
+		if (b >= 0) atomic_inc(&counts[b * replicas + replica]);
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	for( b = lid; b < bins; b += get_local_size(0))
+	{
+		uint sum = 0;
+		for( r = 0; r < replicas; r++) sum += counts[b * replicas + r];
+		partials[(size_t) get_group_id(0) * bins + b] = sum;
+	}
+}
+
+// histogram[bin] = sum of the partial histograms of every work-group (coalesced: neighbours read neighbour bins)
+__kernel void histogramMerge(__global const uint* partials, int groups, int bins, __global uint* histogram)
+{
+	size_t b;
+	int g;
+	for( b = get_global_id(0); b < (size_t) bins; b += get_global_size(0))
+	{
+		uint sum = 0;
+		for( g = 0; g < groups; g++) sum += partials[(size_t) g * bins + b];
+		histogram[b] = sum;
+	}
+}
+
+__kernel void histogramGlobal(__global const int* values, int n, long low, long span, int bins,
+							  __global uint* histogram)
+{
+	size_t i;
+	for( i = get_global_id(0); i < (size_t) n; i += get_global_size(0))
+	{
+		int b = histogramBin(values[i], low, span, bins);
+		if (b >= 0) atomic_inc(&histogram[b]);
+	}
+}
@@ -0,0 +1,159 @@
+/**
+	Radix sort engine (see 1-openClRadixSort.h): LSD radix sort of 32-bit keys, RADIX_BITS bits per pass, with an
+	optional 32-bit payload moved along with each key. The keys are sorted as uints: int and float keys are first
+	encoded so that their order is the order of the uints (radixEncodeKeys), and decoded at the end.
+
+	Every pass splits the array in blocks (one work-group each) and runs:
+	- radixHistogram: the count of each digit in each block, stored digit-major (histograms[digit * blocks + block]),
+	  so that an exclusive scan of the whole array gives the first output position of each digit of each block.
+	- the exclusive scan of the histograms (scanKernel.cl).
+	- radixScatter: each block moves its keys to their positions, one chunk of work-group size at a time. The chunk
+	  is first sorted by digit in __local memory (one stable split per bit), so that the keys of the same digit are
+	  written to consecutive addresses. Chunks are done in order, and the splits are stable, so the sort is stable.
+*/
+
+#define RADIX_BITS		4
+#define RADIX_BUCKETS	(1 << RADIX_BITS)
+#define RADIX_MASK		(RADIX_BUCKETS - 1)
+
+#define RADIX_KEY_UINT	0
+#define RADIX_KEY_INT	1
+#define RADIX_KEY_FLOAT	2
+
+/**
+	Turns int or float keys into uints with the same order (the sign bit is flipped; negative floats have every
+	bit flipped, as their magnitude grows the other way).
+*/
+__kernel void radixEncodeKeys(__global uint* keys, int n, int keyType)
+{
+	size_t i;
+	for( i = get_global_id(0); i < (size_t) n; i += get_global_size(0))
+	{
+		uint x = keys[i];
+		if (keyType == RADIX_KEY_INT) keys[i] = x ^ 0x80000000u;
+		else if (keyType == RADIX_KEY_FLOAT) keys[i] = (x & 0x80000000u) ? ~x : x ^ 0x80000000u;
+	}
+}
+
+// inverse of radixEncodeKeys
+__kernel void radixDecodeKeys(__global uint* keys, int n, int keyType)
+{
+	size_t i;
+	for( i = get_global_id(0); i < (size_t) n; i += get_global_size(0))
+	{
+		uint x = keys[i];
+		if (keyType == RADIX_KEY_INT) keys[i] = x ^ 0x80000000u;
+		else if (keyType == RADIX_KEY_FLOAT) keys[i] = (x & 0x80000000u) ? x ^ 0x80000000u : ~x;
+	}
+}
+
+/**
+	Count of each digit (bits shift to shift + RADIX_BITS - 1) in the block of this work-group. Each work-item counts
+	in private memory first, so the __local atomics are only RADIX_BUCKETS per work-item.
+*/
+__kernel void radixHistogram(__global const uint* keys, int n, int shift, int blockElements,
+							 __global uint* histograms, __local uint* counts)
+{
+	uint lid = get_local_id(0);
+	size_t begin = (size_t) get_group_id(0) * blockElements;
+	size_t end = min(begin + blockElements, (size_t) n);
+	uint own[RADIX_BUCKETS];
+	size_t i;
+	uint d;
+
+	for( d = 0; d < RADIX_BUCKETS; d++) own[d] = 0;
+	for( i = begin + lid; i < end; i += get_local_size(0)) own[(keys[i] >> shift) & RADIX_MASK]++;
+	for( d = lid; d < RADIX_BUCKETS; d += get_local_size(0)) counts[d] = 0;
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for( d = 0; d < RADIX_BUCKETS; d++) if (own[d] != 0) atomic_add(&counts[d], own[d]);
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for( d = lid; d < RADIX_BUCKETS; d += get_local_size(0))
+		histograms[d * get_num_groups(0) + get_group_id(0)] = counts[d];
+}
+
+/**
+	Exclusive scan of one uint per work-item, through flags (one uint per work-item).
+	@return		prefix		sum of the values of the work-items before this one
+*/
+uint radixLocalScan(__local uint* flags, uint value, uint* total)
+{
+	uint lid = get_local_id(0);
+	uint size = get_local_size(0);
+	uint offset, t;
+	flags[lid] = value;
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for( offset = 1; offset < size; offset <<= 1)
+	{
+		t = lid >= offset ? flags[lid - offset] : 0;
+		barrier(CLK_LOCAL_MEM_FENCE);
+		flags[lid] += t;
+		barrier(CLK_LOCAL_MEM_FENCE);
+	}
+	t = flags[lid];
+	*total = flags[size - 1];
+	barrier(CLK_LOCAL_MEM_FENCE);
+	return t - value;
+}
+
+/**
+	Moves the keys (and values, unless valuesIn is NULL) of the block of this work-group to their sorted positions
+	for one digit. offsets is the exclusive scan of the histograms of radixHistogram. localKeys, localValues and
+	flags hold one uint per work-item.
+*/
+__kernel void radixScatter(__global const uint* keysIn, __global const uint* valuesIn, __global uint* keysOut,
+						   __global uint* valuesOut, int n, int shift, int blockElements, __global const uint* offsets,
+						   __local uint* localKeys, __local uint* localValues, __local uint* flags)
+{
+	__local uint running[RADIX_BUCKETS];		// next output position of each digit
+	__local uint chunkStart[RADIX_BUCKETS];		// first position of each digit in the sorted chunk
+	__local uint chunkCount[RADIX_BUCKETS];		// keys of each digit in the chunk
+	uint lid = get_local_id(0);
+	uint size = get_local_size(0);
+	size_t begin = (size_t) get_group_id(0) * blockElements;
+	size_t end = min(begin + blockElements, (size_t) n);
+	size_t chunk;
+	uint d;
+
+	for( d = lid; d < RADIX_BUCKETS; d += size) running[d] = offsets[d * get_num_groups(0) + get_group_id(0)];
+	for( chunk = begin; chunk < end; chunk += size)
+	{
+		uint valid = (uint) min((size_t) size, end - chunk);
+		// past the end, keys of the last digit: the splits keep them after the real ones, at the end of the chunk
+		uint key = lid < valid ? keysIn[chunk + lid] : 0xffffffffu;
+		uint value = lid < valid && valuesIn != 0 ? valuesIn[chunk + lid] : 0;
+		uint bit, digit, position, falses;
+		for( d = lid; d < RADIX_BUCKETS; d += size) chunkCount[d] = 0;
+
+		// stable sort of the chunk by digit, one bit at a time: the keys with the bit clear go first
+		for( bit = 0; bit < RADIX_BITS; bit++)
+		{
+			uint set = (key >> (shift + bit)) & 1;
+			uint before = radixLocalScan(flags, 1 - set, &falses);
+			position = set ? falses + lid - before : before;
+			localKeys[position] = key;
+			localValues[position] = value;
+			barrier(CLK_LOCAL_MEM_FENCE);
+			key = localKeys[lid];
+			value = localValues[lid];
+			barrier(CLK_LOCAL_MEM_FENCE);
+		}
+
+		// where each digit starts in the chunk, and how many real keys it has
+		digit = (key >> shift) & RADIX_MASK;
+		localKeys[lid] = key;
+		barrier(CLK_LOCAL_MEM_FENCE);
+		if (lid == 0 || digit != ((localKeys[lid - 1] >> shift) & RADIX_MASK)) chunkStart[digit] = lid;
+		if (lid < valid) atomic_inc(&chunkCount[digit]);
+		barrier(CLK_LOCAL_MEM_FENCE);
+
+		if (lid < valid)
+		{
+			uint destination = running[digit] + lid - chunkStart[digit];
+			keysOut[destination] = key;
+			if (valuesIn != 0) valuesOut[destination] = value;
+		}
+		barrier(CLK_LOCAL_MEM_FENCE);
+		for( d = lid; d < RADIX_BUCKETS; d += size) running[d] += chunkCount[d];
+		barrier(CLK_LOCAL_MEM_FENCE);
+	}
+}
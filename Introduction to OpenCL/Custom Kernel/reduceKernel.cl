@@ -0,0 +1,191 @@
+/**
+	Reduction engine (see 1-openClReduction.h). Every kernel reduces its input in two levels: each work-item
+	accumulates a grid-stride slice of the input in private memory, then the work-group combines its work-items,
+	with the sub-group reductions of cl_khr_subgroups when the device has them, or with a tree in __local memory
+	otherwise (the work-group size must then be a power of two). Work-group g writes its result to partials[g], and
+	a second launch with one work-group reduces the partials. int min and max combine the work-groups with a 32-bit
+	atomic instead, in a single pass.
+
+	int sums are accumulated in long, so that the sum of a large array doesn't overflow.
+*/
+
+#if defined(cl_khr_subgroups)
+#pragma OPENCL EXTENSION cl_khr_subgroups : enable
+#define REDUCE_SUBGROUPS
+#elif defined(__opencl_c_subgroups)
+#define REDUCE_SUBGROUPS
+#endif
+
+#define REDUCE_ADD(a, b)	((a) + (b))
+#define REDUCE_MIN(a, b)	((b) < (a) ? (b) : (a))
+#define REDUCE_MAX(a, b)	((b) > (a) ? (b) : (a))
+
+// b (at index ib) beats a (at index ia) for argmax: bigger, or as big at a smaller index
+#define ARGMAX_BETTER(a, ia, b, ib)		((b) > (a) || ((b) == (a) && (ib) < (ia)))
+
+/**
+	Work-group level of the reductions: combines the acc (or best and bestIndex) of every work-item, and leaves the
+	result in the work-item that REDUCE_LEADER selects. With sub-groups, each sub-group reduces its work-items in
+	registers, and the first sub-group reduces the results of the others through __local memory.
+*/
+#ifdef REDUCE_SUBGROUPS
+
+#define REDUCE_LEADER	(get_sub_group_id() == 0 && get_sub_group_local_id() == 0)
+
+#define REDUCE_GROUP(acc, scratch, IDENTITY, OP, SUBGROUP_OP)								\
+{																							\
+	uint k;																					\
+	acc = SUBGROUP_OP(acc);																	\
+	if (get_sub_group_local_id() == 0) scratch[get_sub_group_id()] = acc;					\
+	barrier(CLK_LOCAL_MEM_FENCE);															\
+	if (get_sub_group_id() == 0)															\
+	{																						\
+		acc = IDENTITY;																		\
+		for( k = get_sub_group_local_id(); k < get_num_sub_groups(); k += get_sub_group_size())	\
+			acc = OP(acc, scratch[k]);														\
+		acc = SUBGROUP_OP(acc);																\
+	}																						\
+}
+
+// the largest value of the sub-group, at the smallest index holding it
+#define SUBGROUP_ARGMAX(T, best, bestIndex)													\
+{																							\
+	T top = sub_group_reduce_max(best);														\
+	bestIndex = sub_group_reduce_min(best == top ? bestIndex : INT_MAX);					\
+	best = top;																				\
+}
+
+#define REDUCE_ARGMAX_GROUP(T, best, bestIndex, scratch, scratchIndices, LOWEST)			\
+{																							\
+	uint k;																					\
+	SUBGROUP_ARGMAX(T, best, bestIndex)														\
+	if (get_sub_group_local_id() == 0)														\
+	{																						\
+		scratch[get_sub_group_id()] = best;													\
+		scratchIndices[get_sub_group_id()] = bestIndex;										\
+	}																						\
+	barrier(CLK_LOCAL_MEM_FENCE);															\
+	if (get_sub_group_id() == 0)															\
+	{																						\
+		best = LOWEST;																		\
+		bestIndex = INT_MAX;																\
+		for( k = get_sub_group_local_id(); k < get_num_sub_groups(); k += get_sub_group_size())	\
+			if (ARGMAX_BETTER(best, bestIndex, scratch[k], scratchIndices[k]))				\
+			{																				\
+				best = scratch[k];															\
+				bestIndex = scratchIndices[k];												\
+			}																				\
+		SUBGROUP_ARGMAX(T, best, bestIndex)													\
+	}																						\
+}
+
+#else
+
+#define REDUCE_LEADER	(get_local_id(0) == 0)
+
+#define REDUCE_GROUP(acc, scratch, IDENTITY, OP, SUBGROUP_OP)								\
+{																							\
+	uint lid = get_local_id(0);																\
+	uint s;																					\
+	scratch[lid] = acc;																		\
+	barrier(CLK_LOCAL_MEM_FENCE);															\
+	for( s = get_local_size(0) / 2; s > 0; s >>= 1)											\
+	{																						\
+		if (lid < s) scratch[lid] = OP(scratch[lid], scratch[lid + s]);						\
+		barrier(CLK_LOCAL_MEM_FENCE);														\
+	}																						\
+	acc = scratch[0];																		\
+}
+
+#define REDUCE_ARGMAX_GROUP(T, best, bestIndex, scratch, scratchIndices, LOWEST)			\
+{																							\
+	uint lid = get_local_id(0);																\
+	uint s;																					\
+	scratch[lid] = best;																	\
+	scratchIndices[lid] = bestIndex;														\
+	barrier(CLK_LOCAL_MEM_FENCE);															\
+	for( s = get_local_size(0) / 2; s > 0; s >>= 1)											\
+	{																						\
+		if (lid < s && ARGMAX_BETTER(scratch[lid], scratchIndices[lid], scratch[lid + s], scratchIndices[lid + s]))	\
+		{																					\
+			scratch[lid] = scratch[lid + s];												\
+			scratchIndices[lid] = scratchIndices[lid + s];									\
+		}																					\
+		barrier(CLK_LOCAL_MEM_FENCE);														\
+	}																						\
+	best = scratch[0];																		\
+	bestIndex = scratchIndices[0];															\
+}
+
+#endif
+
+/**
+	Reduction of n values of type T, accumulated in type A (reduceSumInt, reduceSumLong, reduceSumFloat,
+	reduceMinFloat and reduceMaxFloat). scratch holds one A per work-item.
+*/
+#define REDUCE_KERNEL(NAME, T, A, IDENTITY, OP, SUBGROUP_OP)								\
+__kernel void NAME(__global const T* values, int n, __global A* partials, __local A* scratch)	\
+{																							\
+	A acc = IDENTITY;																		\
+	size_t i;																				\
+	for( i = get_global_id(0); i < (size_t) n; i += get_global_size(0))						\
+		acc = OP(acc, (A) values[i]);														\
+	REDUCE_GROUP(acc, scratch, IDENTITY, OP, SUBGROUP_OP)									\
+	if (REDUCE_LEADER) partials[get_group_id(0)] = acc;										\
+}
+
+REDUCE_KERNEL(reduceSumInt, int, long, 0, REDUCE_ADD, sub_group_reduce_add)
+REDUCE_KERNEL(reduceSumLong, long, long, 0, REDUCE_ADD, sub_group_reduce_add)
+REDUCE_KERNEL(reduceSumFloat, float, float, 0.0f, REDUCE_ADD, sub_group_reduce_add)
+REDUCE_KERNEL(reduceMinFloat, float, float, INFINITY, REDUCE_MIN, sub_group_reduce_min)
+REDUCE_KERNEL(reduceMaxFloat, float, float, -INFINITY, REDUCE_MAX, sub_group_reduce_max)
+
+/**
+	Single pass reduction of n ints (reduceMinInt and reduceMaxInt): every work-group combines its result into
+	*result with an atomic, so *result must hold the identity of the operation before the launch.
+*/
+#define REDUCE_ATOMIC_KERNEL(NAME, IDENTITY, OP, SUBGROUP_OP, ATOMIC)						\
+__kernel void NAME(__global const int* values, int n, __global int* result, __local int* scratch)	\
+{																							\
+	int acc = IDENTITY;																		\
+	size_t i;																				\
+	for( i = get_global_id(0); i < (size_t) n; i += get_global_size(0))						\
+		acc = OP(acc, values[i]);															\
+	REDUCE_GROUP(acc, scratch, IDENTITY, OP, SUBGROUP_OP)									\
+	if (REDUCE_LEADER) ATOMIC(result, acc);													\
+}
+
+REDUCE_ATOMIC_KERNEL(reduceMinInt, INT_MAX, REDUCE_MIN, sub_group_reduce_min, atomic_min)
+REDUCE_ATOMIC_KERNEL(reduceMaxInt, INT_MIN, REDUCE_MAX, sub_group_reduce_max, atomic_max)
+
+/**
+	Argmax of n values (reduceArgMaxInt and reduceArgMaxFloat): the largest value, and the smallest index holding
+	it. The first pass gets NULL indices (the index of values[i] is i), the second pass the indices of the partials.
+	scratch and scratchIndices hold one element per work-item.
+*/
+#define REDUCE_ARGMAX_KERNEL(NAME, T, LOWEST)												\
+__kernel void NAME(__global const T* values, __global const int* indices, int n, __global T* partials,	\
+				   __global int* partialIndices, __local T* scratch, __local int* scratchIndices)	\
+{																							\
+	T best = LOWEST;																		\
+	int bestIndex = INT_MAX;																\
+	size_t i;																				\
+	for( i = get_global_id(0); i < (size_t) n; i += get_global_size(0))						\
+	{																						\
+		int index = indices != 0 ? indices[i] : (int) i;									\
+		if (ARGMAX_BETTER(best, bestIndex, values[i], index))								\
+		{																					\
+			best = values[i];																\
+			bestIndex = index;																\
+		}																					\
+	}																						\
+	REDUCE_ARGMAX_GROUP(T, best, bestIndex, scratch, scratchIndices, LOWEST)				\
+	if (REDUCE_LEADER)																		\
+	{																						\
+		partials[get_group_id(0)] = best;													\
+		partialIndices[get_group_id(0)] = bestIndex;										\
+	}																						\
+}
+
+REDUCE_ARGMAX_KERNEL(reduceArgMaxInt, int, INT_MIN)
+REDUCE_ARGMAX_KERNEL(reduceArgMaxFloat, float, -INFINITY)
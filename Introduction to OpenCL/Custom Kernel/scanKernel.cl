@@ -0,0 +1,178 @@
+/**
+	Scan engine (see 1-openClScan.h): exclusive and inclusive prefix sums of ints. Each work-group scans a tile of
+	twice its size in __local memory with the work-efficient Blelloch algorithm (an up-sweep building partial sums in
+	a tree, then a down-sweep pushing the prefixes back down). The tiles are combined in one of two ways:
+
+	- multi-level: scanTiles writes the total of every tile, the totals are scanned the same way (recursively, until
+	  they fit one tile), and scanAddOffsets adds the scanned total of the previous tiles to each tile. It needs no
+	  cooperation between work-groups, so it runs on every device.
+	- decoupled lookback (scanDecoupled, single pass): every work-group takes the next tile from a ticket counter,
+	  publishes the total of its tile, then looks back at the tiles before it until it finds one with a published
+	  inclusive prefix. It waits on work-groups that started before it, so it needs them to make progress, and 64-bit
+	  atomics to publish a status flag and a value in one word.
+
+	Indexing in __local memory skips one slot every SCAN_BANKS elements (SCAN_PAD), so that the strided accesses of
+	the tree don't pile up on the same memory bank.
+*/
+
+#define SCAN_LOG_BANKS	5
+#define SCAN_BANKS		(1 << SCAN_LOG_BANKS)
+#define SCAN_PAD(i)		((i) >> SCAN_LOG_BANKS)
+
+/**
+	Exclusive scan, in place, of the 2 * get_local_size(0) ints of temp (laid out with SCAN_PAD). The work-group
+	size must be a power of two.
+	@return		total		sum of the whole tile (in every work-item)
+*/
+int scanTileLocal(__local int* temp)
+{
+	uint lid = get_local_id(0);
+	uint tile = 2 * get_local_size(0);
+	uint offset = 1;
+	uint d, ai, bi;
+	int t, total;
+
+	// up-sweep: partial sums of growing subtrees
+	for( d = tile >> 1; d > 0; d >>= 1)
+	{
+		barrier(CLK_LOCAL_MEM_FENCE);
+		if (lid < d)
+		{
+			ai = offset * (2 * lid + 1) - 1;
+			bi = offset * (2 * lid + 2) - 1;
+			temp[bi + SCAN_PAD(bi)] += temp[ai + SCAN_PAD(ai)];
+		}
+		offset <<= 1;
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	total = temp[tile - 1 + SCAN_PAD(tile - 1)];
+	barrier(CLK_LOCAL_MEM_FENCE);
+	if (lid == 0) temp[tile - 1 + SCAN_PAD(tile - 1)] = 0;
+
+	// down-sweep: each node passes its prefix to its left child, and prefix + left sum to its right child
+	for( d = 1; d < tile; d <<= 1)
+	{
+		offset >>= 1;
+		barrier(CLK_LOCAL_MEM_FENCE);
+		if (lid < d)
+		{
+			ai = offset * (2 * lid + 1) - 1;
+			bi = offset * (2 * lid + 2) - 1;
+			ai += SCAN_PAD(ai);
+			bi += SCAN_PAD(bi);
+			t = temp[ai];
+			temp[ai] = temp[bi];
+			temp[bi] += t;
+		}
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	return total;
+}
+
+/**
+	Scans the tile of this work-group (2 * local size elements of input, from tile * 2 * local size) into output,
+	with prefix added to every element. Elements past n are taken as 0, and not written.
+	@return		total		sum of the tile
+*/
+int scanTile(__global const int* input, __global int* output, int n, int inclusive, uint tile, int prefix,
+			 __local int* temp)
+{
+	uint lid = get_local_id(0);
+	uint size = get_local_size(0);
+	size_t base = (size_t) tile * 2 * size;
+	uint ai = lid, bi = lid + size;
+	int a = base + ai < (size_t) n ? input[base + ai] : 0;
+	int b = base + bi < (size_t) n ? input[base + bi] : 0;
+	int total;
+	temp[ai + SCAN_PAD(ai)] = a;
+	temp[bi + SCAN_PAD(bi)] = b;
+	total = scanTileLocal(temp);
+	if (base + ai < (size_t) n) output[base + ai] = prefix + temp[ai + SCAN_PAD(ai)] + (inclusive ? a : 0);
+	if (base + bi < (size_t) n) output[base + bi] = prefix + temp[bi + SCAN_PAD(bi)] + (inclusive ? b : 0);
+	return total;
+}
+
+/**
+	First level of the multi-level scan: tile g is scanned on its own, and its total goes to tileSums[g] (tileSums
+	can be NULL when there is only one tile). input and output can be the same buffer.
+*/
+__kernel void scanTiles(__global const int* input, __global int* output, int n, int inclusive,
+						__global int* tileSums, __local int* temp)
+{
+	int total = scanTile(input, output, n, inclusive, get_group_id(0), 0, temp);
+	if (tileSums != 0 && get_local_id(0) == 0) tileSums[get_group_id(0)] = total;
+}
+
+/**
+	Last step of the multi-level scan: adds the exclusive scan of the tile totals to every element of each tile
+	(launched with the geometry of scanTiles).
+*/
+__kernel void scanAddOffsets(__global int* output, __global const int* tileOffsets, int n)
+{
+	size_t base = (size_t) get_group_id(0) * 2 * get_local_size(0);
+	size_t i;
+	int offset = tileOffsets[get_group_id(0)];
+	for( i = base + get_local_id(0); i < base + 2 * get_local_size(0) && i < (size_t) n; i += get_local_size(0))
+		output[i] += offset;
+}
+
+#ifdef cl_khr_int64_base_atomics
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+
+// status word of a tile: flag in the high 32 bits, value in the low 32 bits (0: nothing published yet)
+#define SCAN_AGGREGATE	1L		// value is the total of the tile alone
+#define SCAN_PREFIX		2L		// value is the inclusive prefix, up to the end of the tile
+#define SCAN_STATUS(flag, value)	(((flag) << 32) | (long) (uint) (value))
+
+/**
+	Single pass scan with decoupled lookback. status (one long per tile) and *ticket must be 0 before the launch.
+	Work-group tiles are handed out in launch order by the ticket, so a tile only ever waits on tiles whose
+	work-groups already run.
+*/
+__kernel void scanDecoupled(__global const int* input, __global int* output, int n, int inclusive,
+							__global volatile long* status, __global volatile int* ticket, __local int* temp)
+{
+	__local uint tile;
+	__local int prefix;
+	uint lid = get_local_id(0);
+	uint size = get_local_size(0);
+	uint ai = lid, bi = lid + size;
+	size_t base;
+	int a, b, total;
+
+	if (lid == 0) tile = atomic_inc(ticket);
+	barrier(CLK_LOCAL_MEM_FENCE);
+	base = (size_t) tile * 2 * size;
+	a = base + ai < (size_t) n ? input[base + ai] : 0;
+	b = base + bi < (size_t) n ? input[base + bi] : 0;
+	temp[ai + SCAN_PAD(ai)] = a;
+	temp[bi + SCAN_PAD(bi)] = b;
+	total = scanTileLocal(temp);
+
+	if (lid == 0)
+	{
+		int exclusive = 0;
+		if (tile == 0) atom_xchg(&status[0], SCAN_STATUS(SCAN_PREFIX, total));
+		else
+		{
+			long word;
+			uint j = tile - 1;
+			atom_xchg(&status[tile], SCAN_STATUS(SCAN_AGGREGATE, total));
+			for (;;)
+			{
+				word = atom_add(&status[j], 0L);			// atomic load
+				if ((word >> 32) == 0) continue;			// the tile before hasn't published yet
+				exclusive += (int) (uint) word;
+				if ((word >> 32) == SCAN_PREFIX) break;
+				j--;
+			}
+			atom_xchg(&status[tile], SCAN_STATUS(SCAN_PREFIX, exclusive + total));
+		}
+		prefix = exclusive;
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	if (base + ai < (size_t) n) output[base + ai] = prefix + temp[ai + SCAN_PAD(ai)] + (inclusive ? a : 0);
+	if (base + bi < (size_t) n) output[base + bi] = prefix + temp[bi + SCAN_PAD(bi)] + (inclusive ? b : 0);
+}
+
+#endif
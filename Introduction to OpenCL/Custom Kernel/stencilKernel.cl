@@ -0,0 +1,60 @@
+/**
+	Stencil engine (see 1-openClStencil.h): 2D convolution of a float grid (width x height, row-major) with a filter
+	of (2 * radiusY + 1) x (2 * radiusX + 1) coefficients, kept in __constant memory from filterOffset on. The grid
+	is clamped at its edges. A separable filter is run as two passes, one with radiusY = 0 and one with radiusX = 0.
+
+	- stencilLocal: each work-group loads its tile of the grid and the halo around it (radiusX columns and radiusY
+	  rows on each side) into __local memory once, and every work-item then reads its neighbourhood from there.
+	- stencilImage: the grid is read through an image and a sampler clamping to the edge, so the texture cache holds
+	  the neighbourhoods and the hardware does the clamping. Only compiled for devices with images.
+*/
+
+__kernel void stencilLocal(__global const float* input, __global float* output, int width, int height,
+						   __constant float* filter, int filterOffset, int radiusX, int radiusY, __local float* tile)
+{
+	int lx = get_local_size(0), ly = get_local_size(1);
+	int tileWidth = lx + 2 * radiusX, tileHeight = ly + 2 * radiusY;
+	int x0 = get_group_id(0) * lx - radiusX, y0 = get_group_id(1) * ly - radiusY;
+	int x = get_global_id(0), y = get_global_id(1);
+	int i, dx, dy;
+
+	for( i = get_local_id(1) * lx + get_local_id(0); i < tileWidth * tileHeight; i += lx * ly)
+	{
+		int tx = clamp(x0 + i % tileWidth, 0, width - 1);
+		int ty = clamp(y0 + i / tileWidth, 0, height - 1);
+		tile[i] = input[(size_t) ty * width + tx];
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	if (x >= width || y >= height) return;
+
+	float sum = 0;
+	__constant float* coefficient = filter + filterOffset;
+	for( dy = 0; dy <= 2 * radiusY; dy++)
+	{
+		__local float* row = tile + (get_local_id(1) + dy) * tileWidth + get_local_id(0);
+		for( dx = 0; dx <= 2 * radiusX; dx++) sum += *coefficient++ * row[dx];
+	}
+	output[(size_t) y * width + x] = sum;
+}
+
+// the image kernel only exists on devices with images (CL_DEVICE_IMAGE_SUPPORT)
+#ifdef __IMAGE_SUPPORT__
+
+__constant sampler_t stencilSampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_EDGE | CLK_FILTER_NEAREST;
+
+__kernel void stencilImage(__read_only image2d_t input, __global float* output, int width, int height,
+						   __constant float* filter, int filterOffset, int radiusX, int radiusY)
+{
+	int x = get_global_id(0), y = get_global_id(1);
+	int dx, dy;
+	if (x >= width || y >= height) return;
+
+	float sum = 0;
+	__constant float* coefficient = filter + filterOffset;
+	for( dy = -radiusY; dy <= radiusY; dy++)
+		for( dx = -radiusX; dx <= radiusX; dx++)
+			sum += *coefficient++ * read_imagef(input, stencilSampler, (int2) (x + dx, y + dy)).x;
+	output[(size_t) y * width + x] = sum;
+}
+
+#endif
@@ -0,0 +1,66 @@
+/**
+	Transpose engine (see 1-openClTranspose.h): layout changes of 32-bit elements (ints, uints or floats), reading and
+	writing global memory in consecutive runs only, the reordering being done in __local memory.
+
+	- transposeTiles: rows x columns (row-major) to columns x rows. A work-group of side x ly work-items moves a
+	  side x side tile: it reads the tile row by row, and writes it column by column. The tile is stored with one
+	  padding element per row, so the column reads of the tile hit side different banks.
+	- layoutDeinterleave: count records of components elements (AoS) to components arrays of count elements (SoA).
+	  A work-group reads the records of its work-items in one run, and writes each component as one run.
+	- layoutInterleave: the other way around. The staged records are skewed by one element every LAYOUT_BANKS
+	  elements, so the accesses with a stride of components don't fall into the same banks.
+*/
+
+#define LAYOUT_LOG_BANKS	5
+#define LAYOUT_PAD(i)		((i) + ((i) >> LAYOUT_LOG_BANKS))
+
+__kernel void transposeTiles(__global const uint* input, __global uint* output, int rows, int columns,
+							 __local uint* tile)
+{
+	int side = get_local_size(0);
+	int pitch = side + 1;
+	int tx = get_local_id(0), ty;
+	int row0 = get_group_id(1) * side, column0 = get_group_id(0) * side;
+
+	for( ty = get_local_id(1); ty < side; ty += get_local_size(1))
+		if (row0 + ty < rows && column0 + tx < columns)
+			tile[ty * pitch + tx] = input[(size_t) (row0 + ty) * columns + column0 + tx];
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	// row column0 + ty of the output gets column ty of the tile
+	for( ty = get_local_id(1); ty < side; ty += get_local_size(1))
+		if (column0 + ty < columns && row0 + tx < rows)
+			output[(size_t) (column0 + ty) * rows + row0 + tx] = tile[tx * pitch + ty];
+}
+
+__kernel void layoutDeinterleave(__global const uint* input, __global uint* output, int count, int components,
+								 __local uint* staged)
+{
+	int lid = get_local_id(0);
+	size_t first = (size_t) get_group_id(0) * get_local_size(0);
+	int records = min((int) get_local_size(0), (int) (count - first));
+	int i, c;
+
+	for( i = lid; i < records * components; i += get_local_size(0))
+		staged[LAYOUT_PAD(i)] = input[first * components + i];
+	barrier(CLK_LOCAL_MEM_FENCE);
+	if (lid >= records) return;
+	for( c = 0; c < components; c++)
+		output[(size_t) c * count + first + lid] = staged[LAYOUT_PAD(lid * components + c)];
+}
+
+__kernel void layoutInterleave(__global const uint* input, __global uint* output, int count, int components,
+							   __local uint* staged)
+{
+	int lid = get_local_id(0);
+	size_t first = (size_t) get_group_id(0) * get_local_size(0);
+	int records = min((int) get_local_size(0), (int) (count - first));
+	int i, c;
+
+	if (lid < records)
+		for( c = 0; c < components; c++)
+			staged[LAYOUT_PAD(lid * components + c)] = input[(size_t) c * count + first + lid];
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for( i = lid; i < records * components; i += get_local_size(0))
+		output[first * components + i] = staged[LAYOUT_PAD(i)];
+}
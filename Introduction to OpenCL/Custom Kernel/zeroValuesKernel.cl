@@ -1,3 +1,8 @@
+// operand added to every element (the driver may define it, see 1-openClSpecialization.h)
+#ifndef ZV_OPERAND
+#define ZV_OPERAND 10
+#endif
+
 /**
 	Testing Kernel. Adds 10 to each element of a given array
 */
@@ -11,7 +16,49 @@ __kernel void zeroValues(__global int* values, __global int* ret, int imax)
 	int i; 
 	for( i = idx; i < imax; i += idtotal) 
 	{
-		ret[i] = values[i] + 10 ;
+		ret[i] = values[i] + ZV_OPERAND ;
 	}
 
-}
\ No newline at end of file
+}
+
+/**
+	Vectorized variants of zeroValues (zeroValues4, zeroValues8 and zeroValues16). Each work-item loads and stores
+	N consecutive elements per iteration with vloadN/vstoreN, in a grid-stride loop over vectors, and the last
+	imax % N elements are done by the scalar tail. The driver picks the variant from the device's preferred and
+	native int vector widths.
+*/
+#define ZERO_VALUES_VECTOR(N)																\
+__kernel void zeroValues##N(__global const int* values, __global int* ret, int imax)		\
+{																							\
+	int idx = get_global_id(0);																\
+	int idtotal = get_global_size(0);														\
+	int vectors = imax / N;																	\
+	int i;																					\
+	for( i = idx; i < vectors; i += idtotal)												\
+		vstore##N(vload##N(i, values) + ZV_OPERAND, i, ret);								\
+	for( i = vectors * N + idx; i < imax; i += idtotal)										\
+		ret[i] = values[i] + ZV_OPERAND;													\
+}
+
+ZERO_VALUES_VECTOR(4)
+ZERO_VALUES_VECTOR(8)
+ZERO_VALUES_VECTOR(16)
+
+/**
+	Specialized zeroValues, only compiled when the driver builds the program with -DZV_SPECIALIZED (see
+	1-openClSpecialization.h). The number of elements (ZV_IMAX), the stride of the loop (ZV_STRIDE, the global size),
+	the work-group size (ZV_LOCAL), the operand (ZV_OPERAND) and the element type (ZV_TYPE) are compile-time
+	constants, so the trip count of every work-item is known and the compiler can unroll the loop.
+*/
+#ifdef ZV_SPECIALIZED
+#ifdef cl_khr_fp64
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+__kernel __attribute__((reqd_work_group_size(ZV_LOCAL, 1, 1)))
+void zeroValuesSpecialized(__global const ZV_TYPE* values, __global ZV_TYPE* ret)
+{
+	size_t i;
+	for( i = get_global_id(0); i < ZV_IMAX; i += ZV_STRIDE)
+		ret[i] = values[i] + ZV_OPERAND;
+}
+#endif
@@ -2,7 +2,11 @@
  * clInfo.cpp --
  *
  *      Program to enumerate and dump all of the OpenCL information for a
- *      machine (or at least for a specific run-time).
+ *      machine (or at least for a specific run-time), as text or, with
+ *      --json, as JSON (the device capability snapshot format of the
+ *      driver: clInfo --json > "Custom Kernel/.clcache/deviceCapabilities.json").
+ *      With --timing, it measures the actual bandwidth, latency and peak
+ *      throughput of each device instead, with a roofline summary.
  *    
  *      http://graphics.stanford.edu/~yoel/notes/clInfo.c
  *
@@ -13,6 +17,8 @@
 #include <stdio.h>
 #include <getopt.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
 
 #include "CL/cl.h"
 
@@ -25,6 +31,7 @@ typedef struct Opts {
 
    int verify;
    int timing;
+   int json;
 } Opts;
 
 
@@ -42,6 +49,12 @@ Usage(const char *progName) {
    Warning("Usage: %s [options]\n", progName);
    Warning("Options:\n");
    Warning("  -h, --help                This message\n");
+   Warning("  -j, --json                Dump every property as JSON (the device\n");
+   Warning("                            capability snapshot format of the driver)\n");
+   Warning("  -t, --timing              Measure each device: transfer and copy\n");
+   Warning("                            bandwidth, launch latency, peak throughput\n");
+   Warning("                            and the roofline ridge points\n");
+   Warning("  -v, --verify              With --timing, check the copied data\n");
 
    exit(1);
 }
@@ -63,12 +76,25 @@ ParseOpts(Opts *opts, int argc, char *argv[]) {
 
    static struct option longOptions[] = {
       {"help",         0, 0, 'h'},
+      {"json",         0, 0, 'j'},
+      {"timing",       0, 0, 't'},
+      {"verify",       0, 0, 'v'},
+      {0, 0, 0, 0},
    };
 
 
-   while ((opt = getopt_long(argc, argv, "h",
+   while ((opt = getopt_long(argc, argv, "hjtv",
                              longOptions, NULL)) != EOF) {
       switch(opt) {
+      case 'j':
+         opts->json = 1;
+         break;
+      case 't':
+         opts->timing = 1;
+         break;
+      case 'v':
+         opts->verify = 1;
+         break;
       case 'h':
       default:
          Usage(argv[0]);
@@ -125,16 +151,10 @@ CLErrString(cl_int status) {
 
 
 /*
- * PrintDevice --
- *
- *      Dumps everything about the given device ID.
- *
- * Results:
- *      void.
+ * Device property tables, shared by the text dump (PrintDevice) and the
+ * JSON dump (JsonDevice).
  */
 
-static void
-PrintDevice(cl_device_id device) {
 #define LONG_PROPS \
   defn(VENDOR_ID), \
   defn(MAX_COMPUTE_UNITS), \
@@ -146,6 +166,14 @@ PrintDevice(cl_device_id device) {
   defn(PREFERRED_VECTOR_WIDTH_LONG), \
   defn(PREFERRED_VECTOR_WIDTH_FLOAT), \
   defn(PREFERRED_VECTOR_WIDTH_DOUBLE), \
+  defn(PREFERRED_VECTOR_WIDTH_HALF), \
+  defn(NATIVE_VECTOR_WIDTH_CHAR), \
+  defn(NATIVE_VECTOR_WIDTH_SHORT), \
+  defn(NATIVE_VECTOR_WIDTH_INT), \
+  defn(NATIVE_VECTOR_WIDTH_LONG), \
+  defn(NATIVE_VECTOR_WIDTH_FLOAT), \
+  defn(NATIVE_VECTOR_WIDTH_DOUBLE), \
+  defn(NATIVE_VECTOR_WIDTH_HALF), \
   defn(MAX_CLOCK_FREQUENCY), \
   defn(ADDRESS_BITS), \
   defn(MAX_MEM_ALLOC_SIZE), \
@@ -157,6 +185,8 @@ PrintDevice(cl_device_id device) {
   defn(IMAGE3D_MAX_WIDTH), \
   defn(IMAGE3D_MAX_HEIGHT), \
   defn(IMAGE3D_MAX_DEPTH), \
+  defn(IMAGE_MAX_BUFFER_SIZE), \
+  defn(IMAGE_MAX_ARRAY_SIZE), \
   defn(MAX_SAMPLERS), \
   defn(MAX_PARAMETER_SIZE), \
   defn(MEM_BASE_ADDR_ALIGN), \
@@ -168,10 +198,15 @@ PrintDevice(cl_device_id device) {
   defn(MAX_CONSTANT_ARGS), \
   defn(LOCAL_MEM_SIZE), \
   defn(ERROR_CORRECTION_SUPPORT), \
+  defn(HOST_UNIFIED_MEMORY), \
   defn(PROFILING_TIMER_RESOLUTION), \
   defn(ENDIAN_LITTLE), \
   defn(AVAILABLE), \
-  defn(COMPILER_AVAILABLE),
+  defn(COMPILER_AVAILABLE), \
+  defn(LINKER_AVAILABLE), \
+  defn(PARTITION_MAX_SUB_DEVICES), \
+  defn(PRINTF_BUFFER_SIZE), \
+  defn(PREFERRED_INTEROP_USER_SYNC),
 
 #define STR_PROPS \
   defn(NAME), \
@@ -181,36 +216,52 @@ PrintDevice(cl_device_id device) {
 
 #define HEX_PROPS \
    defn(SINGLE_FP_CONFIG), \
+   defn(DOUBLE_FP_CONFIG), \
    defn(QUEUE_PROPERTIES),
 
+/*
+ * Properties with their own format (TYPE, EXECUTION_CAPABILITIES, the
+ * memory types) and the lists (MAX_WORK_ITEM_SIZES, EXTENSIONS) are
+ * queried one by one.
+ */
 
-/* XXX For completeness, it'd be nice to dump this one, too. */
-#define WEIRD_PROPS \
-   CL_DEVICE_MAX_WORK_ITEM_SIZES,
-
-   static struct { cl_device_info param; const char *name; } longProps[] = {
+static struct { cl_device_info param; const char *name; } longProps[] = {
 #define defn(X) { CL_DEVICE_##X, #X }
-      LONG_PROPS
+   LONG_PROPS
 #undef defn
-      { 0, NULL },
-   };
-   static struct { cl_device_info param; const char *name; } hexProps[] = {
+   { 0, NULL },
+};
+static struct { cl_device_info param; const char *name; } hexProps[] = {
 #define defn(X) { CL_DEVICE_##X, #X }
-      HEX_PROPS
+   HEX_PROPS
 #undef defn
-      { 0, NULL },
-   };
-   static struct { cl_device_info param; const char *name; } strProps[] = {
+   { 0, NULL },
+};
+static struct { cl_device_info param; const char *name; } strProps[] = {
 #define defn(X) { CL_DEVICE_##X, #X }
-      STR_PROPS
+   STR_PROPS
 #undef defn
-      { CL_DRIVER_VERSION, "DRIVER_VERSION" },
-      { 0, NULL },
-   };
+   { CL_DRIVER_VERSION, "DRIVER_VERSION" },
+   { 0, NULL },
+};
+
+
+/*
+ * PrintDevice --
+ *
+ *      Dumps everything about the given device ID.
+ *
+ * Results:
+ *      void.
+ */
+
+static void
+PrintDevice(cl_device_id device) {
    cl_int status;
    size_t size;
    char buf[65536];
    long long val; /* Avoids unpleasant surprises for some params */
+   size_t sizes[16];
    int ii;
 
 
@@ -279,6 +330,7 @@ PrintDevice(cl_device_id device) {
               device, CLErrString(status));
    }
 
+   val = 0;
    status = clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_CACHE_TYPE,
                             sizeof val, &val, NULL);
    if (status == CL_SUCCESS) {
@@ -291,6 +343,7 @@ PrintDevice(cl_device_id device) {
       Warning("\tdevice[%p]: Unable to get GLOBAL_MEM_CACHE_TYPE: %s!\n",
               device, CLErrString(status));
    }
+   val = 0;
    status = clGetDeviceInfo(device,
                             CL_DEVICE_LOCAL_MEM_TYPE, sizeof val, &val, NULL);
    if (status == CL_SUCCESS) {
@@ -321,6 +374,7 @@ PrintDevice(cl_device_id device) {
    printf("\n");
 
    for (ii = 0; longProps[ii].name != NULL; ii++) {
+      val = 0;
       status = clGetDeviceInfo(device, longProps[ii].param, sizeof val, &val, &size);
       if (status != CL_SUCCESS) {
          Warning("\tdevice[%p]: Unable to get %s: %s!\n",
@@ -334,6 +388,201 @@ PrintDevice(cl_device_id device) {
       printf("\tdevice[%p]: %s: %lld\n",
              device, longProps[ii].name, val);
    }
+
+   status = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES,
+                            sizeof sizes, sizes, &size);
+   if (status == CL_SUCCESS) {
+      printf("\tdevice[%p]: MAX_WORK_ITEM_SIZES:", device);
+      for (ii = 0; ii < (int) (size / sizeof sizes[0]); ii++) {
+         printf(" %lu", (unsigned long) sizes[ii]);
+      }
+      printf("\n");
+   } else {
+      Warning("\tdevice[%p]: Unable to get MAX_WORK_ITEM_SIZES: %s!\n",
+              device, CLErrString(status));
+   }
+
+   status = clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, sizeof buf, buf, NULL);
+   if (status == CL_SUCCESS) {
+      printf("\tdevice[%p]: EXTENSIONS: %s\n", device, buf);
+   } else {
+      Warning("\tdevice[%p]: Unable to get EXTENSIONS: %s!\n",
+              device, CLErrString(status));
+   }
+}
+
+
+/*
+ * JsonString --
+ *
+ *      Prints a string as a JSON string (quoted, with the quotes,
+ *      backslashes and control characters escaped).
+ *
+ * Results:
+ *      void.
+ */
+
+static void
+JsonString(const char *text) {
+   putchar('"');
+   for (; *text != '\0'; text++) {
+      unsigned char c = (unsigned char) *text;
+      if (c == '"' || c == '\\') {
+         printf("\\%c", c);
+      } else if (c < 0x20) {
+         printf("\\u%04x", c);
+      } else {
+         putchar(c);
+      }
+   }
+   putchar('"');
+}
+
+
+/*
+ * JsonList --
+ *
+ *      Prints a space separated list (the extensions) as a JSON array of
+ *      strings.
+ *
+ * Results:
+ *      void.
+ */
+
+static void
+JsonList(char *list) {
+   char *word;
+   int first = 1;
+
+   putchar('[');
+   for (word = strtok(list, " "); word != NULL; word = strtok(NULL, " ")) {
+      printf(first ? "" : ", ");
+      JsonString(word);
+      first = 0;
+   }
+   putchar(']');
+}
+
+
+/*
+ * JsonKey --
+ *
+ *      Starts a member of a JSON object, after the separator of the
+ *      previous member (*first is cleared by the first one).
+ *
+ * Results:
+ *      void.
+ */
+
+static void
+JsonKey(int *first, const char *indent, const char *name) {
+   printf("%s\n%s\"%s\": ", *first ? "" : ",", indent, name);
+   *first = 0;
+}
+
+
+/*
+ * JsonDevice --
+ *
+ *      Dumps everything about the given device ID as a JSON object, with
+ *      the property names of PrintDevice. Properties the run-time doesn't
+ *      know are left out (with a warning on stderr, stdout stays valid
+ *      JSON). The driver reads this format as its device capability
+ *      snapshot (Custom Kernel/1-openClCapabilities.h).
+ *
+ * Results:
+ *      void.
+ */
+
+static void
+JsonDevice(cl_device_id device) {
+   static struct { cl_device_info param; const char *name; } enumProps[] = {
+      { CL_DEVICE_TYPE, "TYPE" },
+      { CL_DEVICE_EXECUTION_CAPABILITIES, "EXECUTION_CAPABILITIES" },
+      { CL_DEVICE_GLOBAL_MEM_CACHE_TYPE, "GLOBAL_MEM_CACHE_TYPE" },
+      { CL_DEVICE_LOCAL_MEM_TYPE, "LOCAL_MEM_TYPE" },
+      { 0, NULL },
+   };
+   const char *indent = "          ";
+   cl_int status;
+   size_t size;
+   char buf[65536];
+   long long val;
+   size_t sizes[16];
+   int first = 1;
+   int ii;
+
+   printf("        {");
+   for (ii = 0; strProps[ii].name != NULL; ii++) {
+      status = clGetDeviceInfo(device, strProps[ii].param, sizeof buf, buf, &size);
+      if (status != CL_SUCCESS) {
+         Warning("\tdevice[%p]: Unable to get %s: %s!\n",
+                 device, strProps[ii].name, CLErrString(status));
+         continue;
+      }
+      JsonKey(&first, indent, strProps[ii].name);
+      JsonString(buf);
+   }
+
+   status = clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, sizeof buf, buf, NULL);
+   if (status == CL_SUCCESS) {
+      JsonKey(&first, indent, "EXTENSIONS");
+      JsonList(buf);
+   } else {
+      Warning("\tdevice[%p]: Unable to get EXTENSIONS: %s!\n",
+              device, CLErrString(status));
+   }
+
+   for (ii = 0; enumProps[ii].name != NULL; ii++) {
+      val = 0;
+      status = clGetDeviceInfo(device, enumProps[ii].param, sizeof val, &val, NULL);
+      if (status != CL_SUCCESS) {
+         Warning("\tdevice[%p]: Unable to get %s: %s!\n",
+                 device, enumProps[ii].name, CLErrString(status));
+         continue;
+      }
+      JsonKey(&first, indent, enumProps[ii].name);
+      printf("%lld", val);
+   }
+
+   for (ii = 0; hexProps[ii].name != NULL; ii++) {
+      val = 0;
+      status = clGetDeviceInfo(device, hexProps[ii].param, sizeof val, &val, NULL);
+      if (status != CL_SUCCESS) {
+         Warning("\tdevice[%p]: Unable to get %s: %s!\n",
+                 device, hexProps[ii].name, CLErrString(status));
+         continue;
+      }
+      JsonKey(&first, indent, hexProps[ii].name);
+      printf("%lld", val);
+   }
+
+   for (ii = 0; longProps[ii].name != NULL; ii++) {
+      val = 0;
+      status = clGetDeviceInfo(device, longProps[ii].param, sizeof val, &val, NULL);
+      if (status != CL_SUCCESS) {
+         Warning("\tdevice[%p]: Unable to get %s: %s!\n",
+                 device, longProps[ii].name, CLErrString(status));
+         continue;
+      }
+      JsonKey(&first, indent, longProps[ii].name);
+      printf("%lld", val);
+   }
+
+   status = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES,
+                            sizeof sizes, sizes, &size);
+   if (status == CL_SUCCESS) {
+      JsonKey(&first, indent, "MAX_WORK_ITEM_SIZES");
+      putchar('[');
+      for (ii = 0; ii < (int) (size / sizeof sizes[0]); ii++) {
+         printf("%s%lu", ii > 0 ? ", " : "", (unsigned long) sizes[ii]);
+      }
+      putchar(']');
+   } else {
+      Warning("\tdevice[%p]: Unable to get MAX_WORK_ITEM_SIZES: %s!\n",
+              device, CLErrString(status));
+   }
+   printf("\n        }");
 }
 
 
@@ -402,6 +651,548 @@ static void PrintPlatform(cl_platform_id platform)
 }
 
 
+/*
+ * JsonPlatform --
+ *
+ *      Dumps everything about the given platform ID, and its devices, as a
+ *      JSON object.
+ *
+ * Results:
+ *      void.
+ */
+
+static void
+JsonPlatform(cl_platform_id platform) {
+   static struct { cl_platform_info param; const char *name; } props[] = {
+                            { CL_PLATFORM_PROFILE, "PROFILE" },
+                            { CL_PLATFORM_VERSION, "VERSION" },
+                            { CL_PLATFORM_NAME, "PLATFORM_NAME" },
+                            { CL_PLATFORM_VENDOR, "PLATFORM_VENDOR" },
+                            { 0, NULL }};
+   const char *indent = "      ";
+   cl_device_id *deviceList;
+   cl_uint numDevices = 0;
+   cl_int status;
+   char buf[65536];
+   int first = 1;
+   int ii;
+
+   printf("    {");
+   for (ii = 0; props[ii].name != NULL; ii++) {
+      status = clGetPlatformInfo(platform, props[ii].param, sizeof buf, buf, NULL);
+      if (status != CL_SUCCESS) {
+         Warning("platform[%p]: Unable to get %s: %s\n",
+                 platform, props[ii].name, CLErrString(status));
+         continue;
+      }
+      JsonKey(&first, indent, props[ii].name);
+      JsonString(buf);
+   }
+   status = clGetPlatformInfo(platform, CL_PLATFORM_EXTENSIONS, sizeof buf, buf, NULL);
+   if (status == CL_SUCCESS) {
+      JsonKey(&first, indent, "EXTENSIONS");
+      JsonList(buf);
+   }
+
+   JsonKey(&first, indent, "devices");
+   printf("[");
+   if ((status = clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL,
+                                0, NULL, &numDevices)) != CL_SUCCESS) {
+      Warning("platform[%p]: Unable to query the number of devices: %s\n",
+              platform, CLErrString(status));
+      numDevices = 0;
+   }
+   deviceList = (cl_device_id *) malloc((numDevices + 1) * sizeof(cl_device_id));
+   if (numDevices > 0 &&
+       (status = clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL,
+                                numDevices, deviceList, NULL)) != CL_SUCCESS) {
+      Warning("platform[%p]: Unable to enumerate the devices: %s\n",
+              platform, CLErrString(status));
+      numDevices = 0;
+   }
+   for (ii = 0; ii < (int) numDevices; ii++) {
+      printf(ii > 0 ? ",\n" : "\n");
+      JsonDevice(deviceList[ii]);
+   }
+   printf(numDevices > 0 ? "\n      ]\n    }" : "]\n    }");
+   free(deviceList);
+}
+
+
+/*
+ * Micro-benchmarks of --timing. Every measure is the best of TIMING_REPS
+ * runs, after one warm-up run.
+ */
+
+#define TIMING_REPS           5
+#define TIMING_MIN_BYTES      (4 << 10)      /* transfers from 4KB ... */
+#define TIMING_MAX_BYTES      (64 << 20)     /* ... to 64MB, x4 each step */
+#define LAUNCH_COUNT          1000           /* empty kernels timed back to back */
+#define PEAK_ITEMS            (1 << 20)      /* work-items of a peak throughput run */
+#define PEAK_ITERATIONS       256            /* loop trips, 8 chains x 2 ops each */
+#define PEAK_OPS              ((double) PEAK_ITEMS * PEAK_ITERATIONS * 8 * 2)
+
+static const char *timingSource =
+   "__kernel void emptyKernel(__global int *out) { }\n"
+   "\n"
+   "#define PEAK_KERNEL(NAME, TYPE)                                          \\\n"
+   "__kernel void NAME(__global TYPE *out, TYPE m)                           \\\n"
+   "{                                                                        \\\n"
+   "   TYPE a = (TYPE) get_global_id(0), b = a + 1, c = a + 2, d = a + 3;    \\\n"
+   "   TYPE e = a + 4, f = a + 5, g = a + 6, h = a + 7;                      \\\n"
+   "   for (int i = 0; i < PEAK_ITERATIONS; i++)                             \\\n"
+   "   {                                                                     \\\n"
+   "      a = a * m + m; b = b * m + m; c = c * m + m; d = d * m + m;        \\\n"
+   "      e = e * m + m; f = f * m + m; g = g * m + m; h = h * m + m;        \\\n"
+   "   }                                                                     \\\n"
+   "   out[get_global_id(0)] = a + b + c + d + e + f + g + h;                \\\n"
+   "}\n"
+   "\n"
+   "PEAK_KERNEL(peakInt, int)\n"
+   "PEAK_KERNEL(peakFloat, float)\n"
+   "#ifdef WITH_FP64\n"
+   "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n"
+   "PEAK_KERNEL(peakDouble, double)\n"
+   "#endif\n";
+
+
+/*
+ * NowMs --
+ *
+ *      Wall clock, in milliseconds.
+ *
+ * Results:
+ *      double, milliseconds since the epoch.
+ */
+
+static double
+NowMs(void) {
+   struct timeval now;
+
+   gettimeofday(&now, NULL);
+   return now.tv_sec * 1e3 + now.tv_usec * 1e-3;
+}
+
+
+/*
+ * EventMs --
+ *
+ *      Device side duration of a finished command (START to END), and
+ *      releases its event.
+ *
+ * Results:
+ *      double, milliseconds (-1 if the profiling info is missing).
+ */
+
+static double
+EventMs(cl_event event) {
+   cl_ulong start, end;
+
+   if (clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START,
+                               sizeof start, &start, NULL) != CL_SUCCESS ||
+       clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,
+                               sizeof end, &end, NULL) != CL_SUCCESS) {
+      clReleaseEvent(event);
+      return -1;
+   }
+   clReleaseEvent(event);
+   return (end - start) * 1e-6;
+}
+
+
+/*
+ * TimeTransfer --
+ *
+ *      Times blocking host to device (write) or device to host (read)
+ *      copies between a host pointer and a buffer. The wall clock is used,
+ *      so the staging copy of pageable memory is paid as well.
+ *
+ * Results:
+ *      double, best milliseconds (-1 if a copy fails).
+ */
+
+static double
+TimeTransfer(cl_command_queue queue, cl_mem buffer, void *host,
+             size_t bytes, int write) {
+   double best = -1;
+   int rep;
+
+   for (rep = 0; rep <= TIMING_REPS; rep++) {
+      double start = NowMs();
+      cl_int status = write ?
+         clEnqueueWriteBuffer(queue, buffer, CL_TRUE, 0, bytes, host, 0, NULL, NULL) :
+         clEnqueueReadBuffer(queue, buffer, CL_TRUE, 0, bytes, host, 0, NULL, NULL);
+      double ms = NowMs() - start;
+
+      if (status != CL_SUCCESS) {
+         Warning("\t%s of %lu bytes failed: %s\n", write ? "Write" : "Read",
+                 (unsigned long) bytes, CLErrString(status));
+         return -1;
+      }
+      if (rep > 0 && (best < 0 || ms < best)) {
+         best = ms;
+      }
+   }
+   return best;
+}
+
+
+/*
+ * TimePeak --
+ *
+ *      Runs one of the peak throughput kernels (8 independent multiply-add
+ *      chains per work-item, PEAK_ITERATIONS trips).
+ *
+ * Results:
+ *      double, best operations per second in G (-1 if it can't run).
+ */
+
+static double
+TimePeak(cl_context context, cl_command_queue queue, cl_program program,
+         const char *name, size_t elementSize) {
+   cl_kernel kernel;
+   cl_mem out;
+   cl_int status;
+   double best = -1;
+   size_t global = PEAK_ITEMS;
+   int rep;
+   union { cl_int i; cl_float f; cl_double d; } m;
+
+   kernel = clCreateKernel(program, name, &status);
+   if (status != CL_SUCCESS) {
+      Warning("\tUnable to create %s: %s\n", name, CLErrString(status));
+      return -1;
+   }
+   out = clCreateBuffer(context, CL_MEM_WRITE_ONLY, global * elementSize, NULL, &status);
+   if (status != CL_SUCCESS) {
+      Warning("\tUnable to allocate the output of %s: %s\n", name, CLErrString(status));
+      clReleaseKernel(kernel);
+      return -1;
+   }
+   /* a kernel argument, so the compiler can't fold the chains (below 1, they converge) */
+   if (strcmp(name, "peakInt") == 0) {
+      m.i = 3;
+   } else if (strcmp(name, "peakFloat") == 0) {
+      m.f = 0.5f;
+   } else {
+      m.d = 0.5;
+   }
+   clSetKernelArg(kernel, 0, sizeof out, &out);
+   clSetKernelArg(kernel, 1, elementSize, &m);
+
+   for (rep = 0; rep <= TIMING_REPS; rep++) {
+      cl_event event;
+      double ms;
+
+      status = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, NULL, 0, NULL, &event);
+      if (status != CL_SUCCESS) {
+         Warning("\tUnable to run %s: %s\n", name, CLErrString(status));
+         break;
+      }
+      clWaitForEvents(1, &event);
+      ms = EventMs(event);
+      if (rep > 0 && ms > 0 && (best < 0 || PEAK_OPS / (ms * 1e6) > best)) {
+         best = PEAK_OPS / (ms * 1e6);
+      }
+   }
+   clReleaseMemObject(out);
+   clReleaseKernel(kernel);
+   return best;
+}
+
+
+/*
+ * VerifyBuffer --
+ *
+ *      Compares a host copy of a buffer with the pattern it was filled
+ *      with (--verify).
+ *
+ * Results:
+ *      int, the number of mismatching bytes.
+ */
+
+static int
+VerifyBuffer(const unsigned char *data, size_t bytes) {
+   size_t ii;
+   int mismatches = 0;
+
+   for (ii = 0; ii < bytes; ii++) {
+      if (data[ii] != (unsigned char) (ii * 7 + 1)) {
+         mismatches++;
+      }
+   }
+   return mismatches;
+}
+
+
+/*
+ * TimeDevice --
+ *
+ *      Measures the actual performance of a device: host to device and
+ *      device to host bandwidth, from pageable and pinned (CL_MEM_ALLOC_HOST_PTR,
+ *      mapped) memory, across transfer sizes; device to device copy
+ *      bandwidth; kernel launch latency; peak int, float and double
+ *      throughput. It ends with a roofline profile: the ridge point (ops
+ *      per byte) below which a kernel is bound by the memory bandwidth.
+ *
+ * Results:
+ *      void.
+ */
+
+static void
+TimeDevice(cl_platform_id platform, cl_device_id device, const Opts *opts) {
+   cl_context_properties props[] = { CL_CONTEXT_PLATFORM, (cl_context_properties) platform, 0 };
+   cl_context context;
+   cl_command_queue queue;
+   cl_program program;
+   cl_mem deviceA = NULL, deviceB = NULL, pinned = NULL;
+   unsigned char *pageable = NULL, *pinnedHost = NULL;
+   cl_ulong maxAlloc = 0;
+   cl_int status;
+   char buf[65536];
+   size_t bytes, maxBytes, ii;
+   double copyGBs = -1, writeGBs = -1, readGBs = -1, intGops, floatGops, doubleGops = -1;
+   double zeroValuesGBs;
+   int fp64;
+
+   clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof buf, buf, NULL);
+   printf("device[%p]: %s\n", device, buf);
+   clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, sizeof buf, buf, NULL);
+   fp64 = strstr(buf, "cl_khr_fp64") != NULL;
+   clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof maxAlloc, &maxAlloc, NULL);
+   maxBytes = TIMING_MAX_BYTES;
+   while (maxBytes > TIMING_MIN_BYTES && maxBytes > maxAlloc / 4) {
+      maxBytes /= 4;
+   }
+
+   context = clCreateContext(props, 1, &device, NULL, NULL, &status);
+   if (status != CL_SUCCESS) {
+      Warning("\tUnable to create a context: %s\n", CLErrString(status));
+      return;
+   }
+   queue = clCreateCommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE, &status);
+   if (status != CL_SUCCESS) {
+      Warning("\tUnable to create a queue: %s\n", CLErrString(status));
+      clReleaseContext(context);
+      return;
+   }
+
+   /* buffers of the biggest size, used by every transfer size */
+   deviceA = clCreateBuffer(context, CL_MEM_READ_WRITE, maxBytes, NULL, &status);
+   if (status == CL_SUCCESS) {
+      deviceB = clCreateBuffer(context, CL_MEM_READ_WRITE, maxBytes, NULL, &status);
+   }
+   if (status == CL_SUCCESS) {
+      pinned = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, maxBytes, NULL, &status);
+   }
+   if (status == CL_SUCCESS) {
+      pinnedHost = (unsigned char *) clEnqueueMapBuffer(queue, pinned, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE,
+                                                        0, maxBytes, 0, NULL, NULL, &status);
+   }
+   pageable = (unsigned char *) malloc(maxBytes);
+   if (status != CL_SUCCESS || pageable == NULL) {
+      Warning("\tUnable to allocate the %lu byte buffers: %s\n",
+              (unsigned long) maxBytes, CLErrString(status));
+      goto release;
+   }
+   for (ii = 0; ii < maxBytes; ii++) {
+      pageable[ii] = pinnedHost[ii] = (unsigned char) (ii * 7 + 1);
+   }
+
+   printf("\t%-10s %14s %14s %14s %14s\n", "bytes", "H2D pageable", "H2D pinned",
+          "D2H pageable", "D2H pinned");
+   for (bytes = TIMING_MIN_BYTES; bytes <= maxBytes; bytes *= 4) {
+      double ms[4];
+
+      ms[0] = TimeTransfer(queue, deviceA, pageable, bytes, 1);
+      ms[1] = TimeTransfer(queue, deviceA, pinnedHost, bytes, 1);
+      ms[2] = TimeTransfer(queue, deviceA, pageable, bytes, 0);
+      ms[3] = TimeTransfer(queue, deviceA, pinnedHost, bytes, 0);
+      printf("\t%-10lu", (unsigned long) bytes);
+      for (ii = 0; ii < 4; ii++) {
+         if (ms[ii] > 0) {
+            printf(" %9.2f GB/s", bytes / (ms[ii] * 1e6));
+         } else {
+            printf(" %14s", "-");
+         }
+      }
+      printf("\n");
+      if (bytes == maxBytes) {
+         writeGBs = ms[1] > 0 ? bytes / (ms[1] * 1e6) : -1;
+         readGBs = ms[3] > 0 ? bytes / (ms[3] * 1e6) : -1;
+      }
+   }
+
+   /* device to device: every byte is read and written once */
+   status = clEnqueueWriteBuffer(queue, deviceA, CL_TRUE, 0, maxBytes, pageable, 0, NULL, NULL);
+   for (ii = 0; status == CL_SUCCESS && ii <= TIMING_REPS; ii++) {
+      cl_event event;
+      double ms;
+
+      status = clEnqueueCopyBuffer(queue, deviceA, deviceB, 0, 0, maxBytes, 0, NULL, &event);
+      if (status != CL_SUCCESS) {
+         break;
+      }
+      clWaitForEvents(1, &event);
+      ms = EventMs(event);
+      if (ii > 0 && ms > 0 && 2.0 * maxBytes / (ms * 1e6) > copyGBs) {
+         copyGBs = 2.0 * maxBytes / (ms * 1e6);
+      }
+   }
+   if (status != CL_SUCCESS) {
+      Warning("\tDevice to device copy failed: %s\n", CLErrString(status));
+   } else {
+      printf("\tD2D copy (%lu bytes): %.2f GB/s (read + write)\n", (unsigned long) maxBytes, copyGBs);
+   }
+
+   if (opts->verify) {
+      int mismatches;
+
+      memset(pageable, 0, maxBytes);
+      clEnqueueReadBuffer(queue, deviceB, CL_TRUE, 0, maxBytes, pageable, 0, NULL, NULL);
+      mismatches = VerifyBuffer(pageable, maxBytes);
+      printf("\tVerify: %s (%d mismatching bytes after H2D, D2D and D2H)\n",
+             mismatches == 0 ? "passed" : "FAILED", mismatches);
+   }
+
+   /* kernels: launch latency, then the peak throughputs */
+   program = clCreateProgramWithSource(context, 1, &timingSource, NULL, &status);
+   if (status == CL_SUCCESS) {
+      char options[64];
+
+      snprintf(options, sizeof options, "-DPEAK_ITERATIONS=%d%s", PEAK_ITERATIONS,
+               fp64 ? " -DWITH_FP64" : "");
+      status = clBuildProgram(program, 1, &device, options, NULL, NULL);
+      if (status != CL_SUCCESS) {
+         clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof buf, buf, NULL);
+         Warning("\tUnable to build the benchmark kernels: %s\n%s\n", CLErrString(status), buf);
+         clReleaseProgram(program);
+      }
+   }
+   if (status != CL_SUCCESS) {
+      goto release;
+   }
+
+   {
+      cl_kernel empty = clCreateKernel(program, "emptyKernel", &status);
+      size_t one = 1;
+      double start, wallUs, bestUs = -1;
+      cl_event event;
+
+      clSetKernelArg(empty, 0, sizeof deviceA, &deviceA);
+      clEnqueueNDRangeKernel(queue, empty, 1, NULL, &one, NULL, 0, NULL, NULL);
+      clFinish(queue);
+      start = NowMs();
+      for (ii = 0; ii < LAUNCH_COUNT; ii++) {
+         clEnqueueNDRangeKernel(queue, empty, 1, NULL, &one, NULL, 0, NULL, NULL);
+      }
+      clFinish(queue);
+      wallUs = (NowMs() - start) * 1e3 / LAUNCH_COUNT;
+      for (ii = 0; ii < TIMING_REPS; ii++) {
+         cl_ulong queued, end;
+
+         start = NowMs();
+         clEnqueueNDRangeKernel(queue, empty, 1, NULL, &one, NULL, 0, NULL, &event);
+         clWaitForEvents(1, &event);
+         clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_QUEUED, sizeof queued, &queued, NULL);
+         clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof end, &end, NULL);
+         clReleaseEvent(event);
+         if (bestUs < 0 || (end - queued) * 1e-3 < bestUs) {
+            bestUs = (end - queued) * 1e-3;
+         }
+      }
+      printf("\tLaunch latency: %.2f us (one kernel, queued to end), %.2f us per kernel back to back\n",
+             bestUs, wallUs);
+      clReleaseKernel(empty);
+   }
+
+   intGops = TimePeak(context, queue, program, "peakInt", sizeof(cl_int));
+   floatGops = TimePeak(context, queue, program, "peakFloat", sizeof(cl_float));
+   if (fp64) {
+      doubleGops = TimePeak(context, queue, program, "peakDouble", sizeof(cl_double));
+   }
+   printf("\tPeak: %.1f Gop/s int, %.1f GFLOP/s float", intGops, floatGops);
+   if (fp64) {
+      printf(", %.1f GFLOP/s double\n", doubleGops);
+   } else {
+      printf(", no double (cl_khr_fp64 missing)\n");
+   }
+   clReleaseProgram(program);
+
+   /*
+    * Roofline: a kernel doing I ops per byte of global memory runs at
+    * min(peak, I * bandwidth). Below the ridge point I = peak / bandwidth,
+    * the memory is the limit. zeroValues does 1 int op per 8 bytes (one
+    * read, one write), so its ceiling is the bandwidth itself.
+    */
+   if (copyGBs > 0) {
+      printf("\tRoofline (bandwidth %.2f GB/s):\n", copyGBs);
+      printf("\t\tint    ridge point %.2f op/byte\n", intGops / copyGBs);
+      printf("\t\tfloat  ridge point %.2f FLOP/byte\n", floatGops / copyGBs);
+      if (fp64 && doubleGops > 0) {
+         printf("\t\tdouble ridge point %.2f FLOP/byte\n", doubleGops / copyGBs);
+      }
+      zeroValuesGBs = 0.125 < intGops / copyGBs ? copyGBs : intGops * 8;
+      printf("\t\tzeroValues (0.125 op/byte): %s-bound, at most %.2f GB/s on the device (%.2f G elements/s)",
+             0.125 < intGops / copyGBs ? "bandwidth" : "compute", zeroValuesGBs, zeroValuesGBs / 8);
+      if (writeGBs > 0 && readGBs > 0) {
+         printf(", %.2f GB/s with the copies", 1.0 / (0.5 / writeGBs + 0.5 / readGBs));
+      }
+      printf("\n");
+   }
+
+release:
+   if (pinnedHost != NULL) {
+      clEnqueueUnmapMemObject(queue, pinned, pinnedHost, 0, NULL, NULL);
+      clFinish(queue);
+   }
+   if (pinned != NULL) clReleaseMemObject(pinned);
+   if (deviceB != NULL) clReleaseMemObject(deviceB);
+   if (deviceA != NULL) clReleaseMemObject(deviceA);
+   free(pageable);
+   clReleaseCommandQueue(queue);
+   clReleaseContext(context);
+}
+
+
+/*
+ * TimePlatform --
+ *
+ *      Runs the --timing micro-benchmarks on every device of a platform.
+ *
+ * Results:
+ *      void.
+ */
+
+static void
+TimePlatform(cl_platform_id platform, const Opts *opts) {
+   cl_device_id *deviceList;
+   cl_uint numDevices;
+   cl_int status;
+   int ii;
+
+   if ((status = clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL,
+                                0, NULL, &numDevices)) != CL_SUCCESS) {
+      Warning("platform[%p]: Unable to query the number of devices: %s\n",
+              platform, CLErrString(status));
+      return;
+   }
+   deviceList = (cl_device_id *) malloc(numDevices * sizeof(cl_device_id));
+   if ((status = clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL,
+                                numDevices, deviceList, NULL)) != CL_SUCCESS) {
+      Warning("platform[%p]: Unable to enumerate the devices: %s\n",
+              platform, CLErrString(status));
+      free(deviceList);
+      return;
+   }
+   for (ii = 0; ii < (int) numDevices; ii++) {
+      TimeDevice(platform, deviceList[ii], opts);
+      printf("\n");
+   }
+   free(deviceList);
+}
+
+
 int
 main(int argc, char * argv[])
 {
@@ -419,7 +1210,9 @@ main(int argc, char * argv[])
                CLErrString(status));
        exit(1);
     }
-    printf("Found %d platform(s).\n", numPlatforms);
+    if (!opts.json) {
+       printf("Found %d platform(s).\n", numPlatforms);
+    }
 
     platformList = (cl_platform_id*) malloc(sizeof(cl_platform_id) * numPlatforms);
     if ((status = clGetPlatformIDs(numPlatforms, platformList, NULL)) != CL_SUCCESS) {
@@ -428,8 +1221,21 @@ main(int argc, char * argv[])
        exit(1);
     }
 
-    for (ii = 0; ii < (int) numPlatforms; ii++) {
-       PrintPlatform(platformList[ii]);
+    if (opts.timing) {
+       for (ii = 0; ii < (int) numPlatforms; ii++) {
+          TimePlatform(platformList[ii], &opts);
+       }
+    } else if (opts.json) {
+       printf("{\n  \"platforms\": [\n");
+       for (ii = 0; ii < (int) numPlatforms; ii++) {
+          JsonPlatform(platformList[ii]);
+          printf(ii + 1 < (int) numPlatforms ? ",\n" : "\n");
+       }
+       printf("  ]\n}\n");
+    } else {
+       for (ii = 0; ii < (int) numPlatforms; ii++) {
+          PrintPlatform(platformList[ii]);
+       }
     }
 
     free(platformList);